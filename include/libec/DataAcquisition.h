@@ -2,8 +2,17 @@
 #define DATAACQUISITION_H_
 
 #include <list>
+#include <vector>
+#include <pthread.h>
 #include <libec/logs.h>
 #include <libec/sensors.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/sensor/SensorScheduler.h>
+#include <libec/sensor/SensorUpdater.h>
+#include <libec/tools/containers/SampleRing.h>
+
+/// Rows of samples waiting to be written
+#define DAQ_RING_SIZE 1024
 
 namespace cea
 {
@@ -37,6 +46,20 @@ namespace cea
 
     /// Collects the data into the log file while running the specified
     /// benchmark. The log is appended to the file defined on the constructor.
+    ///
+    /// When some sensors declare their own period (Sensor::setPeriod()), each
+    /// sensor is sampled at its rate by a SensorScheduler and a row is
+    /// written each time sensors are sampled, dated in seconds with a
+    /// fractional part and holding the last value of the other sensors.
+    ///
+    /// With setUpdateThreads(), the sensors are updated concurrently and a
+    /// row is written on time even if some sensors are late. These keep
+    /// their last value and are counted in a last STALE column.
+    ///
+    /// The samples are handed to a writer thread through a lock-free ring,
+    /// so that formatting and flushing the output file do not delay them.
+    /// A full ring makes the sampling wait at most a tenth of a period, then
+    /// the row is dropped; the drops are reported in the summary.
     void
     collectData();
 
@@ -63,12 +86,20 @@ namespace cea
     void
     setIdleTime(unsigned int time);
 
+    /// Updates the sensors concurrently on a pool of threads
+    /// \param threads Number of threads, 0 to update the sensors in turn
+    /// \param budget Time a sensor may take (ms), 0 for half a period
+    void
+    setUpdateThreads(unsigned int threads, unsigned int budget = 0);
+
   private:
     char* _benchCmd; // Benchmark comand line
     time_t _benchStart, _benchEnd;
 
     std::list<Sensor*> _sensors;
-    int _periodTime;
+
+    /// Deadlines of the samples
+    SamplingClock _clock;
 
     std::list<double*> _data;
     int _nofSensors;
@@ -84,13 +115,30 @@ namespace cea
     // Time to collect data before and after benchmark's execution
     int _idleTime;
 
+    /// Threads updating the sensors, 0 for none
+    unsigned int _updateThreads;
+    /// Latency budget of the sensors (ms), 0 for half a period
+    unsigned int _updateBudget;
+
+    /// Rows sampled, waiting for the writer thread
+    SampleRing* _ring;
+    pthread_t _writer;
+    bool _hasWriter;
+    volatile bool _isWriting;
+    /// Types of the values of a row
+    std::vector<SensorType> _types;
+    /// Rows dated with a fractional part
+    bool _isFractional;
+    /// Rows ending with the number of stale sensors
+    bool _hasStale;
+
     /// Adds the sensor in a list if its active.
     /// @return true if the sensor was added, false otherwise.
     bool
     addSensor(std::list<Sensor*> *list, Sensor *sensor);
 
     void
-    logHeader(std::list<Sensor*> sensor);
+    logHeader(std::list<Sensor*> sensor, bool stale = false);
 
     void
     printHeader(std::list<Sensor*> sensor);
@@ -101,6 +149,34 @@ namespace cea
     void
     updateSensors(std::list<Sensor*> sensors);
 
+    /// Collects the data of sensors sampled at different rates
+    void
+    collectMultiRate(SensorScheduler &scheduler, u64 first);
+
+    /// Collects the data of sensors updated concurrently
+    void
+    collectParallel(SensorUpdater &updater);
+
+    /// Starts the thread writing the rows of the ring
+    void
+    startWriter(bool fractional, bool stale);
+
+    /// Waits for the writer thread to write the rows left
+    void
+    stopWriter();
+
+    /// Hands a row to the writer thread
+    void
+    pushRow(double time, const std::vector<sensor_t> &values,
+        unsigned int stale);
+
+    /// Writes the rows of the ring
+    void
+    writeRows();
+
+    static void*
+    runWriter(void* data);
+
     static void*
     runBenchmark(void* data);
   };
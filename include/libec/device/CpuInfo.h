@@ -10,6 +10,7 @@
 
 #include <vector>
 #include <map>
+#include <pthread.h>
 #include "../Globals.h"
 #include <cpuid.h>
 
@@ -17,6 +18,10 @@
 #define MAX_LINE_LEN 255
 #define SYSFS_PATH_MAX 255
 
+/// Time (ns) during which the list of online CPUs read is used again: the
+/// sensors updated in a tick share one read
+#define CPUINFO_ONLINE_PERIOD 10000000ull
+
 #define CPUPOWER_CAP_INV_TSC          0x00000001
 #define CPUPOWER_CAP_APERF              0x00000002
 #define CPUPOWER_CAP_AMD_CBP            0x00000004
@@ -83,6 +88,29 @@ namespace cea
     int
     getCpuCores();
 
+    /**
+     * Updates the online state of the processors (CPU hotplug). The list of
+     * online CPUs is read from a file kept open, at most once per
+     * CPUINFO_ONLINE_PERIOD, and the topology of the CPUs brought online is
+     * read. Thread safe: the callers of a same period share the read, and
+     * see its changes through getOnlineSeq().
+     * @return True if the list of online CPUs changed
+     */
+    bool
+    updateOnline();
+
+    /**
+     * Gets the number of changes of the online CPUs seen by updateOnline()
+     */
+    unsigned int
+    getOnlineSeq();
+
+    /**
+     * Checks if a CPU was online at the last updateOnline()
+     */
+    bool
+    isOnline(unsigned int cpu);
+
   private:
     void
     buildMap();
@@ -108,6 +136,12 @@ namespace cea
     int
     getCacheSize(Processor *processor);
 
+    void
+    readTopology(Processor *processor);
+
+    void
+    countTopology();
+
     /// Number of CPUs present on the machine
     unsigned int _cpus;
 
@@ -125,6 +159,21 @@ namespace cea
 //    static std::vector<std::vector<std::vector<unsigned int>>>_vec;
 
     std::vector<Processor*> _processors;
+
+    /// File descriptor of the list of online CPUs
+    int _onlineFd;
+
+    /// Number of changes of the online CPUs
+    unsigned int _onlineSeq;
+
+    /// Time of the last read of the online CPUs (CLOCK_MONOTONIC, ns)
+    u64 _onlineTime;
+
+    /// Online CPUs of the last read, one entry per CPU
+    std::vector<unsigned long int> _online;
+
+    /// Guards the online state of the processors
+    pthread_mutex_t _onlineMutex;
   };
 
 } /* namespace cea */
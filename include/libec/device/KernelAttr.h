@@ -0,0 +1,118 @@
+#ifndef LIBEC_KERNELATTR_H__
+#define LIBEC_KERNELATTR_H__
+
+#include <string>
+#include <sys/types.h>
+
+#include "../Globals.h"
+
+namespace cea
+{
+  /// \brief   Attribute file of sysfs or procfs read at each update.
+  ///
+  /// The file is opened once and read again from its start with pread()
+  /// into a buffer given by the caller, usually on its stack: the kernel
+  /// generates the content again at each read from offset 0. The numbers and
+  /// the "key: value" lines are scanned by hand, so a read allocates
+  /// nothing. A read that fails or gets nothing (attribute removed, file
+  /// replaced) opens the path again and retries once, and a file missing at
+  /// the construction is opened by the first read after it appears.
+  /// \author  Leandro Fontoura Cupertino
+  /// \date    Sep 2013
+  class KernelAttr
+  {
+  public:
+    /// Creates an attribute without path, opened later by open()
+    KernelAttr();
+
+    /// Opens the attribute
+    /// \param path Path of the file
+    KernelAttr(const std::string &path);
+
+    /// The copy reads through a duplicate of the descriptor
+    KernelAttr(const KernelAttr &attr);
+
+    ~KernelAttr();
+
+    KernelAttr&
+    operator=(const KernelAttr &attr);
+
+    /// Opens a file, closing the one open
+    /// \return False if the file could not be opened, it is tried again by
+    /// the next reads
+    bool
+    open(const std::string &path);
+
+    /// Closes the file and forgets its path
+    void
+    close();
+
+    bool
+    isOpen() const;
+
+    const std::string&
+    getPath() const;
+
+    /// Reads the content of the file.
+    /// \param buf Receives the content, ended by a '\\0'
+    /// \param size Size of buf, the content beyond size - 1 bytes is lost
+    /// \return The length of the content, -1 if the file could not be read
+    ssize_t
+    read(char* buf, size_t size);
+
+    /// Reads the first unsigned integer of the file
+    bool
+    readU64(u64 &value);
+
+    /// Reads the first integer of the file, which may be negative
+    bool
+    readS64(long long &value);
+
+    /// Reads the first integers of the file (one line of columns)
+    /// \return The number of integers read
+    unsigned int
+    readU64s(u64* values, unsigned int count);
+
+    /// Reads the value of a key of a "key: value" file (/proc/meminfo,
+    /// /proc/[pid]/status)
+    bool
+    readKey(const char* key, u64 &value);
+
+    /// Reads the values of several keys in a single read
+    /// \return The number of keys found, the values of the others are 0
+    unsigned int
+    readKeys(const char* const * keys, u64* values, unsigned int count);
+
+    /// Scans an unsigned integer, skipping the blanks before it
+    /// \return The first character after the integer
+    static const char*
+    scanU64(const char* p, u64 &value);
+
+    /// Scans the "key: value" lines of a content
+    /// \return The number of keys found, the values of the others are 0
+    static unsigned int
+    parseKeys(const char* buf, const char* const * keys, u64* values,
+        unsigned int count);
+
+    /// Gets the number of files opened since the start of the process
+    static u64
+    getOpenCount();
+
+    /// Gets the number of reads since the start of the process
+    static u64
+    getReadCount();
+
+  private:
+    /// Opens the path again (after a failed read)
+    bool
+    reopen();
+
+    std::string _path;
+    int _fd;
+
+    static u64 _openCount;
+    static u64 _readCount;
+  };
+}
+
+#endif
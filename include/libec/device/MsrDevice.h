@@ -0,0 +1,83 @@
+#ifndef LIBEC_MSRDEVICE_H__
+#define LIBEC_MSRDEVICE_H__
+
+#include <vector>
+#include <string>
+#include <pthread.h>
+
+#include "../Globals.h"
+
+namespace cea
+{
+  /// \brief   Model specific registers of the CPUs (/dev/cpu/N/msr).
+  ///
+  /// The device of each CPU is opened the first time one of its registers
+  /// is read and kept open until close(), so that a sensor reading APERF,
+  /// MPERF and the TSC of every CPU at each update does not open and close
+  /// the devices hundreds of times a second. A register is read with a
+  /// single pread() at its address; read() takes a list of registers and
+  /// reads them one after the other on the open device, so that the values
+  /// of a CPU are as close in time as possible.
+  ///
+  /// A CPU whose device could not be opened (no msr module, not root) is
+  /// not tried again before close(). Needs root access.
+  /// \author  Leandro Fontoura Cupertino
+  /// \date    Sep 2013
+  class MsrDevice
+  {
+  public:
+    /// Reads a register of a CPU.
+    /// \param cpu CPU id
+    /// \param reg Address of the register
+    /// \param value Receives the value of the register
+    /// \return False if the register could not be read
+    static bool
+    read(unsigned int cpu, unsigned int reg, u64 &value);
+
+    /// Reads a list of registers of a CPU in one pass.
+    /// \param cpu CPU id
+    /// \param regs Addresses of the registers
+    /// \param values Receives the values of the registers
+    /// \param count Number of registers
+    /// \return False if a register could not be read
+    static bool
+    read(unsigned int cpu, const unsigned int* regs, u64* values,
+        unsigned int count);
+
+    /// Checks if the registers of a CPU can be read.
+    static bool
+    isAvailable(unsigned int cpu);
+
+    /// Closes the devices of all the CPUs.
+    static void
+    close();
+
+    /// Sets the path of the devices, "%u" being replaced by the CPU id.
+    /// The devices open are closed. The default is "/dev/cpu/%u/msr".
+    static void
+    setPath(const std::string &path);
+
+    /// Gets the number of devices opened since the start of the process.
+    static u64
+    getOpenCount();
+
+    /// Gets the number of registers read since the start of the process.
+    static u64
+    getReadCount();
+
+  private:
+    /// Gets the descriptor of the device of a CPU, opening it if needed.
+    /// \return -1 if the device could not be opened
+    static int
+    getDevice(unsigned int cpu);
+
+    /// Descriptors of the devices by CPU id: -1 not opened yet, -2 failed
+    static std::vector<int> _devices;
+    static std::string _path;
+    static u64 _openCount;
+    static u64 _readCount;
+    static pthread_mutex_t _mutex;
+  };
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef LIBEC_PROCSTAT_H__
+#define LIBEC_PROCSTAT_H__
+
+#include <pthread.h>
+
+#include "../Globals.h"
+
+/// Maximum number of CPUs read from /proc/stat
+#define PROCSTAT_MAX_CPUS 1024
+
+namespace cea
+{
+  /// \brief   CPU times of /proc/stat, shared by the CPU time sensors.
+  ///
+  /// The CPU lines of /proc/stat (the aggregate and one per CPU) are read
+  /// with a single pread() through a KernelAttr, into a static buffer, and
+  /// scanned by hand into fixed arrays of jiffies: nothing is allocated once
+  /// the file is opened. A snapshot younger than the maximum age (one
+  /// jiffy by default, the resolution of the file) is shared, so all the
+  /// sensors updated in the same tick cost one read of the file.
+  /// \author  Leandro Fontoura Cupertino
+  /// \date    Sep 2013
+  class ProcStat
+  {
+  public:
+    /// Columns of a CPU line, in jiffies
+    enum Field
+    {
+      USER = 0,
+      NICE,
+      SYSTEM,
+      IDLE,
+      IOWAIT,
+      IRQ,
+      SOFTIRQ,
+      STEAL,
+      GUEST,
+      GUEST_NICE,
+      FIELDS
+    };
+
+    /// Jiffies of a CPU line, columns missing on old kernels being 0
+    struct Jiffies
+    {
+      u64 field[FIELDS];
+
+      /// Gets the time spent out of the idle and iowait states
+      u64
+      getBusy() const;
+
+      /// Gets the time of all the states but the guest ones, which are
+      /// already accounted in the user ones
+      u64
+      getTotal() const;
+    };
+
+    /// Gets the jiffies of a CPU.
+    /// \param cpu CPU id, -1 for the aggregate of all the CPUs
+    /// \param jiffies Receives the jiffies
+    /// \return False if the file or the CPU could not be read
+    static bool
+    getCpu(int cpu, Jiffies &jiffies);
+
+    /// Gets the number of CPU lines of the file.
+    /// \return The number of CPUs, -1 if the file could not be read
+    static int
+    getCpuCount();
+
+    /// Sets the age (ns) under which a snapshot is shared instead of
+    /// reading the file again, 0 to read it on every request.
+    static void
+    setMaxAge(u64 age);
+
+    /// Gets the number of reads of the file since the start of the process.
+    static u64
+    getReadCount();
+
+    /// Scans the CPU lines of a /proc/stat content.
+    /// \param buf Content, ended by a '\\0'
+    /// \param total Receives the aggregate line
+    /// \param cpus Receives the CPU lines, by CPU id
+    /// \param count Capacity of cpus
+    /// \return The number of CPU lines scanned, -1 if there is no aggregate
+    static int
+    parse(const char* buf, Jiffies &total, Jiffies* cpus, unsigned int count);
+
+  private:
+    /// Reads the file again if the snapshot is too old (mutex held)
+    static bool
+    refresh();
+
+    static Jiffies _total;
+    static Jiffies _cpus[PROCSTAT_MAX_CPUS];
+    static int _cpuCount; ///< -1 if not read
+    static u64 _time; ///< Time of the snapshot (CLOCK_MONOTONIC, ns)
+    static u64 _maxAge;
+    static u64 _readCount;
+    static pthread_mutex_t _mutex;
+  };
+}
+
+#endif
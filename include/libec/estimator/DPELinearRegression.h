@@ -14,6 +14,8 @@
 namespace cea
 {
 
+  class SensorUpdater;
+
   class DPELinearRegression : public cea::DynamicPowerEstimator
   {
   public:
@@ -25,10 +27,29 @@ namespace cea
     calibrate();
 
     /// Collects history data during the a specific time
+    ///
+    /// The inputs are read every estimator latency and kept with their time.
+    /// Each power sample is joined to the inputs interpolated at the time of
+    /// the sample minus the delay of the power meter, so that a training row
+    /// pairs the power with the activity that caused it.
     /// \param secs Time in seconds
     void
     collectData(int secs);
 
+    /// Sets the delay between the activity and its power sample
+    /// \param delay Delay (ms), -1 to use the measured power meter latency
+    void
+    setMeterDelay(long delay);
+
+    /// Updates the input sensors concurrently on a pool of threads
+    ///
+    /// The estimate is computed on time: a sensor late for its budget
+    /// contributes with its last value.
+    /// \param threads Number of threads, 0 to update the sensors in turn
+    /// \param budget Time a sensor may take (ms), 0 for half the latency
+    void
+    setUpdateThreads(unsigned int threads, unsigned int budget = 0);
+
     unsigned
     getLatency();
 
@@ -57,10 +78,18 @@ namespace cea
     void
     copy();
 
+    /// Updates the input sensors on the pool of threads
+    void
+    updateParallel();
+
     LinearRegression _lr;
     double *_weights;
     int _params;
     long pm_latency;
+    long _pmDelay; ///< Delay of the power samples (ms), -1 for pm_latency
+    SensorUpdater *_updater; ///< Pool updating the inputs, NULL for none
+    unsigned int _updateThreads; ///< Threads of the pool, 0 for none
+    unsigned int _updateBudget; ///< Budget of the inputs (ms), 0 for default
   };
 
 } /* namespace cea */
@@ -0,0 +1,135 @@
+#ifndef LIBEC_ENERGY_ACCUMULATOR_H__
+#define LIBEC_ENERGY_ACCUMULATOR_H__
+
+#include <deque>
+#include <map>
+#include <sys/types.h>
+
+#include "../Globals.h"
+#include "../sensor/Sensor.h"
+#include "../sensor/SensorPid.h"
+
+namespace cea
+{
+
+  /**
+   * @brief   Integrates power samples into energy
+   * @author  Leandro Fontoura Cupertino
+   * @date    Sep 10 2013
+   *
+   * Consumes timestamped power samples (W) of a power meter or a power
+   * estimator, for the whole machine and per process, and integrates them
+   * with the trapezoidal rule on the real time elapsed between the samples
+   * (CLOCK_MONOTONIC, ns). The energy since the first sample and the energy
+   * of the last window (e.g. the last minute) are both read in constant
+   * time: the window keeps the cumulated energy at each of its samples, and
+   * its start moves forward as samples are added.
+   *
+   * @code
+   * cea::EnergyAccumulator acc(60000);
+   * while (running)
+   *   {
+   *     acc.updatePid(&estimator, pid);
+   *     usleep(200000);
+   *   }
+   * std::cout << acc.getEnergyPid(pid) << " J" << std::endl;
+   * @endcode
+   */
+  class EnergyAccumulator
+  {
+  public:
+    /// @param window Duration of the window (ms)
+    EnergyAccumulator(unsigned int window = 60000);
+
+    /// Adds a sample of the machine
+    /// @param time Time of the sample (CLOCK_MONOTONIC, ns)
+    /// @param power Power (W)
+    void
+    addSample(u64 time, double power);
+
+    /// Adds a sample of a process
+    /// @param pid Process id
+    /// @param time Time of the sample (CLOCK_MONOTONIC, ns)
+    /// @param power Power (W)
+    void
+    addSamplePid(pid_t pid, u64 time, double power);
+
+    /// Updates a power sensor (meter or estimator) and adds its value for the
+    /// machine. The time of a PowerMeter publishing its samples is the time
+    /// of the device; otherwise it is the time of the update.
+    void
+    update(Sensor* sensor);
+
+    /// Updates a power estimator for a process and adds its value
+    void
+    updatePid(PIDSensor* sensor, pid_t pid);
+
+    /// Gets the energy of the machine since the first sample (J)
+    double
+    getEnergy() const;
+
+    /// Gets the energy of a process since its first sample (J)
+    double
+    getEnergyPid(pid_t pid) const;
+
+    /// Gets the energy of the machine during the last window (J), or since
+    /// the first sample if it is more recent
+    double
+    getWindowEnergy() const;
+
+    /// Gets the energy of a process during the last window (J)
+    double
+    getWindowEnergyPid(pid_t pid) const;
+
+    /// Gets the time elapsed between the first and the last sample of the
+    /// machine (s)
+    double
+    getElapsed() const;
+
+    /// Gets the time elapsed between the first and the last sample of a
+    /// process (s)
+    double
+    getElapsedPid(pid_t pid) const;
+
+    /// Forgets a process
+    void
+    removePid(pid_t pid);
+
+  private:
+    /// Cumulated energy at the time of a sample
+    struct Point
+    {
+      u64 time; ///< Time of the sample (ns)
+      double power; ///< Power of the sample (W)
+      double energy; ///< Energy since the first sample (J)
+    };
+
+    /// Samples of the machine or of a process
+    struct Series
+    {
+      u64 first; ///< Time of the first sample (ns)
+      std::deque<Point> window; ///< Points of the window (oldest first)
+
+      Series();
+    };
+
+    static void
+    add(Series &series, u64 time, double power, u64 window);
+
+    static double
+    getEnergy(const Series &series);
+
+    static double
+    getWindowEnergy(const Series &series, u64 window);
+
+    static double
+    getElapsed(const Series &series);
+
+    u64 _window; ///< Duration of the window (ns)
+    Series _machine; ///< Samples of the machine
+    std::map<pid_t, Series> _pids; ///< Samples of the processes
+  };
+
+}
+
+#endif
@@ -21,6 +21,9 @@
 #include "estimator/PEMinMaxCpu.h"
 #include "estimator/PEMinMaxCpu2.h"
 
+/* Energy */
+#include "estimator/EnergyAccumulator.h"
+
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
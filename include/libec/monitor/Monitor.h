@@ -359,6 +359,7 @@
 #include <map>
 
 #include "../tools/Tools.h"
+#include "../tools/SamplingClock.h"
 #include "../value/Value.h"
 #include "../grid/model/GridModel.h"
 #include "../grid/filter/GridFilter.h"
@@ -476,6 +477,15 @@ namespace cea
     virtual bool
     needUpdate() const;
 
+    /// @brief Get the number of updates missed
+    ///
+    /// The updates follow deadlines spaced by the frequency (see
+    /// SamplingClock). An update called more than a period late skips
+    /// the deadlines passed, and they are counted here.
+    /// @return Number of deadlines missed
+    u64
+    getMissedUpdates() const;
+
     /// @brief Update all the monitor rows follow the frequency
     ///
     /// If frequency = 0 Then Update all rows at each call \n
@@ -1199,7 +1209,7 @@ namespace cea
     /// By default=1000ms
     ///
     cea_time_t _frequency;
-    cea_time_t _lastTick; ///< Last time of update call
+    SamplingClock _clock; ///< Deadlines of the updates
 
     /* Private - Function */
     /// @brief This function is used only to get a ref to Monitor
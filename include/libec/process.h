@@ -11,6 +11,7 @@
 #define LIBCEA_PROCESS_H__
 
 #include "process/BaseProcessEnumerator.h"
+#include "process/PidStateSlab.h"
 
 /* If the target OS is Windows then use WindowsProcessEnumerator */
 #ifdef _WIN32
@@ -22,11 +23,13 @@
 /* If the target OS is Linux then use LinuxProcessEnumerator */
 #ifdef __unix__
 #include "process/linux/LinuxProcessEnumerator.h"
+#include "process/linux/ProcConnectorEnumerator.h"
 /// @brief If Unix platform use LinuxProcessEnumerator
 #define ProcessEnumerator LinuxProcessEnumerator
 #endif
 
 #include "process/linux/ProcessStat.h"
+#include "process/linux/ProcessSampleCache.h"
 
 #endif
 
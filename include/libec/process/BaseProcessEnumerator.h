@@ -17,9 +17,11 @@
 #include <list>
 
 #include "BaseProcess.h"
+#include "ProcessTable.h"
 #include "ProcessFilter.h"
 #include "../Globals.h"
 #include "../tools/Tools.h"
+#include "../tools/SamplingClock.h"
 #include "../monitor/feeder/MonitorFeeder.h"
 
 namespace cea
@@ -69,6 +71,14 @@ namespace cea
     bool
     needUpdate() const;
 
+    /// @brief Get the number of updates missed
+    ///
+    /// The updates follow deadlines spaced by the frequency (see
+    /// SamplingClock), the deadlines skipped by a late update are counted.
+    /// @return Number of deadlines missed
+    u64
+    getMissedUpdates() const;
+
     /// @brief Begin update store all deleted process until endUpdate
     ///
     /// This enumaration mode give you access to manage directly deleted
@@ -118,6 +128,10 @@ namespace cea
 
     /* Get the process */
     /// @brief Get a process without modify ProcessEnumerator class
+    ///
+    /// Positions are not stable across updates: a removed process is
+    /// replaced by the last one.
+    ///
     /// @param id Number of process to get (start from 0)
     /// @return Pointer to the corresponding process. \n
     ///         Or 0 if no process found
@@ -222,6 +236,16 @@ namespace cea
     void
     updateProcess(Process* p);
 
+    /// @brief Remove a process from the running process list
+    ///
+    /// The monitors are fed and the process is deleted (or recorded until
+    /// endUpdate if beginUpdate was called).
+    ///
+    /// @param pid Process Identificator considered
+    /// @return true if the process was in the list
+    bool
+    removeProcess(pid_t pid);
+
     /// @brief Apply all filters on Process and select process only
     ///        if all filters passed.
     /// @param p Pointer to the Process to test
@@ -252,10 +276,15 @@ namespace cea
     /// \brief Map of process mapped with Process Identificator
     typedef std::map<pid_t, Process*> ProcessMap;
 
-    ProcessMap _process; ///< List of running process
+    ProcessTable _process; ///< List of running process
 
   private:
 
+    /// @brief Remove a process from the running process list
+    /// @param id Position of the process in the list
+    void
+    removeProcessAt(unsigned int id);
+
     /* Private - Members */
     /// @brief ProcessEnumerator update counter
     ///
@@ -286,7 +315,7 @@ namespace cea
     /// By default=1000ms
     ///
     cea_time_t _frequency;
-    cea_time_t _lastTick; ///< Last time of update call
+    SamplingClock _clock; ///< Deadlines of the updates
 
   };
 
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		PidIndex.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Open-addressing pid -> position index
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_PIDINDEX_H__
+#define LIBEC_PIDINDEX_H__
+
+#include <vector>
+#include <sys/types.h>
+
+namespace cea
+{
+
+  /// @brief Open-addressing pid -> position index
+  ///
+  /// Hash table with linear probing and backward-shift deletion (no
+  /// tombstones). The load factor is kept under 1/2, so lookups, insertions
+  /// and removals are O(1) and do not allocate memory once the table has
+  /// grown to the number of pids indexed.
+  class PidIndex
+  {
+  public:
+
+    /// @brief Construct an empty index
+    PidIndex();
+
+    /// @brief Get the number of pids indexed
+    /// @return Pid count
+    unsigned int
+    size() const;
+
+    /// @brief Get the position of a pid
+    /// @param pid Process Identificator considered
+    /// @return Position or -1 if not found
+    int
+    find(pid_t pid) const;
+
+    /// @brief Set the position of a pid, add it if not found
+    /// @param pid Process Identificator considered
+    /// @param pos Position (>= 0)
+    void
+    set(pid_t pid, int pos);
+
+    /// @brief Remove a pid
+    /// @param pid Process Identificator considered
+    /// @return Position of the pid removed or -1 if not found
+    int
+    erase(pid_t pid);
+
+    /// @brief Remove all the pids
+    void
+    clear();
+
+    /// @brief Reserve room for a number of pids
+    /// @param count Number of pids
+    void
+    reserve(unsigned int count);
+
+  protected:
+
+    /// @brief Entry of the index
+    struct Bucket
+    {
+      pid_t pid; ///< Process Identificator
+      int pos; ///< Position, -1 if the bucket is free
+    };
+
+    /// @brief Get the home bucket of a pid
+    unsigned int
+    hash(pid_t pid) const;
+
+    /// @brief Get the bucket holding a pid
+    /// @return Bucket number or -1 if not found
+    int
+    findBucket(pid_t pid) const;
+
+    /// @brief Resize the table and insert again all the pids
+    /// @param buckets New number of buckets (power of 2)
+    void
+    rehash(unsigned int buckets);
+
+    std::vector<Bucket> _buckets; ///< Hash table
+    unsigned int _mask; ///< Number of buckets - 1
+    unsigned int _count; ///< Number of pids indexed
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::PidIndex
+///	@ingroup process
+///
+///////////////////////////////////////////////////////////////////////////////
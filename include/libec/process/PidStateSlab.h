@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		PidStateSlab.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Per-pid state shared by all the PIDSensors
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_PIDSTATESLAB_H__
+#define LIBEC_PIDSTATESLAB_H__
+
+#include <vector>
+#include <sys/types.h>
+
+#include "PidIndex.h"
+
+namespace cea
+{
+
+  class PIDSensor;
+
+  /// @brief Per-pid state shared by all the PIDSensors
+  ///
+  /// Every PIDSensor keeping data per process registers a fixed size block
+  /// and gets its offset inside a row. There is one row per pid, holding the
+  /// blocks of all the sensors side by side, so a single pid lookup gives
+  /// access to the state of every sensor and the sensors do not need a map
+  /// (and a node allocation) per process anymore.
+  ///
+  /// Rows are allocated by chunks and recycled, so acquiring a row does not
+  /// move the others. Registering a block wider than the current rows
+  /// rebuilds them: pointers returned by acquire() and find() must not be
+  /// kept across a sensor creation.
+  ///
+  /// Rows are released by the process enumerator when a process ends. Each
+  /// owner is notified through PIDSensor::remove() before the row is freed,
+  /// which allows it to release external resources (e.g. file descriptors).
+  ///
+  /// New blocks and rows are zero filled.
+  class PidStateSlab
+  {
+  public:
+
+    /// @brief Register a new block in every row
+    /// @param size Size of the block in bytes
+    /// @param owner Sensor notified when a row is released (may be NULL)
+    /// @return Offset of the block inside the rows
+    static unsigned int
+    registerBlock(unsigned int size, PIDSensor* owner);
+
+    /// @brief Unregister a block, its room will be reused
+    /// @param offset Offset returned by registerBlock()
+    static void
+    unregisterBlock(unsigned int offset);
+
+    /// @brief Change the sensor notified when a row is released
+    /// @param offset Offset returned by registerBlock()
+    /// @param owner New owner of the block
+    static void
+    setOwner(unsigned int offset, PIDSensor* owner);
+
+    /// @brief Get the row of a pid, create it if not found
+    /// @param pid Process Identificator considered
+    /// @return Pointer to the row or NULL if no block is registered
+    static char*
+    acquire(pid_t pid);
+
+    /// @brief Get the row of a pid
+    /// @param pid Process Identificator considered
+    /// @return Pointer to the row or NULL if not found
+    static char*
+    find(pid_t pid);
+
+    /// @brief Release the row of a pid
+    ///
+    /// The owner of each block is notified before the row is freed.
+    ///
+    /// @param pid Process Identificator considered
+    static void
+    release(pid_t pid);
+
+    /// @brief Get the pids holding a row
+    /// @param pids Vector filled with the pids
+    static void
+    getPids(std::vector<pid_t>& pids);
+
+    /// @brief Get the number of rows in use
+    static unsigned int
+    getRowCount();
+
+    /// @brief Get the size of a row in bytes
+    static unsigned int
+    getRowSize();
+
+  protected:
+
+    /// @brief Block of a row
+    struct Block
+    {
+      unsigned int offset; ///< Offset inside the rows
+      unsigned int size; ///< Size in bytes
+      PIDSensor* owner; ///< Owner of the block
+      bool used; ///< False if the block can be reused
+    };
+
+    /// @brief Get the address of a row
+    static char*
+    getRow(unsigned int row);
+
+    /// @brief Check if a row is in use
+    static bool
+    isUsed(unsigned int row);
+
+    /// @brief Rebuild the rows with a new row size
+    static void
+    resize(unsigned int rowSize);
+
+    /// @brief Zero a block in every row in use
+    static void
+    zeroBlock(const Block& block);
+
+    /// @brief State of the slab
+    struct Storage
+    {
+      std::vector<Block> blocks; ///< Registered blocks
+      std::vector<char*> chunks; ///< Row storage
+      std::vector<pid_t> rowPid; ///< Last pid of each row
+      std::vector<unsigned int> freeRows; ///< Rows to be reused
+      PidIndex index; ///< pid -> row index
+      unsigned int rowSize; ///< Size of a row in bytes
+
+      Storage() :
+          rowSize(0)
+      {
+      }
+    };
+
+    /// @brief Get the state of the slab, built on first use: the sensors
+    /// register their blocks from constructors that may run during the
+    /// static initialization
+    static Storage&
+    storage();
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::PidStateSlab
+///	@ingroup process
+///
+///////////////////////////////////////////////////////////////////////////////
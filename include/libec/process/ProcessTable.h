@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		ProcessTable.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Dense process table indexed by pid
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_PROCESSTABLE_H__
+#define LIBEC_PROCESSTABLE_H__
+
+#include <vector>
+#include <sys/types.h>
+
+#include "BaseProcess.h"
+#include "PidIndex.h"
+
+namespace cea
+{
+
+  /// @brief Dense process table indexed by pid
+  ///
+  /// Processes are stored in a contiguous vector (positions 0..size()-1)
+  /// and a PidIndex maps each pid to
+  /// its position. Positional access, pid lookup, insertion and removal
+  /// are O(1) and do not allocate memory once the table has grown to the
+  /// number of running processes.
+  ///
+  /// Removal moves the last process into the freed position, so positions
+  /// are not stable across removals and do not follow the pid order.
+  ///
+  /// The table does not own the processes: deleting them is left to the
+  /// caller.
+  class ProcessTable
+  {
+  public:
+
+    /// @brief Construct an empty table
+    ProcessTable();
+
+    /// @brief Get the number of processes
+    /// @return Process count
+    unsigned int
+    size() const;
+
+    /// @brief Get a process by position
+    /// @param id Position of the process (start from 0)
+    /// @return Pointer to the process or 0 if out of range
+    Process*
+    at(unsigned int id) const;
+
+    /// @brief Get a process by pid
+    /// @param pid Process Identificator considered
+    /// @return Pointer to the process or 0 if not found
+    Process*
+    find(pid_t pid) const;
+
+    /// @brief Get the position of a process
+    /// @param pid Process Identificator considered
+    /// @return Position of the process or -1 if not found
+    int
+    indexOf(pid_t pid) const;
+
+    /// @brief Add a process, indexed by its pid
+    /// @param p Process to add
+    /// @return Process previously stored with the same pid, 0 if none
+    Process*
+    insert(Process* p);
+
+    /// @brief Remove a process by pid
+    /// @param pid Process Identificator considered
+    /// @return Removed process or 0 if not found
+    Process*
+    remove(pid_t pid);
+
+    /// @brief Remove a process by position
+    ///
+    /// The last process takes the freed position.
+    ///
+    /// @param id Position of the process
+    /// @return Removed process or 0 if out of range
+    Process*
+    removeAt(unsigned int id);
+
+    /// @brief Remove all the processes (without deleting them)
+    void
+    clear();
+
+    /// @brief Reserve room for a number of processes
+    /// @param count Number of processes
+    void
+    reserve(unsigned int count);
+
+  protected:
+
+    std::vector<Process*> _dense; ///< Processes by position
+    PidIndex _index; ///< pid -> position index
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::ProcessTable
+///	@ingroup process
+///
+///////////////////////////////////////////////////////////////////////////////
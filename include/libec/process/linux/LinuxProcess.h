@@ -31,18 +31,46 @@ namespace cea
     /// @param pid Process Identificator considered
     LinuxProcess(pid_t pid);
 
+    /// @brief Construct a process item from an already read stat snapshot
+    /// @param pid Process Identificator considered
+    /// @param stat Snapshot of proc/[pid]/stat
+    LinuxProcess(pid_t pid, const ProcessStat::Snapshot& stat);
+
     /* Function */
     /// @brief Calcul the cpu usage by total CPU time elapsed
     /// @param totalCPUTimeElapsed Total CPU time elapsed
     void
     calculCPUUsage(long int totalCPUTimeElapsed);
 
+    /* Memory pool */
+    /// @brief Get memory for a process from the process pool
+    ///
+    /// Process objects are carved out of blocks allocated once and
+    /// recycled when deleted, so the process churn does not reach the heap.
+    ///
+    /// @param size Size of the object
+    /// @return Pointer to the memory
+    static void*
+    operator new(size_t size);
+
+    /// @brief Give back the memory of a process to the process pool
+    /// @param ptr Pointer to the memory
+    /// @param size Size of the object
+    static void
+    operator delete(void* ptr, size_t size);
+
   protected:
 
     /// @brief Retrieve the process path
     void
     retrievePath();
 
+    /// @brief Number of processes allocated at once by the pool
+    static const unsigned int PoolBlockSize = 256;
+
+    /// @brief First free slot of the process pool
+    static void* _freeSlots;
+
   };
 
 }
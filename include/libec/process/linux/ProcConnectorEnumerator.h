@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		ProcConnectorEnumerator.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Linux running process enumerator driven by the netlink proc
+///             connector
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_PROCCONNECTORENUMERATOR_H__
+#define LIBEC_PROCCONNECTORENUMERATOR_H__
+#ifdef __unix__
+
+#include "LinuxProcessEnumerator.h"
+
+namespace cea
+{
+
+  /// @brief Linux running process enumerator driven by the netlink proc
+  ///        connector (cn_proc)
+  ///
+  /// Instead of reading the whole /proc directory on each update, the
+  /// process list is kept up to date with the fork, exec and exit events
+  /// sent by the kernel. The cost of an update follows the process churn
+  /// instead of the number of running processes.
+  ///
+  /// A full /proc rescan is still done on the first update, when events were
+  /// lost (socket buffer overrun) and periodically as a safety net. If the
+  /// connector cannot be used (kernel without CONFIG_PROC_EVENTS or missing
+  /// CAP_NET_ADMIN) every update falls back to a full /proc rescan.
+  class ProcConnectorEnumerator : public LinuxProcessEnumerator
+  {
+  public:
+
+    /// @brief Connect to the proc connector
+    ProcConnectorEnumerator();
+
+    /// @brief Disconnect from the proc connector
+    ~ProcConnectorEnumerator();
+
+    /// @brief Check if the proc connector is used
+    /// @return true if events are received, false if /proc is rescanned on
+    ///         each update
+    bool
+    isConnected() const;
+
+    /// @brief Get the safety net /proc rescan period
+    /// @return Rescan period in ms
+    cea_time_t
+    getRescanPeriod() const;
+
+    /// @brief Set the safety net /proc rescan period
+    /// @param period Rescan period in ms, 0 to rescan only when events
+    ///               were lost
+    void
+    setRescanPeriod(cea_time_t period);
+
+    /// @brief Get the number of full /proc rescans done
+    /// @return Rescan count
+    unsigned int
+    getRescanCount() const;
+
+  protected:
+
+    /// @brief Update the process list from the received events
+    void
+    enumProcess();
+
+    /// @brief Open the netlink socket and subscribe to proc events
+    /// @return true if connected
+    bool
+    connect();
+
+    /// @brief Unsubscribe and close the netlink socket
+    void
+    disconnect();
+
+    /// @brief Read all the pending events
+    /// @param apply If false the events are only drained
+    void
+    readEvents(bool apply);
+
+    int _socket; ///< Netlink socket, -1 if not connected
+    bool _needRescan; ///< Force a full /proc rescan on next update
+    cea_time_t _rescanPeriod; ///< Safety net rescan period in ms
+    cea_time_t _lastRescan; ///< Time of the last full rescan
+    unsigned int _rescanCount; ///< Number of full rescans
+  };
+
+}
+
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::ProcConnectorEnumerator
+///	@ingroup process
+///
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		ProcessSampleCache.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Tick-scoped cache of the proc/[pid] files read by PIDSensors
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_PROCESSSAMPLECACHE_H__
+#define LIBEC_PROCESSSAMPLECACHE_H__
+
+#include <map>
+#include <sys/types.h>
+
+#include "../../Globals.h"
+#include "ProcessStat.h"
+
+namespace cea
+{
+
+  /// @brief Tick-scoped cache of the proc/[pid] files read by PIDSensors
+  ///
+  /// The process enumerator opens a new tick on each update and stores the
+  /// proc/[pid]/stat snapshot it already reads for every running process.
+  /// proc/[pid]/statm and proc/[pid]/io are read on the first request of a
+  /// tick. Every other PIDSensor asking for the same pid during the same tick
+  /// gets the stored sample, so the number of files read per tick depends on
+  /// the number of processes and not on the number of sensors.
+  ///
+  /// Until a tick is opened (no enumerator running), the cache is disabled
+  /// and every request reads the file again, as the sensors used to do.
+  class ProcessSampleCache
+  {
+  public:
+
+    /// @brief Content of proc/[pid]/statm (in pages)
+    struct Statm
+    {
+      u64 size; ///< Total program size
+      u64 resident; ///< Resident set size
+      u64 shared; ///< Resident shared pages
+      u64 text; ///< Text (code)
+      u64 lib; ///< Library (unused since Linux 2.6)
+      u64 data; ///< Data + stack
+      u64 dt; ///< Dirty pages (unused since Linux 2.6)
+    };
+
+    /// @brief Content of proc/[pid]/io (in bytes or syscalls)
+    struct Io
+    {
+      u64 rchar; ///< Characters read
+      u64 wchar; ///< Characters written
+      u64 syscr; ///< Read syscalls
+      u64 syscw; ///< Write syscalls
+      u64 readBytes; ///< Bytes fetched from the storage layer
+      u64 writeBytes; ///< Bytes sent to the storage layer
+      u64 cancelledWriteBytes; ///< Bytes whose write was cancelled
+    };
+
+    /// @brief Open a new tick: all cached samples become outdated
+    ///
+    /// Samples of processes not requested during the previous tick are
+    /// dropped from memory.
+    static void
+    beginTick();
+
+    /// @brief Get the current tick number
+    /// @return Current tick, 0 if the cache was never ticked
+    static unsigned int
+    getTick();
+
+    /// @brief Store a stat snapshot already read for the current tick
+    /// @param pid Process Identificator considered
+    /// @param stat Snapshot of proc/[pid]/stat
+    static void
+    setStat(pid_t pid, const ProcessStat::Snapshot& stat);
+
+    /// @brief Get proc/[pid]/stat for the current tick
+    /// @param pid Process Identificator considered
+    /// @return Snapshot of the file or NULL if it could not be read
+    static const ProcessStat::Snapshot*
+    getStat(pid_t pid);
+
+    /// @brief Get proc/[pid]/statm for the current tick
+    /// @param pid Process Identificator considered
+    /// @return Content of the file or NULL if it could not be read
+    static const Statm*
+    getStatm(pid_t pid);
+
+    /// @brief Get proc/[pid]/io for the current tick
+    /// @param pid Process Identificator considered
+    /// @return Content of the file or NULL if it could not be read
+    static const Io*
+    getIo(pid_t pid);
+
+    /// @brief Drop the samples of a process
+    /// @param pid Process Identificator considered
+    static void
+    remove(pid_t pid);
+
+    /// @brief Drop all the samples and disable the cache
+    static void
+    clear();
+
+    /// @brief Get the number of proc/[pid] files read since the beginning
+    /// @return Number of files read
+    static u64
+    getReadCount();
+
+  protected:
+
+    /// @brief Samples of a process
+    struct Sample
+    {
+      unsigned int statTick; ///< Tick of the stat sample
+      unsigned int statmTick; ///< Tick of the statm sample
+      unsigned int ioTick; ///< Tick of the io sample
+      bool statmValid; ///< True if statm was read
+      bool ioValid; ///< True if io was read
+      ProcessStat::Snapshot stat; ///< proc/[pid]/stat
+      Statm statm; ///< proc/[pid]/statm
+      Io io; ///< proc/[pid]/io
+    };
+
+    /// @brief Map of samples mapped with Process Identificator
+    typedef std::map<pid_t, Sample> SampleMap;
+
+    /// @brief Get the sample entry of a process, create it if needed
+    /// @param pid Process Identificator considered
+    /// @return Sample entry
+    static Sample&
+    getSample(pid_t pid);
+
+    /// @brief Check if a sample read during a tick can still be used
+    /// @param tick Tick of the sample
+    /// @return true if it is up to date
+    static bool
+    isFresh(unsigned int tick);
+
+    /// @brief Read proc/[pid]/statm
+    static bool
+    readStatm(pid_t pid, Statm& statm);
+
+    /// @brief Read proc/[pid]/io
+    static bool
+    readIo(pid_t pid, Io& io);
+
+    static SampleMap _samples; ///< Samples of each process
+    static unsigned int _tick; ///< Current tick, 0 if never ticked
+    static u64 _readCount; ///< Number of files read
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::ProcessSampleCache
+///	@ingroup process
+///
+///////////////////////////////////////////////////////////////////////////////
@@ -110,7 +110,74 @@ namespace cea
       } v;
     };
 
+    /// @brief Parsed content of a whole proc/[pid]/stat file
+    /// @details The file is opened, read and closed exactly once by read(),
+    ///          then every field is parsed into its typed Value. Use it
+    ///          instead of the per-field helpers when more than one field
+    ///          of the same process is needed.
+    struct Snapshot
+    {
+      /// @brief Maximum length of the COMM field (including '\0')
+      enum
+      {
+        COMM_MAX = 64
+      };
+
+      pid_t pid; ///< Process Identificator read
+      bool valid; ///< true if the stat file was read and parsed
+      unsigned int count; ///< Number of fields parsed (COMM included)
+      char comm[COMM_MAX]; ///< Value of the COMM field
+      Value field[ProcStatFieldCount]; ///< Typed value of each field
+
+      /// @brief Construct an invalid snapshot
+      Snapshot();
+
+      /// @brief Read and parse proc/[pid]/stat
+      /// @param pid Process Identificator considered
+      /// @return true if the file was read and parsed
+      bool
+      read(pid_t pid);
+
+      /// @brief Parse the content of a proc/[pid]/stat file
+      /// @param data Content of the file ('\0' terminated)
+      /// @return true if the content was parsed
+      bool
+      parse(const char* data);
+    };
+
     /* Helpers functions */
+    /// @brief Get value of a field from a snapshot
+    /// @param snap Snapshot previously read
+    /// @param stat Field wanted
+    /// @param c Out value of the field
+    /// @param defaultValue Value set to c if no stat field corresponding
+    /// @return true if value retrieved
+    static bool
+    get(const Snapshot& snap, Field stat, char& c, char defaultValue = ' ');
+    /// @copydoc get(const Snapshot&, Field, char&, char)
+    static bool
+    get(const Snapshot& snap, Field stat, int& d, int defaultValue = 0);
+    /// @copydoc get(const Snapshot&, Field, char&, char)
+    static bool
+    get(const Snapshot& snap, Field stat, unsigned int& u,
+        unsigned int defaultValue = 0);
+    /// @copydoc get(const Snapshot&, Field, char&, char)
+    static bool
+    get(const Snapshot& snap, Field stat, long int& ld,
+        long int defaultValue = 0);
+    /// @copydoc get(const Snapshot&, Field, char&, char)
+    static bool
+    get(const Snapshot& snap, Field stat, long unsigned int& lu,
+        long unsigned int defaultValue = 0);
+    /// @copydoc get(const Snapshot&, Field, char&, char)
+    static bool
+    get(const Snapshot& snap, Field stat, long long unsigned int& llu,
+        long long unsigned int defaultValue = 0);
+    /// @copydoc get(const Snapshot&, Field, char&, char)
+    static bool
+    get(const Snapshot& snap, Field stat, std::string& s,
+        const std::string& defaultValue = "");
+
     /// @brief Get value of a proc stat field
     /// @param pid Process Identificator considered
     /// @param stat Field wanted
@@ -184,6 +251,12 @@ namespace cea
     static std::string
     getStr(pid_t pid, Field stat);
 
+    /// @brief Get the type of a proc stat field
+    /// @param stat Field considered
+    /// @return Type of the field, UNKNOWN if out of range
+    static Type
+    getType(Field stat);
+
   protected:
 
     /* Protected - function */
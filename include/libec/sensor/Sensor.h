@@ -102,6 +102,19 @@ namespace cea
     virtual sensor_t
     getValue();
 
+    /// Gets the period at which the sensor wants to be updated.
+    /// \return Period in milliseconds (ms), 0 if the sensor follows the
+    /// period of its caller
+    unsigned int
+    getPeriod() const;
+
+    /// Sets the period at which the sensor wants to be updated (see
+    /// SensorScheduler).
+    /// \param period Period in milliseconds (ms), 0 to follow the period of
+    /// the caller
+    void
+    setPeriod(unsigned int period);
+
     /// \brief Returns all parameters as a XML string
     /// \param indentation Indentation for each output line break
     virtual std::string
@@ -160,6 +173,9 @@ namespace cea
 
     /// Sensor latency in milliseconds (ms)
     long _latency;
+
+    /// Update period in milliseconds (ms), 0 if not declared
+    unsigned int _period;
   };
 
 }
@@ -20,7 +20,10 @@
 #ifndef LIBEC_SENSORCPUFREQ_H__
 #define LIBEC_SENSORCPUFREQ_H__
 
+#include <vector>
+
 #include "Sensor.h"
+#include "../device/KernelAttr.h"
 
 namespace cea
 {
@@ -29,10 +32,18 @@ namespace cea
   /// \details
   /// This sensor collects the current CPU frequency in KHz from the
   /// /sys/devices/system/cpu/cpuID/cpufreq/cpuinfo_cur_freq virtual file.
-  /// To access this file, one need to have administrative permissions.
+  /// To access this file, one need to have administrative permissions, users
+  /// read scaling_cur_freq instead. Without cpufreq, the "cpu MHz" lines of
+  /// /proc/cpuinfo are read. The file is opened once and read again from its
+  /// start at each update.
   /// This sensor has the latency as described into the
   /// cpuinfo_transition_latency file.
   ///
+  /// In the TIME_IN_STATE mode, the sensor reads the cpufreq/stats/
+  /// time_in_state file instead: getResidency() gives the time spent at each
+  /// frequency of getFrequencies() during the last interval, and the value
+  /// is the mean frequency of the interval in KHz.
+  ///
   /// \author     Leandro Fontoura Cupertino
   /// \date       Jul 1 2012
   /// \copyright  2012, CoolEmAll (INFSO-ICT-288701)
@@ -42,10 +53,19 @@ namespace cea
   public:
     static const char* ClassName;
 
+    /// What the sensor reads
+    enum Mode
+    {
+      CURRENT = 0, ///< Current frequency
+      TIME_IN_STATE ///< Time spent at each frequency
+    };
+
     /// Constructor
     /// \param cpu_id   The identification of the cpu to collect data
     /// \param latency  Minimum time between updates, in milliseconds
-    CpuFreq(unsigned short cpu_id = 0, suseconds_t latency = -1);
+    /// \param mode     What the sensor reads
+    CpuFreq(unsigned short cpu_id = 0, suseconds_t latency = -1,
+        Mode mode = CURRENT);
 
     CpuFreq(const std::string &xmlTag);
 
@@ -63,6 +83,20 @@ namespace cea
     sensor_t
     getValue();
 
+    /// Gets the frequencies (KHz) of the time_in_state file, in its order
+    const std::vector<u64>&
+    getFrequencies() const;
+
+    /// Gets the time (ms) spent at each frequency during the last interval
+    /// (TIME_IN_STATE mode)
+    const std::vector<u64>&
+    getResidency() const;
+
+    /// Sets the directory holding the cpuN directories, for the sensors
+    /// created afterwards
+    static void
+    setPath(const std::string &path);
+
     /// Returns class name
     const char*
     getClassName();
@@ -100,32 +134,52 @@ namespace cea
     checkActivity();
 
     /// Check if there is a privileged access to collect CPU's frequency info
+    /// and opens cpuinfo_cur_freq
     /// \param cpuId  CPU's identifier
     /// \return       true if the access is allowed, false otherwise
     bool
     checkRootAccess(unsigned short cpuId);
 
-    /// Check if the user have access to the used files to collect the CPU's frequency
+    /// Check if the user have access to the used files to collect the CPU's
+    /// frequency and opens scaling_cur_freq
     /// \param cpuId  CPU's identifier
     /// \return       true if the access is allowed, false otherwise
     bool
     checkUserAccess(unsigned short cpuId);
 
+    /// Check if /proc/cpuinfo gives the frequency of the CPU and opens it
+    /// \param cpuId  CPU's identifier
+    /// \return       true if a "cpu MHz" line was found, false otherwise
+    bool
+    checkCpuinfoAccess(unsigned short cpuId);
+
+    /// Opens time_in_state and sizes the histogram on its frequencies
+    /// \param cpuId  CPU's identifier
+    /// \return       true if the file could be read, false otherwise
+    bool
+    checkStatsAccess(unsigned short cpuId);
+
     /// Gets the minimum latency which the sensor may operate.
     /// This value is besed on the the maximum transition latency from
     /// cpuinfo_transition_latency
     suseconds_t
     minLatency();
 
-    /// Update sensor's value with privileged access
+    /// Update sensor's value from the current frequency file
     /// \return updated value
     u64
-    updateAsRoot();
+    updateCurrent();
 
-    /// Update sensor's value with uses access
+    /// Update sensor's value from the "cpu MHz" line of the CPU in
+    /// /proc/cpuinfo
     /// \return updated value
     u64
-    updateAsUser();
+    updateCpuinfo();
+
+    /// Update the histogram from the time_in_state file
+    /// \return mean frequency of the interval
+    u64
+    updateTimeInState();
 
     /// Pointer to the function charged to update sensor's value
     /// \return updated value
@@ -135,8 +189,29 @@ namespace cea
     /// CPU's identifier
     unsigned _cpuId;
 
-    /// Path to cpuinfo_cur_freq file
+    /// What the sensor reads
+    Mode _mode;
+
+    /// Path to the file read
     std::string _filepath;
+
+    /// File read, kept open
+    KernelAttr _file;
+
+    /// Content of /proc/cpuinfo up to the CPU, read at each update
+    std::vector<char> _buffer;
+
+    /// Frequencies (KHz) of time_in_state
+    std::vector<u64> _freqs;
+
+    /// Time at each frequency (clock ticks) at the last update
+    std::vector<u64> _ticks;
+
+    /// Time at each frequency (ms) during the last interval
+    std::vector<u64> _residency;
+
+    /// Directory holding the cpuN directories
+    static std::string _path;
   };
 
 }
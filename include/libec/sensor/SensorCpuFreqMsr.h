@@ -62,10 +62,6 @@ namespace cea
     int
     mperf_get_count_freq(unsigned long long *count, unsigned int cpu);
     int
-    mperf_get_tsc(unsigned long long *tsc);
-    int
-    read_msr(int cpu, unsigned int idx, unsigned long long *val);
-    int
     mperf_init_stats(unsigned int cpu);
     int
     mperf_measure_stats(unsigned int cpu);
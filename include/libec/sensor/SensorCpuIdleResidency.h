@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SensorCpuIdleResidency.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Residency of all the CPUs in their idle states (C-states)
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_SENSOR_CPU_IDLE_RESIDENCY_H__
+#define LIBEC_SENSOR_CPU_IDLE_RESIDENCY_H__
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+#include "Sensor.h"
+#include "../device/KernelAttr.h"
+
+namespace cea
+{
+
+  /// @brief Residency of all the CPUs in their idle states (C-states)
+  ///
+  /// CpuStateTime reads the cpuidle files of one state of one CPU, opening
+  /// them at each update. CpuIdleResidency opens the time file of every
+  /// state of every CPU once, and refreshes the whole CPU x state matrix in
+  /// a single pass of pread() on the descriptors kept open, scanned by hand
+  /// into preallocated arrays: nothing is allocated after the constructor,
+  /// and a file is opened again only if it was removed (CPU hotplug).
+  ///
+  /// The matrix is dense and row-major by CPU: the entry of a state is at
+  /// cpu * getStateCount() + state. getResidencyMatrix() gives the time (us)
+  /// spent in each state between the last two passes, getShare() its share
+  /// of the elapsed time. The sensor value is the mean idle share of the
+  /// CPUs (Float, 0 to 1).
+  ///
+  /// CpuIdleShare gives one share as a sensor column. The columns share the
+  /// residency got by acquire(): the first column updated in a tick makes
+  /// the pass, the others read its matrix.
+  class CpuIdleResidency : public Sensor
+  {
+  public:
+    /// @brief Constructor
+    /// @param path Directory holding the cpuN directories
+    CpuIdleResidency(const std::string &path = "/sys/devices/system/cpu/");
+
+    virtual
+    ~CpuIdleResidency();
+
+    /// @brief Reads the time of all the states of all the CPUs in one pass
+    void
+    update();
+
+    sensor_t
+    getValue();
+
+    /// @brief Gets the number of CPUs (rows of the matrix)
+    unsigned int
+    getCpuCount() const;
+
+    /// @brief Gets the number of idle states (columns of the matrix)
+    unsigned int
+    getStateCount() const;
+
+    /// @brief Gets the name of a state (C1, C1E, ...) as read on the first CPU
+    std::string
+    getStateName(unsigned int state) const;
+
+    /// @brief Gets the matrix of the time (us) spent in each state by each CPU
+    /// between the last two passes
+    const u64*
+    getResidencyMatrix() const;
+
+    /// @brief Gets the time (us) elapsed between the last two passes
+    u64
+    getElapsed() const;
+
+    /// @brief Gets the share of the elapsed time a CPU spent in a state.
+    /// @param cpu CPU id
+    /// @param state State id, -1 for the time out of the idle states (C0)
+    /// @return The share, from 0 to 1
+    float
+    getShare(unsigned int cpu, int state) const;
+
+    /// @brief Makes a pass if the one last read by a column is the current one
+    /// and gets the share of the column, both under the mutex
+    /// @param seq Pass last read by the column, updated to the current one
+    /// @param cpu CPU id
+    /// @param state State id, -1 for C0
+    /// @return The share, from 0 to 1
+    float
+    refresh(u64 &seq, unsigned int cpu, int state);
+
+    /// @brief Gets the number of time files opened since the construction
+    u64
+    getOpenCount() const;
+
+    /// @brief Gets the number of passes since the construction
+    u64
+    getPassCount() const;
+
+    /// @brief Gets the residency of the system, shared by the columns
+    static CpuIdleResidency*
+    acquire();
+
+    /// @brief Releases the residency got by acquire(), the last release
+    /// deletes it
+    static void
+    release(CpuIdleResidency* residency);
+
+  protected:
+    /// @brief Reads the times and computes the residency (mutex held)
+    void
+    pass();
+
+    /// @brief Computes the share of a CPU in a state (mutex held)
+    float
+    computeShare(unsigned int cpu, int state) const;
+
+    std::string _path;
+    unsigned int _cpus;
+    unsigned int _states;
+    std::vector<std::string> _stateNames;
+    std::vector<KernelAttr> _files; ///< Time files, no path if the state is missing
+    std::vector<u64> _time; ///< Time of the last pass (us)
+    std::vector<u64> _residency; ///< Time between the last two passes (us)
+    u64 _last; ///< Time of the last pass (CLOCK_MONOTONIC, ns)
+    u64 _elapsed; ///< Time between the last two passes (us)
+    u64 _openCount;
+    u64 _passCount; ///< Also the current pass
+    mutable pthread_mutex_t _mutex;
+
+    static CpuIdleResidency* _shared;
+    static unsigned int _users;
+    static pthread_mutex_t _sharedMutex;
+
+  private:
+    // not copyable: the columns point to the residency
+    CpuIdleResidency(const CpuIdleResidency&);
+    CpuIdleResidency&
+    operator=(const CpuIdleResidency&);
+  };
+
+  /// @brief Share of the time a CPU spent in an idle state, as a column
+  ///
+  /// The columns of all the CPUs and states share one CpuIdleResidency:
+  /// updating all of them in a tick costs one pass over the cpuidle files.
+  class CpuIdleShare : public Sensor
+  {
+  public:
+    /// @brief Constructor
+    /// @param cpu CPU id
+    /// @param state State id, -1 for the time out of the idle states (C0)
+    /// @param residency Residency read, the shared one if NULL
+    CpuIdleShare(unsigned int cpu, int state,
+        CpuIdleResidency* residency = NULL);
+
+    virtual
+    ~CpuIdleShare();
+
+    void
+    update();
+
+    sensor_t
+    getValue();
+
+  protected:
+    CpuIdleResidency* _residency;
+    bool _shared; ///< The residency was got by acquire()
+    unsigned int _cpu;
+    int _state;
+    u64 _seq; ///< Pass last read
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::CpuIdleResidency
+///	@ingroup sensor
+///////////////////////////////////////////////////////////////////////////////
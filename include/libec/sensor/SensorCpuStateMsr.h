@@ -67,10 +67,6 @@ namespace cea
     int
     mperf_get_count_percent(float *percent);
     int
-    mperf_get_tsc(unsigned long long *tsc);
-    int
-    read_msr(int cpu, unsigned int idx, unsigned long long *val);
-    int
     mperf_init_stats(unsigned int cpu);
     int
     mperf_measure_stats(unsigned int cpu);
@@ -13,6 +13,7 @@
 #define SYSFS_PATH_MAX 255
 
 #include "Sensor.h"
+#include "../device/KernelAttr.h"
 
 namespace cea
 {
@@ -69,6 +70,10 @@ namespace cea
 
     /// Path to cpuinfo_cur_freq file
     char _filepath[SYSFS_PATH_MAX];
+
+    /// Time and usage files, kept open
+    KernelAttr _time;
+    KernelAttr _usage;
   };
 
 } /* namespace cea */
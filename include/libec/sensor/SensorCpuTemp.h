@@ -13,6 +13,7 @@
 
 #include "../tools/Tools.h"
 #include "Sensor.h"
+#include "../device/KernelAttr.h"
 
 #include <string>
 
@@ -100,6 +101,9 @@ namespace cea
     /// Path to CPU's temperature file
     std::string _filepath;
 
+    /// CPU's temperature file, kept open
+    KernelAttr _input;
+
   };
 }
 
@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SensorPerfCgroup.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Performance counter counting per control group (cgroup v2)
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SENSOR_PERFCGROUP_H__
+#define SENSOR_PERFCGROUP_H__
+
+#include <map>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+
+#include "SensorPid.h"
+
+namespace cea
+{
+
+  /// @brief Performance counter counting per control group (cgroup v2)
+  ///
+  /// PerfCount opens a counter per process, so a host with thousands of tasks
+  /// and several events runs out of file descriptors and spends its tick in
+  /// read(). PerfCgroup counts per cgroup instead (PERF_FLAG_PID_CGROUP): a
+  /// cgroup is counted on every online CPU, so it costs one file descriptor
+  /// per CPU whatever the number of processes inside it.
+  ///
+  /// The sensor keeps the PIDSensor interface: the cgroup of a pid is looked
+  /// up in /proc/[pid]/cgroup the first time the pid is seen, and
+  /// getValuePid() returns the total of that cgroup (its processes and the
+  /// ones of its descendants) for the last period. Processes of the same
+  /// cgroup share the counters, which are read once per tick and closed when
+  /// the last of its processes ends. Values are scaled when the counters
+  /// were multiplexed.
+  ///
+  /// Machine level values are the sum of the cgroups in use that have no
+  /// descendant in use: on cgroup v2, a cgroup also counts the processes of
+  /// its descendants, and the root alone counts the whole machine.
+  ///
+  /// @code
+  /// cea::PerfCgroup* cycles = new cea::PerfCgroup(PERF_TYPE_HARDWARE,
+  ///     PERF_COUNT_HW_CPU_CYCLES);
+  ///
+  /// cycles->updatePid(pid);
+  /// // cycles of the container pid runs in
+  /// cycles->getValuePid(pid);
+  /// @endcode
+  class PerfCgroup : public PIDSensor
+  {
+  public:
+    /// @brief Constructor
+    /// @param type Counter's type (PERF_TYPE_*)
+    /// @param config Counter's configuration
+    PerfCgroup(u32 type = 0ul, u64 config = 0ull);
+
+    ~PerfCgroup();
+
+    /// @brief Get the number of cgroups counted
+    unsigned int
+    getCgroupCount() const;
+
+    /// @brief Get the number of file descriptors opened
+    unsigned int
+    getFdCount() const;
+
+    /// @brief Get the cgroup of a process (relative to the cgroup v2 root)
+    /// @param pid Process identifier
+    /// @param path String receiving the path, e.g. "/system.slice/ssh.service"
+    /// @return False if the process does not belong to a cgroup v2
+    static bool
+    getPidCgroup(pid_t pid, std::string &path);
+
+    /// @brief Get the mount point of the cgroup v2 hierarchy
+    /// @return Empty string if cgroup v2 is not mounted
+    static const std::string&
+    getCgroupRoot();
+
+    void
+    update();
+
+    sensor_t
+    getValue();
+
+    void
+    updatePid(pid_t pid);
+
+    sensor_t
+    getValuePid(pid_t pid);
+
+    void
+    add(pid_t pid);
+
+    void
+    remove(pid_t pid);
+
+  private:
+    /// @brief Counters of a cgroup
+    struct Cgroup
+    {
+      std::string path; ///< Path relative to the cgroup root
+      int dirFd; ///< File descriptor of the cgroup directory
+      std::vector<int> fd; ///< One counter per CPU (-1 if not opened)
+      std::vector<u64> raw, rawEna, rawRun; ///< Last values read per CPU
+      u64 value; ///< Scaled value of the last period
+      unsigned int seq; ///< Number of reads
+      unsigned int pids; ///< Number of processes using the cgroup
+    };
+
+    /// @brief Per-pid state, kept in the PidStateSlab
+    struct PidState
+    {
+      int cgroup; ///< Position of the cgroup + 1, 0 if not looked up yet
+      unsigned int seq; ///< Read of the cgroup last used by the pid
+    };
+
+    PerfCgroup(const PerfCgroup &sensor);
+
+    PerfCgroup&
+    operator=(const PerfCgroup &sensor);
+
+    Cgroup*
+    getCgroup(pid_t pid);
+
+    int
+    openCgroup(const std::string &path);
+
+    void
+    closeCgroup(int id);
+
+    void
+    readCgroup(Cgroup &cg);
+
+    /// @brief Check if a descendant of a cgroup is counted
+    bool
+    hasDescendant(const std::string &path) const;
+
+    struct perf_event_attr _attr; ///< Event counted
+    std::vector<Cgroup*> _cgroups; ///< Cgroups counted (NULL if free)
+    std::map<std::string, int> _index; ///< Position of a cgroup by path
+    unsigned int _count; ///< Number of cgroups counted
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::PerfCgroup
+///	@ingroup sensor
+///	@ingroup pidSensor
+///////////////////////////////////////////////////////////////////////////////
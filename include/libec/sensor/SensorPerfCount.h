@@ -23,6 +23,10 @@
 
 namespace cea
 {
+  /// Wrapper of the perf_event_open system call.
+  long
+  perf_event_open(struct perf_event_attr *hw_event, pid_t pid, int cpu,
+      int group_fd, unsigned long flags);
 
   /// @brief Performance Counter sensors
   /// @author Leandro Fontoura Cupertino
@@ -36,6 +40,22 @@ namespace cea
   /// per PID, as the number of process grows the number of file descriptors
   /// can surpass 1024 and then a segmentation fault will happen. Need to fix
   /// this.
+  ///
+  /// When more events are enabled than the PMU has counters, the kernel
+  /// multiplexes them and each counter only runs part of the time. Counters
+  /// are opened with PERF_FORMAT_TOTAL_TIME_ENABLED and
+  /// PERF_FORMAT_TOTAL_TIME_RUNNING, and the values returned are scaled to
+  /// the whole period: value * time enabled / time running. The share of the
+  /// period the counter really ran is given by getMultiplexRatio().
+  ///
+  /// Machine level counters are opened system wide, one file descriptor per
+  /// online CPU (or on a single CPU when core_id is given). Besides the total
+  /// given by getValue(), the values of the last update can be read per
+  /// logical CPU, per physical core (sum of its hardware threads) and per
+  /// package, according to the topology given by CpuInfo. The list of online
+  /// CPUs is checked at each update, the counters of a tick sharing one read
+  /// of CpuInfo: counters are opened on the CPUs brought online and closed on
+  /// the ones removed.
 
   class PerfCount : public PIDSensor
   {
@@ -68,26 +88,98 @@ namespace cea
     sensor_t
     getValuePid(pid_t pid);
 
+    /// Gets the share of the last period the counter was running (1 if it
+    /// was not multiplexed, 0 if it was never scheduled).
+    float
+    getMultiplexRatio();
+
+    /// Gets the value of the last update on a logical CPU.
+    /// \param cpu CPU identifier
+    u64
+    getValueCpu(int cpu);
+
+    /// Gets the value of the last update on a physical core, i.e. the sum of
+    /// its hardware threads.
+    /// \param pkg Package (physical) identifier
+    /// \param core Core identifier inside the package
+    u64
+    getValueCore(int pkg, int core);
+
+    /// Gets the value of the last update on a package (socket).
+    /// \param pkg Package (physical) identifier
+    u64
+    getValuePackage(int pkg);
+
+    /// Gets the share of the last period the counter of a process was
+    /// running.
+    /// \param pid Process identifier
+    float
+    getMultiplexRatioPid(pid_t pid);
+
+    /// Gets the name and alias of a performance counter event.
+    /// \param type Counter's type
+    /// \param config Counter's configuration
+    /// \param name Name of the event (not changed for unnamed types)
+    /// \param alias Alias of the event (not changed for unnamed types)
+    /// \return True if the event is known
+    static bool
+    getEventName(u32 type, u64 config, std::string &name, std::string &alias);
+
+    /// Scales the count of a period to the time the counter was enabled,
+    /// when it was multiplexed: val * ena / run.
+    /// \param val Count of the period
+    /// \param ena Time enabled during the period (ns)
+    /// \param run Time running during the period (ns)
+    /// \return The scaled count, 0 if the counter never ran
+    static u64
+    scaleValue(u64 val, u64 ena, u64 run);
+
   private:
     struct hpc_ent // hardware performance counter entity
     {
       int fd; // file descriptor
       u64 cVal, pVal; // current and previour values
+      u64 cEna, pEna; // current and previous time enabled (ns)
+      u64 cRun, pRun; // current and previous time running (ns)
     };
 
-    // read the performance counter from a file descriptor
-    u64 readPC(int fd);
+    // read the performance counter of an entity, current values become the
+    // previous ones
+    bool
+    readPC(hpc_ent &ent);
+
+    // value of the last period, scaled if the counter was multiplexed
+    static u64
+    scale(const hpc_ent &ent);
+
+    // share of the last period the counter was running
+    static float
+    ratio(const hpc_ent &ent);
+
+    // open the machine level counter of a CPU
+    void
+    openCpu(int cpu);
+
+    // close the machine level counter of a CPU
+    void
+    closeCpu(int cpu);
+
+    // open and close the counters of the CPUs whose online state changed
+    void
+    updateCpus();
 
     //perf_event_attr _attr; // defines how the PC event will behave
     struct perf_event_attr _attr; // defines how the PC event will behave
     int _cpu_id; // identifiers
-    int _cpus_total; // number of CPUs present on the current machine
+    int _cpus_total; // number of CPUs configured on the current machine
+    unsigned int _online_seq; // CpuInfo online sequence of the opened fds
 
-    // Vector of node related performance counter entities
+    // Vector of node related performance counter entities, one per CPU
+    // (fd < 0 if not opened)
     hpc_ent* _nArr;
 
-    // Map of process related performance counter entities
-    std::map<pid_t, hpc_ent> _pidMap;
+    // Process related performance counter entities are kept in the
+    // PidStateSlab (fd <= 0 if not opened)
 
     /// Previous value
     sensor_t _pValue;
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SensorPerfGroup.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Group of performance counters read in a single system call
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SENSOR_PERFGROUP_H__
+#define SENSOR_PERFGROUP_H__
+
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+
+#include "SensorPid.h"
+
+/* Maximum number of events in a group */
+#define PERF_GROUP_MAX_EVENTS 32
+
+namespace cea
+{
+
+  /// @brief Group of performance counters read in a single system call
+  ///
+  /// The events of a group are opened as a perf group: a leader plus members
+  /// attached to it (group_fd). The kernel schedules the whole group at once,
+  /// so all its counters are sampled over the same period, and the leader is
+  /// read with PERF_FORMAT_GROUP, which returns every counter in a single
+  /// read(). Compared to one PerfCount per event, the number of system calls
+  /// per tick is divided by the number of events.
+  ///
+  /// Each event is a column on its own: the sensor created with the event
+  /// list gives the first event, and a sensor per member is created from it
+  /// with PerfGroup(group, member). All these sensors share the counters and
+  /// can be deleted in any order. The first sensor updated in a tick reads
+  /// the group, the others use the values read.
+  ///
+  /// Machine level values are the sum of one group per online CPU (core_id
+  /// -1) or the group of a single CPU, the online CPUs being the ones of
+  /// CpuInfo. Process level groups are opened per pid and kept in the
+  /// PidStateSlab, they are closed when the process ends.
+  ///
+  /// Hardware groups must fit the PMU: a group with more hardware events
+  /// than available counters is never scheduled. When several groups do not
+  /// fit together, the kernel multiplexes them: each group runs in turn and
+  /// the values are scaled to the whole period (value * time enabled / time
+  /// running), getMultiplexRatio() giving the share of the period the group
+  /// really ran. createRotation() spreads a list of events over groups of
+  /// the PMU size, which the kernel rotates so that each one gets a fair
+  /// share of the time.
+  ///
+  /// @code
+  /// std::vector<cea::PerfGroup::Event> events;
+  /// events.push_back(cea::PerfGroup::Event(PERF_TYPE_HARDWARE,
+  ///     PERF_COUNT_HW_CPU_CYCLES));
+  /// events.push_back(cea::PerfGroup::Event(PERF_TYPE_HARDWARE,
+  ///     PERF_COUNT_HW_INSTRUCTIONS));
+  ///
+  /// cea::PerfGroup* cycles = new cea::PerfGroup(events);
+  /// cea::PerfGroup* instructions = new cea::PerfGroup(*cycles, 1);
+  /// @endcode
+  class PerfGroup : public PIDSensor
+  {
+  public:
+
+    /// @brief Event of a group
+    struct Event
+    {
+      Event(u32 type = 0ul, u64 config = 0ull) :
+          type(type), config(config)
+      {
+      }
+
+      u32 type; ///< Counter's type (PERF_TYPE_*)
+      u64 config; ///< Counter's configuration
+    };
+
+    /// @brief Open a group, the sensor gives the first event
+    /// @param events Events of the group (at most PERF_GROUP_MAX_EVENTS)
+    /// @param core_id Core identifier (-1 for all)
+    PerfGroup(const std::vector<Event> &events, int core_id = -1);
+
+    /// @brief Create the sensor of a member of an existing group
+    /// @param group Any sensor of the group
+    /// @param member Position of the event in the group
+    PerfGroup(PerfGroup &group, unsigned int member);
+
+    ~PerfGroup();
+
+    /// @brief Get the number of events of the group
+    unsigned int
+    getMemberCount() const;
+
+    /// @brief Get the position of the event of this sensor in the group
+    unsigned int
+    getMember() const;
+
+    /// @brief Check if a sensor reads the same counters
+    /// @param group Sensor to compare with
+    /// @return true if both sensors are events of one group
+    bool
+    isSameGroup(const PerfGroup &group) const;
+
+    /// @brief Get the number of read() done by the group
+    u64
+    getReadCount() const;
+
+    /// @brief Get the share of the last period the group was running
+    /// @return 1 if not multiplexed, 0 if never scheduled
+    float
+    getMultiplexRatio();
+
+    /// @brief Get the share of the last period the group of a process was
+    /// running
+    /// @param pid Process identifier
+    float
+    getMultiplexRatioPid(pid_t pid);
+
+    /// @brief Spread events over rotating groups
+    ///
+    /// The events are split into groups of at most slots events (the number
+    /// of counters of the PMU). Sensors are appended in the order of the
+    /// events, the caller owns them.
+    ///
+    /// @param events Events to count
+    /// @param slots Maximum number of events per group
+    /// @param sensors Vector receiving a sensor per event
+    /// @param core_id Core identifier (-1 for all)
+    static void
+    createRotation(const std::vector<Event> &events, unsigned int slots,
+        std::vector<PerfGroup*> &sensors, int core_id = -1);
+
+    void
+    update();
+
+    sensor_t
+    getValue();
+
+    void
+    updatePid(pid_t pid);
+
+    sensor_t
+    getValuePid(pid_t pid);
+
+    void
+    add(pid_t pid);
+
+    void
+    remove(pid_t pid);
+
+  private:
+    struct Group;
+
+    /// @brief Counters of a group opened for a process
+    struct PidCounter
+    {
+      int fd; ///< File descriptor, -1 if the event could not be opened
+      u64 cVal, pVal; ///< Current and previous values
+    };
+
+    /// @brief Group opened for a process, kept in the PidStateSlab
+    struct PidGroup
+    {
+      bool opened; ///< True once the group was opened
+      unsigned int seq; ///< Number of reads of the group
+      u64 cEna, pEna; ///< Current and previous time enabled (ns)
+      u64 cRun, pRun; ///< Current and previous time running (ns)
+      PidCounter counter[1]; ///< Counters (getMemberCount() of them)
+    };
+
+    PerfGroup(const PerfGroup &group);
+
+    PerfGroup&
+    operator=(const PerfGroup &group);
+
+    void
+    init();
+
+    PidGroup*
+    getPidGroup(pid_t pid);
+
+    void
+    closePid(pid_t pid);
+
+    Group* _group; ///< Shared counters
+    unsigned int _member; ///< Position of the event in the group
+    unsigned int _seq; ///< Machine level read of the group last used
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::PerfGroup
+///	@ingroup sensor
+///	@ingroup pidSensor
+///////////////////////////////////////////////////////////////////////////////
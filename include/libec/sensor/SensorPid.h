@@ -12,6 +12,7 @@
 #define PIDSENSOR_H_
 
 #include "Sensor.h"
+#include "../process/PidStateSlab.h"
 #include <map>
 
 namespace cea
@@ -266,9 +267,18 @@ namespace cea
     /// \param xmlTag XML tag containing the parameters to load a sensor
     PIDSensor(const std::string &xmlTag);
 
+    /// Copy constructor
+    /// The copy gets its own per-pid state, zero filled.
+    PIDSensor(const PIDSensor &sensor);
+
     virtual
     ~PIDSensor();
 
+    /// Assignment operator
+    /// The per-pid state is not copied, each sensor keeps its own.
+    PIDSensor&
+    operator=(const PIDSensor &sensor);
+
     /// \brief Updates sensor's state.
     /// \param pid Process id. (-1 for all processes)
     virtual void
@@ -285,9 +295,43 @@ namespace cea
     add(pid_t pid);
 
     /// \brief Removes a PID entry from the current and previous maps.
+    /// \details Called by PidStateSlab when the process ends. The default
+    /// implementation zero fills the state of the pid.
     /// \param pid Process ID
     virtual void
     remove(pid_t pid);
+
+  protected:
+    /// \brief Registers the per-pid state of the sensor in the PidStateSlab.
+    /// \details Must be called once, by the constructor of the sensor.
+    /// \param size Size of the state kept for each process
+    void
+    registerState(unsigned int size);
+
+    /// \brief Gets the per-pid state of the sensor, create it if not found.
+    /// \param pid Process ID
+    /// \return Pointer to the (zero filled when created) state
+    template<class T>
+      T*
+      getState(pid_t pid)
+      {
+        char* row = PidStateSlab::acquire(pid);
+        return (row != NULL) ? (T*) (row + _stateOffset) : NULL;
+      }
+
+    /// \brief Gets the per-pid state of the sensor.
+    /// \param pid Process ID
+    /// \return Pointer to the state or NULL if not found
+    template<class T>
+      T*
+      findState(pid_t pid)
+      {
+        char* row = PidStateSlab::find(pid);
+        return (row != NULL) ? (T*) (row + _stateOffset) : NULL;
+      }
+
+    unsigned int _stateOffset; ///< Offset of the state in the PidStateSlab
+    unsigned int _stateSize; ///< Size of the state, 0 if not registered
   };
 
 } /* namespace cea */
@@ -50,8 +50,13 @@ namespace cea
     add(pid_t pid);
 
   private:
-    std::map<pid_t, sensor_t> _cvPIDMap; ///< Current value of the sensor. The PID is used as the key.
-    std::map<pid_t, sensor_t> _pvPIDMap; ///< Previous value of the sensor. The PID is used as the key.
+    /// Per-pid state, kept in the PidStateSlab
+    struct PidState
+    {
+      sensor_t cur; ///< Current value of the sensor
+      sensor_t prev; ///< Previous value of the sensor
+    };
+
     CpuTime _ct;
 
     /// Previous value
@@ -38,9 +38,6 @@ namespace cea
     sensor_t
     getValuePid(pid_t pid);
 
-    void
-    add(pid_t pid);
-
   protected:
     void
     clean();
@@ -49,9 +46,6 @@ namespace cea
     copy();
 
     CpuElapsedTime _cet;
-    std::map<pid_t, struct timeval> _ctimePIDMap, _ptimePIDMap;
-    std::map<pid_t, sensor_t> _cvPIDMap; ///< Current value of the sensor. The PID is used as the key.
-    std::map<pid_t, sensor_t> _pvPIDMap; ///< Previous value of the sensor. The PID is used as the key.
 
     /// Previous value
     struct timeval _pTv;
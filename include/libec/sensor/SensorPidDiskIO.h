@@ -2,6 +2,7 @@
 #define SENSORPID_DISKIO_H__
 
 #include "SensorPid.h"
+#include "../device/KernelAttr.h"
 
 namespace cea
 {
@@ -67,11 +68,10 @@ namespace cea
       //todo: find 'cwrite' for the machine level.
     };
 
-    /// path to the machine's disk info file (/sys/block/[dev]/stat)
-    char _macPath[32];
+    /// machine's disk info file (/sys/block/[dev]/stat)
+    KernelAttr _macStat;
 
     iodata _macValue;
-    std::map<pid_t, iodata> _pidValue;
   };
 
 }
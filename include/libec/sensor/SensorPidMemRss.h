@@ -9,14 +9,15 @@
 #define SENSORPID_MEMRSS_H__
 
 #include "SensorPid.h"
+#include "../device/KernelAttr.h"
 
 namespace cea
 {
   /// \brief Memory Resident Set Size Sensor
   ///
   /// The Memory RSS sensor uses the information from the /proc/[pid]/statm to
-  /// retrieve the process' RSS in pages. The same information, but in Kb, can
-  /// be colected by running the "free -k" command on a machine level.
+  /// retrieve the process' RSS in pages. The same information, but in Kb, is
+  /// computed from /proc/meminfo on a machine level, as "free -k" does.
   class MemRss : public PIDSensor
   {
   public:
@@ -36,7 +37,8 @@ namespace cea
     u64
     toPages(u64 kb);
 
-    /// Update the RSS for the entire machine by executing the "free -k" system call
+    /// Update the RSS for the entire machine from /proc/meminfo: the used
+    /// memory but the buffers and the page cache
     void
     update();
 
@@ -58,11 +60,11 @@ namespace cea
     getValue();
 
   protected:
-    /// Maps the pid into its RSS
-    std::map<pid_t, u64> _memPid;
-
     unsigned pageToKbShift;
 
+    /// /proc/meminfo, kept open
+    KernelAttr _meminfo;
+
     /// The run-time acquired page size
     void
     getPageSize();
@@ -215,10 +215,12 @@ namespace cea
     /// Previous value
     sensor_t _pValue;
 
-    std::map<pid_t, struct timeval> _ctimePIDMap, _ptimePIDMap;
-
-//    std::map<pid_t, std::vector<u64>*> _cvPIDMap, _pvPIDMap;
-    std::map<pid_t, struct pid_stats> _cvPIDMap, _pvPIDMap;
+    /// Per-pid state, kept in the PidStateSlab
+    struct PidState
+    {
+      struct pid_stats cur, prev; ///< Current and previous values
+      struct timeval ctime, ptime; ///< Current and previous update time
+    };
 
     void
     readProcPidStat(pid_t pid, unsigned long int *utime,
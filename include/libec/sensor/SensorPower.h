@@ -10,11 +10,25 @@
 #ifndef SENSOR_POWER_H_
 #define SENSOR_POWER_H_
 
+#include <pthread.h>
+
 #include "Sensor.h"
 
+/* Time waitUpdate() waits for a new sample (ms) */
+#define POWER_WAIT_UPDATE_TIMEOUT 120000
+
 namespace cea
 {
 
+  /// \brief Base class of the power meters
+  ///
+  /// A power meter publishes each new sample with the time it was taken
+  /// (CLOCK_MONOTONIC): the sample counter is incremented and the threads
+  /// blocked in waitUpdate() or waitSample() are woken up. Meters reading
+  /// their device on a thread of their own (e.g. AsyncPowerMeter) publish
+  /// from that thread, so the waiting callers wake as soon as the data
+  /// arrives. The other meters are only read when update() is called: for
+  /// them waitUpdate() still polls update() until the value changes.
   class PowerMeter : public Sensor
   {
   public:
@@ -25,20 +39,67 @@ namespace cea
     /// \param xmlTag XML tag containing the parameters to load a sensor
     PowerMeter(const std::string &xmlTag);
 
-    /// Gets the powermeter's latency.
+    virtual
+    ~PowerMeter();
+
+    /// Gets the powermeter's latency (ms), the time between the device
+    /// timestamps of two consecutive samples.
     /// This method may not work for all powermeters. For low precision tools
     /// the latency must be overloaded. Some vendors make available their
     /// average latency.
     virtual unsigned
     getLatency();
 
-    /// Waits until the value of the power meter changes (update detection)
+    /// Waits until the power meter has a new sample (update detection), at
+    /// most POWER_WAIT_UPDATE_TIMEOUT ms, and updates the sensor
     void
     waitUpdate();
 
+    /// Waits until a sample newer than a given one is published
+    /// \param seq Sample number already known (see getSampleSeq())
+    /// \param timeout Maximum time to wait (ms)
+    /// \return False on timeout
+    bool
+    waitSample(u64 seq, unsigned int timeout);
+
+    /// Checks if the meter publishes its samples from a thread of its own,
+    /// otherwise a sample is taken at each update()
+    bool
+    isPublishing();
+
+    /// Gets the number of samples published so far
+    u64
+    getSampleSeq();
+
+    /// Gets the time of the last sample published (CLOCK_MONOTONIC, ns)
+    u64
+    getSampleTime();
+
+    /// Gets the current time (CLOCK_MONOTONIC, ns)
+    static u64
+    now();
+
   protected:
     void
     clean();
+
+    /// Publishes a new sample and wakes up the waiting threads
+    /// \param time Time the sample was taken by the device
+    /// (CLOCK_MONOTONIC, ns)
+    void
+    publishSample(u64 time);
+
+    /// True if the meter publishes its samples from a thread of its own
+    bool _publishes;
+
+  private:
+    void
+    initSamples();
+
+    pthread_mutex_t _sampleMutex; ///< Protects the sample counter and time
+    pthread_cond_t _sampleCond; ///< Signaled for each new sample
+    u64 _sampleSeq; ///< Number of samples published
+    u64 _sampleTime; ///< Time of the last sample (CLOCK_MONOTONIC, ns)
   };
 
 }
@@ -9,9 +9,8 @@
 #ifndef LIBEC_SENSOR_POWER_ACPI_H_
 #define LIBEC_SENSOR_POWER_ACPI_H_
 
-#include <fstream>
-
 #include "SensorPower.h"
+#include "../device/KernelAttr.h"
 
 namespace cea
 {
@@ -61,10 +60,9 @@ namespace cea
     getClassName();
 
   private:
-    std::ifstream _input; /// < Input file
-    const char* _fpCurrent; /// < Current file path
-    const char* _fpVoltage; /// < Voltage file path
-    const char* _fpState; /// < Battery's state file path
+    KernelAttr _current; /// < Current file
+    KernelAttr _voltage; /// < Voltage file
+    KernelAttr _state; /// < Battery's state file
 
     /// Check's if the sensor is active
     /// \returns  True if active, false otherwise
@@ -0,0 +1,130 @@
+//============================================================================
+// Name        : SensorPowerAsync.h
+// Author      : Leandro Fontoura Cupertino
+// Version     : 0
+// Date        : 2013.09.03
+// Copyright   : Your copyright notice
+// Description : Power meter polled on its own thread
+//============================================================================
+
+#ifndef LIBEC_SENSOR_POWER_ASYNC_H_
+#define LIBEC_SENSOR_POWER_ASYNC_H_
+
+#include <pthread.h>
+
+#include "SensorPower.h"
+
+/* Number of samples kept (power of 2) */
+#define ASYNC_POWER_RING_SIZE 256
+
+namespace cea
+{
+  /// \brief A power meter polled on its own thread
+  ///
+  /// Some power meters are slow to read: G5kPowerMeter starts a shell,
+  /// RecsPowerMeter connects to the controller and WattsUpPowerMeter blocks
+  /// on the serial port. Updated on the sampling thread, they stall the whole
+  /// tick. AsyncPowerMeter wraps such a meter and updates it on a thread of
+  /// its own, storing each value with its time (CLOCK_MONOTONIC) in a ring
+  /// buffer.
+  ///
+  /// The ring has a single writer (the polling thread) and is read without
+  /// locks: each slot has a sequence number, odd while it is being written,
+  /// and readers retry when it changed during their copy. update() and
+  /// getValue() never wait for the device, they give the latest sample;
+  /// getValueAt() interpolates the samples around a given time. Each change
+  /// of the value is published as a new sample, waking up the callers of
+  /// waitUpdate().
+  ///
+  /// @code
+  /// cea::AsyncPowerMeter* pm = new cea::AsyncPowerMeter(
+  ///     new cea::G5kPowerMeter(), 1000);
+  /// pm->update(); // does not block
+  /// pm->getValue();
+  /// @endcode
+  class AsyncPowerMeter : public PowerMeter
+  {
+  public:
+    /// Name of the class as a static parameter
+    static const char* ClassName;
+
+    /// A sample of the power meter
+    struct Sample
+    {
+      u64 time; ///< Time of the sample (CLOCK_MONOTONIC, ns)
+      float value; ///< Power (W)
+    };
+
+    /// Constructor, starts polling the meter
+    /// \param meter Power meter to poll, deleted with the AsyncPowerMeter
+    /// \param period Time between two updates of the meter (ms)
+    AsyncPowerMeter(PowerMeter* meter, unsigned int period = 1000);
+
+    /// Stops the polling thread and deletes the meter
+    ~AsyncPowerMeter();
+
+    /// Takes the latest sample, never blocks
+    void
+    update();
+
+    sensor_t
+    getValue();
+
+    /// Gets the power at a given time, linearly interpolated between the
+    /// samples around it (the oldest or latest sample out of their range)
+    /// \param time Time (CLOCK_MONOTONIC, ns)
+    float
+    getValueAt(u64 time);
+
+    /// Gets a sample
+    /// \param age 0 for the latest sample, 1 for the previous one...
+    /// \param sample Sample copied
+    /// \returns False if there is no such sample
+    bool
+    getSample(unsigned int age, Sample &sample);
+
+    /// Gets the number of samples taken since the start
+    u64
+    getSampleCount();
+
+    /// Gets the wrapped power meter
+    PowerMeter*
+    getMeter();
+
+    /// \brief Get's the name of the class
+    const char*
+    getClassName();
+
+  private:
+    /// Slot of the ring
+    struct Slot
+    {
+      volatile unsigned int seq; ///< Odd while the slot is being written
+      Sample sample; ///< Sample
+    };
+
+    AsyncPowerMeter(const AsyncPowerMeter &meter);
+
+    AsyncPowerMeter&
+    operator=(const AsyncPowerMeter &meter);
+
+    /// Polling thread
+    static void*
+    run(void* meter);
+
+    /// Appends a sample (polling thread only)
+    void
+    push(const Sample &sample);
+
+    PowerMeter* _meter; ///< Power meter polled
+    unsigned int _period; ///< Time between two updates (ms)
+    Slot _ring[ASYNC_POWER_RING_SIZE]; ///< Samples
+    volatile u64 _count; ///< Number of samples written
+    float _published; ///< Value of the last sample published
+    volatile bool _running; ///< Cleared to stop the thread
+    bool _started; ///< True if the thread was created
+    pthread_t _thread; ///< Polling thread
+  };
+}
+
+#endif /* LIBEC_SENSOR_POWER_ASYNC_H_ */
@@ -12,16 +12,22 @@
 #define SENSOR_POWER_G5KPDU_H_
 
 #include <map>
+#include <pthread.h>
 #include "SensorPower.h"
+#include "../tools/HttpClient.h"
+
+/* Port and path of the metrology API (Kwapi) */
+#define G5K_API_PORT 5000
+#define G5K_API_PATH "/v1/probes/"
 
 namespace cea
 {
-  struct IpOut
+  struct G5kApi
   {
-    std::string Ip; ///< PDU's ip address
-    unsigned int Outlet; ///< PDU's outlet id
+    HttpClient* Client; ///< Connection to the metrology API of the site
+    unsigned int Seq; ///< Number of requests sent to the API
 
-    IpOut(std::string ip = "127.0.0.1", unsigned int outlet = 0);
+    G5kApi();
   };
 
   /// \brief            Power distribution unit (PDU) sensor.
@@ -32,15 +38,30 @@ namespace cea
   /// \details
   /// Implements a way to collect Grid5000's PDU's information. This sensor
   /// retrieves the average power consumed by the node in the last 3 seconds.
+  ///
+  /// The power is read from the metrology API of the site (Kwapi), which
+  /// gives the power of all the probes (one per node) in a single JSON
+  /// document: {"probes": {"reims.stremi-1": {"w": 215.0, ...}, ...}}. The
+  /// HTTP/1.1 connection to the API of a site is kept alive and shared by
+  /// the G5kPowerMeter of its nodes: the first one updated in a tick sends
+  /// the request and fills the power of every node of the answer in the host
+  /// map, the others read their value from it. Only the nodes of the host
+  /// map are measured, so that other hosts never contact the API.
   class G5kPowerMeter : public PowerMeter
   {
   public:
     /// Name of the class as a static parameter
     static const char* ClassName;
 
-    /// Constructor
+    /// Constructor, measures the local host
+    /// (node.site.grid5000.fr hostname)
     G5kPowerMeter();
 
+    /// Constructor
+    /// \param node Node name (e.g. "stremi-1")
+    /// \param site Site of the node (e.g. "reims")
+    G5kPowerMeter(const std::string &node, const std::string &site);
+
     /// Constructor
     /// \param xmlTag XML tag containing the parameters to load the sensor
     G5kPowerMeter(const std::string &xmlTag);
@@ -50,31 +71,71 @@ namespace cea
     void
     update();
 
+    /// Sets the metrology API used by all the G5kPowerMeter, whatever their
+    /// site (by default kwapi.<site>.grid5000.fr on port G5K_API_PORT)
+    /// \param host API's host name or address
+    /// \param port API's port
+    /// \param path Path of the probes' resource
+    static void
+    setApi(const std::string &host, int port = G5K_API_PORT,
+        const std::string &path = G5K_API_PATH);
+
+    /// Gets the number of requests sent to the APIs
+    static unsigned int
+    getRequestCount();
+
+    /// Gets the number of connections opened to the APIs
+    static unsigned int
+    getConnectCount();
+
     /// \brief Get's the name of the class
     const char*
     getClassName();
 
   private:
+    void
+    init(const std::string &node, const std::string &site);
+
     bool
     checkActivity();
 
-    // Searches inside a table for the command line to get the power
-    // consumption of a given G5K node
-    std::string
-    getCmdLine(std::string hostname);
+    // Requests the power of all the probes of a site and fills the host map
+    // (called with _mutex held)
+    static bool
+    fetch(const std::string &site, G5kApi &api);
 
-    void
-    buildHostPduMap();
+    static void
+    buildHostMap();
+
+    // Full hostname of the node measured (node.site.grid5000.fr)
+    std::string _hostname;
+
+    // Site of the node
+    std::string _site;
 
-    // Connection string
-    std::string _cmd;
+    // Request of the site's API last used
+    unsigned int _seq;
 
-    // Maps the hostname into the PDU's IP and outlet number
-    static std::map<std::string, IpOut> _hostPduMap;
+    // Maps the hostname of the known G5K nodes into the power of the last
+    // request (W), -1 if unknown
+    static std::map<std::string, float> _hostMap;
 
-    // Flag that keeps the status of the hostPudMap
+    // Flag that keeps the status of the hostMap
     static bool _isMapBuilt;
 
+    // Maps the site into the connection to its metrology API
+    static std::map<std::string, G5kApi> _apiMap;
+
+    // Host and port of the API set by setApi(), empty for the default one
+    static std::string _apiHost;
+    static int _apiPort;
+
+    // Path of the probes' resource
+    static std::string _apiPath;
+
+    // Protects the maps, the meters being updated from several threads
+    static pthread_mutex_t _mutex;
+
     sensor_t _pValue;
   };
 }
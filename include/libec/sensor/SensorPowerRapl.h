@@ -0,0 +1,143 @@
+//============================================================================
+// Name        : SensorPowerRapl.h
+// Author      : Leandro Fontoura Cupertino
+// Version     : 0
+// Date        : 2013.09.02
+// Copyright   : Your copyright notice
+// Description : Power meter based on the RAPL energy counters
+//============================================================================
+
+#ifndef LIBEC_SENSOR_POWER_RAPL_H_
+#define LIBEC_SENSOR_POWER_RAPL_H_
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "SensorPower.h"
+
+/* Default directory of the powercap class */
+#define RAPL_POWERCAP_ROOT "/sys/class/powercap"
+
+namespace cea
+{
+  /// \brief A power meter based on the RAPL (Running Average Power Limit)
+  /// energy counters of the processor
+  ///
+  /// The RAPL domains are discovered under the powercap class
+  /// (/sys/class/powercap/intel-rapl:*), each one having a name file
+  /// ("package-0", "core", "uncore", "dram" or "psys") and an energy_uj
+  /// counter in micro joules. The counter files are kept open and read with
+  /// pread() at each update. The counters wrap around at
+  /// max_energy_range_uj, which is read once when the domain is opened.
+  ///
+  /// The power (P) of a domain is its energy over the elapsed time:
+  /// \f[ P = \frac{E_t - E_{t-1}}{t - (t-1)} \f]
+  ///
+  /// The machine's power is the sum of the package and dram domains (core
+  /// and uncore are parts of a package). When no package domain exists, the
+  /// psys domain (whole SoC) is used. The energy accumulated since the first
+  /// update is given in joules by getEnergy().
+  ///
+  /// The root of the powercap class can be given to the constructor, so that
+  /// the meter can be used on a fake sysfs tree.
+  class RaplPowerMeter : public PowerMeter
+  {
+  public:
+    /// Name of the class as a static parameter
+    static const char* ClassName;
+
+    /// RAPL domains
+    enum DomainType
+    {
+      Package = 0, Core = 1, Uncore = 2, Dram = 3, Psys = 4, Other = 5
+    };
+
+    /// Constructor
+    /// \param root Directory of the powercap class
+    RaplPowerMeter(const std::string &root = RAPL_POWERCAP_ROOT);
+
+    /// Constructor
+    /// \param xmlTag XML tag containing the parameters to load the sensor
+    /// \param root Directory of the powercap class
+    RaplPowerMeter(const std::string &xmlTag, const std::string &root);
+
+    ~RaplPowerMeter();
+
+    void
+    update();
+
+    sensor_t
+    getValue();
+
+    /// Gets the energy consumed by the machine since the first update
+    /// \returns The energy in joules
+    double
+    getEnergy();
+
+    /// Gets the number of RAPL domains found
+    unsigned int
+    getDomainCount();
+
+    /// Gets the name of a domain as given by the powercap class
+    /// (e.g. "package-0", "dram")
+    /// \param domain Domain position
+    std::string
+    getDomainName(unsigned int domain);
+
+    /// Gets the type of a domain
+    /// \param domain Domain position
+    DomainType
+    getDomainType(unsigned int domain);
+
+    /// Gets the package of a domain (-1 if it is not part of a package)
+    /// \param domain Domain position
+    int
+    getDomainPackage(unsigned int domain);
+
+    /// Gets the power of a domain during the last update
+    /// \param domain Domain position
+    /// \returns The power in watts
+    float
+    getDomainPower(unsigned int domain);
+
+    /// Gets the energy consumed by a domain since the first update
+    /// \param domain Domain position
+    /// \returns The energy in joules
+    double
+    getDomainEnergy(unsigned int domain);
+
+    /// \brief Get's the name of the class
+    const char*
+    getClassName();
+
+  private:
+    /// A RAPL domain
+    struct Domain
+    {
+      std::string name; ///< Name of the domain
+      DomainType type; ///< Type of the domain
+      int pkg; ///< Package of the domain
+      int fd; ///< energy_uj file descriptor
+      u64 maxRange; ///< Value where the counter wraps around (uJ), 0 if unknown
+      u64 raw; ///< Last value read (uJ)
+      u64 energy; ///< Energy since the first update (uJ)
+      float power; ///< Power of the last update (W)
+    };
+
+    /// Opens the domains found in the powercap class
+    bool
+    init(const std::string &root);
+
+    /// Reads a counter file, kept open
+    /// \returns False if the value could not be read
+    static bool
+    readCounter(int fd, u64 &value);
+
+    std::vector<Domain> _domains; ///< Domains opened
+    struct timespec _cTs; ///< Time of the last update (CLOCK_MONOTONIC)
+    bool _started; ///< True after the first update
+  };
+}
+
+#endif /* LIBEC_SENSOR_POWER_RAPL_H_ */
@@ -11,15 +11,92 @@
 #define LIBEC_SENSOR_POWER_RECS_H_
 
 #include "SensorPower.h"
+#include "../tools/TcpClient.h"
 
-#include <netinet/in.h>
-#include <netdb.h>
+#include <map>
+#include <string>
 
 namespace cea
 {
 #define LG_MAX_IP 15
 #define NB_MAX_NODES 18
 
+  /// \brief Connection to a RECS2(r) microcontroller shared by its nodes
+  ///
+  /// The microcontroller answers the state of all its baseboards to a single
+  /// request and accepts one connection at a time. A session is opened per
+  /// controller (ip and port) and shared by all the RecsPowerMeter of its
+  /// nodes: the connection is kept open between ticks and the answer is
+  /// parsed once per tick, then read by every node.
+  class RecsSession
+  {
+  public:
+    struct node
+    {
+      bool has_board; /// < Flag to determine if the board is plugged in the slot
+      bool status; /// < Flag to determine if the node is turned on or off
+      short temp; /// < Node's temperature in degrees Celsius (°C)
+      short power; /// < Node's power in Watts (W), -1 if the last poll failed
+    };
+
+    /// Gets the session of a controller, opening it if needed
+    /// \param ip Microcontroller's address
+    /// \param port Microcontroller's port
+    static RecsSession*
+    acquire(const std::string &ip, int port);
+
+    /// Releases a session got by acquire(), the last release closes it
+    static void
+    release(RecsSession* session);
+
+    /// Requests and parses the state of all the baseboards
+    /// \return False if the controller did not answer, the power of the
+    /// nodes is then -1
+    bool
+    poll();
+
+    /// Gets the number of answers parsed so far
+    unsigned int
+    getSeq() const;
+
+    /// Gets the state of a node
+    /// \param nodeId RECS2 node index (from 0 to 17)
+    const node&
+    getNode(int nodeId) const;
+
+    /// Gets the number of baseboards of the last answer
+    short
+    getBaseboardCount() const;
+
+    /// Gets the global voltage of the last answer
+    float
+    getVoltage() const;
+
+    /// Gets the number of connections opened to the controller
+    unsigned int
+    getConnectCount() const;
+
+    /// Gets the number of sessions opened
+    static unsigned int
+    getSessionCount();
+
+  private:
+    RecsSession(const std::string &ip, int port);
+
+    bool
+    parse(const std::string &answer);
+
+    TcpClient _tcp; ///< Connection to the microcontroller
+    std::string _in; ///< Bytes received and not parsed yet
+    unsigned int _users; ///< Number of meters using the session
+    unsigned int _seq; ///< Number of answers parsed
+    struct node _nodes[NB_MAX_NODES];
+    short _nrBaseboards; ///< Number of baseboards of the last answer
+    float _voltage; ///< Global voltage of the last answer
+
+    static std::map<std::string, RecsSession*> _sessions;
+  };
+
   /// \brief Christmann's RECS2(r) sensors
   ///
   /// Christmann's RECS2 18 nodes cluster has an extremely high packing density,
@@ -32,7 +109,8 @@ namespace cea
   /// to retrieve the temperature and power of each node. One must be aware
   /// that RECS2(r) microcontroller supports just one socket connection at a time
   /// if more than one request is made at the same time, a connection error event
-  /// will take place.
+  /// will take place. Hence all the meters of a controller share a single
+  /// RecsSession.
   class RecsPowerMeter : public PowerMeter
   {
   public:
@@ -52,6 +130,7 @@ namespace cea
 
     ~RecsPowerMeter();
 
+    /// Updates the power of the node, -1 if the controller did not answer
     void
     update();
 
@@ -78,33 +157,15 @@ namespace cea
     setParamsXml(const char* xmlTag);
 
   private:
-    struct node
-    {
-      bool has_board; /// < Flag to determine if the board is plugged in the slot
-      bool status; /// < Flag to determine if the node is turned on or off
-      short temp; /// < Node's temperature in degrees Celsius (°C)
-      short power; /// < Node's power in Watts (W)
-    };
-
-    /// Open socket connection with RECS2 microcontroller
-    bool
-    openConnection();
-
-    /// Close socket connection with RECS2 microcontroller
-    bool
-    closeConnection();
+    /// Joins the session of the controller
+    void
+    init();
 
     char _servIp[LG_MAX_IP + 1]; /// < server's ip address in the form xxx.xxx.xxx.xxx
     int _servPort; /// < RECS microcontroller port number
-    int _sockFd; /// < socket's file descriptor
     int _nodeId; /// < REC's node id
-    struct sockaddr_in _servAddr;
-    struct hostent *_server;
-    struct node _nodes[NB_MAX_NODES];
-
-    short nr_baseboards; /// < Total number of baseboards available
-
-    float global_voltage;
+    RecsSession* _session; /// < Session shared with the other nodes
+    unsigned int _seq; /// < Answer of the session last read
 
     sensor_t _pValue;
   };
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SensorScheduler.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Updates each sensor at its own rate
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SENSOR_SCHEDULER_H__
+#define SENSOR_SCHEDULER_H__
+
+#include <vector>
+
+#include "Sensor.h"
+
+namespace cea
+{
+
+  /// @brief Updates each sensor at its own rate
+  ///
+  /// Cheap counters (perf, RAPL) can be sampled at 100 Hz while the ACPI
+  /// battery, the temperature or an external PDU only change every few
+  /// seconds. Each sensor is updated with its own period (Sensor::getPeriod(),
+  /// or the default period of the scheduler if the sensor does not declare
+  /// one). The next deadline of each sensor is kept in a binary heap
+  /// (CLOCK_MONOTONIC, ns): run() sleeps until the earliest deadline with
+  /// clock_nanosleep(TIMER_ABSTIME), updates all the sensors due and appends
+  /// their samples, in time order, to a single stream.
+  ///
+  /// Deadlines are absolute, so the time spent updating does not drift the
+  /// rates. A sensor more than a period late skips the deadlines passed,
+  /// which are counted as missed.
+  ///
+  /// @code
+  /// cea::SensorScheduler sched(1000);
+  /// rapl->setPeriod(10);
+  /// sched.add(rapl);
+  /// sched.add(acpi); // default period: 1 s
+  /// std::vector<cea::SensorScheduler::Sample> samples;
+  /// sched.start();
+  /// while (running)
+  ///   {
+  ///     samples.clear();
+  ///     sched.run(samples);
+  ///     // samples of all the sensors due, merged in time order
+  ///   }
+  /// @endcode
+  class SensorScheduler
+  {
+  public:
+    /// @brief Sample of a sensor
+    struct Sample
+    {
+      u64 time; ///< Time of the update (CLOCK_MONOTONIC, ns)
+      unsigned int index; ///< Index of the sensor in the scheduler
+      Sensor* sensor; ///< Sensor updated
+      sensor_t value; ///< Value of the sensor
+    };
+
+    /// @brief Constructor
+    /// @param period Period of the sensors not declaring one (ms)
+    SensorScheduler(unsigned int period = 1000);
+
+    /// @brief Adds a sensor, not owned by the scheduler
+    /// @param sensor Sensor to update
+    /// @param period Period (ms), 0 for the one of the sensor
+    /// @return Index of the sensor
+    unsigned int
+    add(Sensor* sensor, unsigned int period = 0);
+
+    /// @brief Gets the number of sensors
+    unsigned int
+    size() const;
+
+    /// @brief Gets a sensor
+    Sensor*
+    getSensor(unsigned int index) const;
+
+    /// @brief Gets the period of a sensor (ms)
+    unsigned int
+    getPeriod(unsigned int index) const;
+
+    /// @brief Checks if the sensors have different periods
+    bool
+    isMultiRate() const;
+
+    /// @brief Schedules all the sensors, their first deadline being now
+    void
+    start();
+
+    /// @brief Schedules all the sensors from a given time
+    /// @param first First deadline of all the sensors (CLOCK_MONOTONIC, ns)
+    void
+    startAt(u64 first);
+
+    /// @brief Sleeps until the next deadline and updates the sensors due
+    /// @param samples Stream receiving the samples, in time order
+    /// @return Number of sensors updated
+    unsigned int
+    run(std::vector<Sample> &samples);
+
+    /// @brief Gets the deadline of the next update (CLOCK_MONOTONIC, ns)
+    u64
+    getDeadline() const;
+
+    /// @brief Gets the number of updates done
+    u64
+    getUpdates() const;
+
+    /// @brief Gets the number of deadlines skipped by late sensors
+    u64
+    getMissed() const;
+
+  private:
+    /// @brief Deadline of a sensor in the heap
+    struct Entry
+    {
+      u64 deadline; ///< Next update (ns)
+      unsigned int index; ///< Index of the sensor
+
+      bool
+      operator<(const Entry &e) const;
+    };
+
+    std::vector<Sensor*> _sensors; ///< Sensors scheduled
+    std::vector<u64> _periods; ///< Period of each sensor (ns)
+    std::vector<Entry> _heap; ///< Deadlines, earliest on top
+    u64 _period; ///< Default period (ns)
+    u64 _updates; ///< Number of updates done
+    u64 _missed; ///< Number of deadlines skipped
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::SensorScheduler
+///	@ingroup sensor
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SensorUpdater.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Updates sensors concurrently within a latency budget
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SENSOR_UPDATER_H__
+#define SENSOR_UPDATER_H__
+
+#include <vector>
+#include <deque>
+#include <pthread.h>
+
+#include "Sensor.h"
+
+namespace cea
+{
+  class PerfGroup;
+
+  /// @brief Updates sensors concurrently within a latency budget
+  ///
+  /// Updating the sensors one after the other makes a slow one (MSR, serial
+  /// meter, network counters) delay every reading after it. The updater runs
+  /// the updates on a small pool of worker threads and waits for them at
+  /// most the budget of the tick: the largest budget of its sensors.
+  ///
+  /// Each sensor has a latency budget (ms). An update taking longer than its
+  /// budget is counted as an overrun. A sensor whose update did not end
+  /// within the tick is stale: getValue() keeps its last value, and it is not
+  /// updated again before its pending update ends, so a hung sensor holds a
+  /// single worker.
+  ///
+  /// Sensors sharing a state (the counters of a perf group, the meters of
+  /// one RECS session) are not thread safe. Give them the same group: the
+  /// sensors of a group are updated one after the other by one worker. The
+  /// tick does not wait for the sum of their budgets: the sensors of a group
+  /// not updated within the budget of the tick are stale. addShared() finds
+  /// the group of the sensors of the library sharing a state.
+  ///
+  /// The values of the sensors must be read with getValue(), never from the
+  /// sensors themselves, which may still be updated by a worker.
+  ///
+  /// @code
+  /// cea::SensorUpdater updater(4, 100);
+  /// updater.add(cpu);
+  /// updater.add(msr, 20);
+  /// updater.add(pdu, 500);
+  /// while (running)
+  ///   {
+  ///     clock.wait();
+  ///     updater.update();
+  ///     for (unsigned int i = 0; i < updater.size(); i++)
+  ///       use(updater.getValue(i), updater.isStale(i));
+  ///   }
+  /// @endcode
+  class SensorUpdater
+  {
+  public:
+    /// @brief Constructor
+    /// @param threads Maximum number of worker threads
+    /// @param budget Budget of the sensors not given one (ms)
+    SensorUpdater(unsigned int threads = 4, unsigned int budget = 100);
+
+    /// @brief Destructor, waits for the updates running
+    ~SensorUpdater();
+
+    /// @brief Adds a sensor, not owned by the updater
+    /// @param sensor Sensor to update
+    /// @param budget Latency budget (ms), 0 for the default one
+    /// @param group Group of sensors updated in order, -1 for none
+    /// @return Index of the sensor
+    unsigned int
+    add(Sensor* sensor, unsigned int budget = 0, int group = -1);
+
+    /// @brief Adds a sensor in the group of the sensors it shares a state
+    /// with: the 4 Network sensors share the values of /proc/net/dev, the
+    /// events of a PerfGroup share the read of its counters. The groups are
+    /// negative, they do not mix with the ones given to add().
+    /// @param sensor Sensor to update
+    /// @param budget Latency budget (ms), 0 for the default one
+    /// @return Index of the sensor
+    unsigned int
+    addShared(Sensor* sensor, unsigned int budget = 0);
+
+    /// @brief Gets the number of sensors
+    unsigned int
+    size() const;
+
+    /// @brief Gets a sensor
+    Sensor*
+    getSensor(unsigned int index) const;
+
+    /// @brief Gets the latency budget of a sensor (ms)
+    unsigned int
+    getBudget(unsigned int index) const;
+
+    /// @brief Gets the number of worker threads
+    unsigned int
+    getThreads() const;
+
+    /// @brief Updates all the sensors and waits for them within the budget
+    /// @return Number of stale sensors
+    unsigned int
+    update();
+
+    /// @brief Gets the last value of a sensor
+    sensor_t
+    getValue(unsigned int index) const;
+
+    /// @brief Checks if a sensor was not updated in the last tick
+    bool
+    isStale(unsigned int index) const;
+
+    /// @brief Gets the duration of the last update of a sensor (ns)
+    u64
+    getLatency(unsigned int index) const;
+
+    /// @brief Gets the number of updates of a sensor over its budget
+    u64
+    getOverruns(unsigned int index) const;
+
+    /// @brief Gets the number of ticks a sensor was stale
+    u64
+    getStaleTicks(unsigned int index) const;
+
+    /// @brief Gets the number of ticks done
+    u64
+    getTicks() const;
+
+  private:
+    /// @brief Sensors updated in order by one worker
+    struct Job
+    {
+      std::vector<unsigned int> sensors; ///< Indexes of the sensors
+      u64 budget; ///< Largest budget of the sensors (ns)
+      u64 tick; ///< Tick the job was posted in
+      bool busy; ///< Posted and not ended yet
+    };
+
+    /// @brief State of a sensor, guarded by the mutex
+    struct Slot
+    {
+      Sensor* sensor; ///< Sensor updated
+      u64 budget; ///< Latency budget (ns)
+      int group; ///< Group of the sensor, -1 for none
+      sensor_t value; ///< Value after the last update
+      u64 latency; ///< Duration of the last update (ns)
+      u64 tick; ///< Tick of the last update ended
+      u64 overruns; ///< Updates over the budget
+      u64 staleTicks; ///< Ticks without update
+    };
+
+    std::vector<Slot> _slots;
+    std::vector<PerfGroup*> _perfGroups; ///< A sensor per PerfGroup added
+    std::vector<Job> _jobs;
+    std::deque<unsigned int> _queue; ///< Jobs posted, not taken yet
+    std::vector<pthread_t> _workers;
+    unsigned int _threads; ///< Maximum number of workers
+    u64 _budget; ///< Default budget (ns)
+    u64 _tick; ///< Current tick, from 1
+    unsigned int _pending; ///< Jobs of the current tick not ended
+    bool _stop;
+
+    mutable pthread_mutex_t _mutex;
+    pthread_cond_t _workCond; ///< Signals the workers a job is posted
+    pthread_cond_t _doneCond; ///< Signals the tick a job ended
+
+    /// @brief Groups the sensors into jobs and starts the workers
+    void
+    start();
+
+    /// @brief Stops the workers once their job ended
+    void
+    stop();
+
+    /// @brief Runs the jobs posted until the updater is destroyed
+    void
+    work();
+
+    static void*
+    runWorker(void* updater);
+
+    // not copyable: the workers point to the updater
+    SensorUpdater(const SensorUpdater&);
+    SensorUpdater&
+    operator=(const SensorUpdater&);
+  };
+
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+///	@class cea::SensorUpdater
+///	@ingroup sensor
+///////////////////////////////////////////////////////////////////////////////
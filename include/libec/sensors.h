@@ -17,15 +17,20 @@
 #include "sensor/FakeSensor.h"
 
 #include "sensor/SensorController.h"
+#include "sensor/SensorScheduler.h"
+#include "sensor/SensorUpdater.h"
 
 /* Unix sensors */
 #ifdef __unix__
 #include "sensor/SensorNetwork.h"
 #include "sensor/SensorPerfCount.h"
+#include "sensor/SensorPerfGroup.h"
+#include "sensor/SensorPerfCgroup.h"
 #include "sensor/SensorCpuFreq.h"
 #include "sensor/SensorCpuFreqMsr.h"
 #include "sensor/SensorCpuStateTime.h"
 #include "sensor/SensorCpuStateTimeElapsed.h"
+#include "sensor/SensorCpuIdleResidency.h"
 #include "sensor/SensorCpuStateMsr.h"
 #include "sensor/SensorCpuTemp.h"
 #include "sensor/SensorCpuUsage.h"
@@ -41,6 +46,8 @@
 #include "sensor/SensorPowerRecs.h"
 //#include "sensor/SensorPowerRecsTlse.h"
 #include "sensor/SensorPowerAcpi.h"
+#include "sensor/SensorPowerRapl.h"
+#include "sensor/SensorPowerAsync.h"
 #include "sensor/SensorPowerPlogg.h"
 #include "sensor/SensorPowerWattsUp.h"
 
@@ -15,9 +15,12 @@
 #include <libec/tools/Color.h>
 #include <libec/tools/Tools.h>
 #include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
 
 /* Containers */
 #include <libec/tools/containers/DoubleLinkedList.h>
+#include <libec/tools/containers/TimeSeriesRing.h>
+#include <libec/tools/containers/SampleRing.h>
 
 /* XML DOM parser */
 #include <libec/tools/XMLReader.h>
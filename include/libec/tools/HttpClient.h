@@ -0,0 +1,57 @@
+#ifndef LIBEC_HTTP_CLIENT_H__
+#define LIBEC_HTTP_CLIENT_H__
+
+#include <string>
+
+#include "TcpClient.h"
+
+namespace cea
+{
+  /// @brief Minimal HTTP/1.1 client keeping its connection alive
+  ///
+  /// Only GET is implemented. The connection is kept open between requests
+  /// (keep-alive) and opened again when the server closed it; a request
+  /// sent on a connection the server closed meanwhile is retried once on a
+  /// new one. Bodies sized by Content-Length, chunked or ended by the close
+  /// of the connection are supported.
+  class HttpClient
+  {
+  public:
+    /// @brief Constructor, the connection is opened on demand
+    /// @param host Server's host name or address
+    /// @param port Server's port
+    /// @param timeout Read/write timeout (ms)
+    HttpClient(const std::string &host = "", int port = 80,
+        unsigned int timeout = 1000);
+
+    /// @brief Sends a GET request and reads the answer
+    /// @param path Path of the resource (e.g. "/v1/probes/")
+    /// @param body String receiving the body of the answer
+    /// @param status If not NULL, receives the HTTP status code
+    /// @return False if no answer could be read
+    bool
+    get(const std::string &path, std::string &body, int* status = NULL);
+
+    /// @brief Gets the number of connections opened so far
+    unsigned int
+    getConnectCount() const;
+
+  private:
+    bool
+    request(const std::string &req, std::string &body, int* status);
+
+    bool
+    fill();
+
+    bool
+    readLine(std::string &line);
+
+    bool
+    readBytes(size_t len, std::string &out);
+
+    TcpClient _tcp; ///< Connection to the server
+    std::string _in; ///< Bytes received and not parsed yet
+  };
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef LIBEC_SAMPLING_CLOCK_H__
+#define LIBEC_SAMPLING_CLOCK_H__
+
+#include "../Globals.h"
+
+namespace cea
+{
+  /// @brief Periodic clock giving the sampling ticks
+  ///
+  /// The deadlines of the ticks are absolute times on CLOCK_MONOTONIC, one
+  /// period apart from the start: the time spent between two ticks does not
+  /// delay the following ones (no drift) and changes of the wall clock (NTP,
+  /// date) have no effect. wait() sleeps until the next deadline with
+  /// clock_nanosleep(TIMER_ABSTIME); isDue()/advance() let a loop that cannot
+  /// block check the deadline instead.
+  ///
+  /// When a tick comes more than a period late, the deadlines passed are
+  /// skipped rather than run in a burst, and counted as missed.
+  ///
+  /// @code
+  /// cea::SamplingClock clock(250000000ull); // 4 Hz
+  /// clock.start();
+  /// while (running)
+  ///   {
+  ///     u64 t = clock.wait();
+  ///     sample(t);
+  ///   }
+  /// std::cout << clock.getMissed() << " deadlines missed" << std::endl;
+  /// @endcode
+  class SamplingClock
+  {
+  public:
+    /// @brief Constructor
+    /// @param period Period of the ticks (ns)
+    SamplingClock(u64 period = 1000000000ull);
+
+    /// @brief Sets the period of the ticks, a running clock having its next
+    /// deadline brought forward to one period from now at the latest
+    /// @param period Period (ns)
+    void
+    setPeriod(u64 period);
+
+    /// @brief Gets the period of the ticks (ns)
+    u64
+    getPeriod() const;
+
+    /// @brief Starts the ticks, the first deadline is one period from now
+    void
+    start();
+
+    /// @brief Starts the ticks at a given time
+    /// @param first Deadline of the first tick (CLOCK_MONOTONIC, ns)
+    void
+    startAt(u64 first);
+
+    /// @brief Sleeps until the next deadline
+    /// @return The deadline of the tick (CLOCK_MONOTONIC, ns)
+    u64
+    wait();
+
+    /// @brief Checks if the next deadline has passed (never blocks)
+    bool
+    isDue() const;
+
+    /// @brief Moves to the next deadline if the current one has passed
+    /// @return True if a tick is due, the caller then runs it
+    bool
+    advance();
+
+    /// @brief Gets the deadline of the next tick (CLOCK_MONOTONIC, ns)
+    u64
+    getDeadline() const;
+
+    /// @brief Gets the number of ticks given
+    u64
+    getTicks() const;
+
+    /// @brief Gets the number of deadlines skipped because a tick came more
+    ///        than a period late
+    u64
+    getMissed() const;
+
+    /// @brief Gets the current time (CLOCK_MONOTONIC, ns)
+    static u64
+    now();
+
+  private:
+    /// @brief Ends the current tick and skips the deadlines already passed
+    void
+    next(u64 time);
+
+    u64 _period; ///< Period of the ticks (ns)
+    u64 _deadline; ///< Deadline of the next tick (ns), 0 if not started
+    u64 _ticks; ///< Number of ticks given
+    u64 _missed; ///< Number of deadlines skipped
+  };
+}
+
+#endif
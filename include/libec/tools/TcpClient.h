@@ -0,0 +1,77 @@
+#ifndef LIBEC_TCP_CLIENT_H__
+#define LIBEC_TCP_CLIENT_H__
+
+#include <string>
+#include <sys/types.h>
+
+namespace cea
+{
+  /// @brief TCP connection kept open between requests
+  ///
+  /// Power meters reached over the network (PDUs, RECS controllers) are read
+  /// at each tick. Keeping the connection open saves the handshake of a new
+  /// connection per sample. Reads and writes time out after the given delay,
+  /// so a device that stops answering does not block the caller forever.
+  class TcpClient
+  {
+  public:
+    /// @brief Constructor, the connection is opened on demand
+    /// @param host Host name or address
+    /// @param port TCP port
+    /// @param timeout Read/write timeout (ms)
+    TcpClient(const std::string &host = "", int port = 0,
+        unsigned int timeout = 1000);
+
+    ~TcpClient();
+
+    /// @brief Opens the connection if it is not opened yet
+    /// @return True if connected
+    bool
+    open();
+
+    /// @brief Closes the connection
+    void
+    close();
+
+    /// @brief Checks if the connection is opened
+    bool
+    isOpen() const;
+
+    /// @brief Sends a whole buffer
+    /// @return False on error, the connection is then closed
+    bool
+    send(const char* buf, size_t len);
+
+    /// @brief Receives at most len bytes
+    /// @return Number of bytes read, 0 if the peer closed the connection or
+    /// -1 on error or timeout (the connection is then closed)
+    ssize_t
+    recv(char* buf, size_t len);
+
+    /// @brief Gets the host
+    const std::string&
+    getHost() const;
+
+    /// @brief Gets the port
+    int
+    getPort() const;
+
+    /// @brief Gets the number of connections opened so far
+    unsigned int
+    getConnectCount() const;
+
+  private:
+    TcpClient(const TcpClient &client);
+
+    TcpClient&
+    operator=(const TcpClient &client);
+
+    std::string _host; ///< Host name or address
+    int _port; ///< TCP port
+    unsigned int _timeout; ///< Read/write timeout (ms)
+    int _fd; ///< Socket, -1 if closed
+    unsigned int _connects; ///< Number of connections opened
+  };
+}
+
+#endif
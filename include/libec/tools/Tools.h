@@ -189,8 +189,9 @@ namespace cea
     ///
     /// <h3>Return values</h3>
     ///     <ul>
-    ///         <li><b>UNIX platforms</b> == Current time expressed in
-    ///              milliseconds (man gettimeofday)</li>
+    ///         <li><b>UNIX platforms</b> == Number of milliseconds
+    ///              elapsed on CLOCK_MONOTONIC (man clock_gettime), not
+    ///              affected by changes of the wall clock</li>
     ///         <li><b>Windows platforms</b> == Number of milliseconds that
     ///             have elapsed since the system was started, up to 49.7
     ///             days. (see GetTickCount function on MSDN)</li>
@@ -289,7 +289,7 @@ namespace cea
         const char* attributeId, T& to)
     {
       std::string tagStr, tmpStr;
-      unsigned begin, end, pos;
+      std::string::size_type begin, end, pos;
       std::stringstream ss;
 
       tagStr = tag;
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SampleRing.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Lock-free ring of samples from one thread to another
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_SAMPLERING_H__
+#define LIBEC_SAMPLERING_H__
+
+#include <vector>
+
+#include "../../Globals.h"
+
+namespace cea
+{
+
+  /// @brief Lock-free ring of samples from one thread to another
+  ///
+  /// Hands binary sample records (a time, a tag and a fixed number of
+  /// sensor values) from a single producer thread, which samples the
+  /// sensors, to a single consumer thread, which formats and writes them.
+  /// Neither side takes a lock: the producer only moves the head and the
+  /// consumer the tail, each one publishing its index after a memory
+  /// barrier.
+  ///
+  /// When the ring is full, push() applies back-pressure: it waits for the
+  /// consumer at most the given time, then drops the record. The records
+  /// pushed, dropped and the pushes that had to wait are counted.
+  class SampleRing
+  {
+  public:
+    /// @brief Constructor
+    /// @param width Number of values of a record
+    /// @param capacity Minimum number of records, rounded up to a power of 2
+    SampleRing(unsigned int width, unsigned int capacity);
+
+    /// @brief Appends a record (producer thread)
+    /// @param time Time of the record
+    /// @param values Values of the record (width values)
+    /// @param tag Free value stored with the record
+    /// @param wait Time to wait for room if the ring is full (ns)
+    /// @return False if the record was dropped
+    bool
+    push(double time, const sensor_t* values, unsigned int tag = 0,
+        u64 wait = 0);
+
+    /// @brief Takes the oldest record (consumer thread)
+    /// @param time Receives the time of the record
+    /// @param values Receives the values of the record (width values)
+    /// @param tag Receives the tag of the record
+    /// @return False if the ring is empty
+    bool
+    pop(double &time, sensor_t* values, unsigned int &tag);
+
+    /// @brief Gets the number of records waiting
+    unsigned int
+    size() const;
+
+    /// @brief Gets the number of records the ring holds
+    unsigned int
+    getCapacity() const;
+
+    /// @brief Gets the number of values of a record
+    unsigned int
+    getWidth() const;
+
+    /// @brief Gets the number of records pushed
+    u64
+    getPushed() const;
+
+    /// @brief Gets the number of records dropped on a full ring
+    u64
+    getDropped() const;
+
+    /// @brief Gets the number of pushes that waited for room
+    u64
+    getWaits() const;
+
+    /// @brief Gets the largest number of records waiting at once
+    unsigned int
+    getHighWater() const;
+
+  private:
+    unsigned int _width; ///< Number of values of a record
+    unsigned int _mask; ///< Capacity - 1
+    std::vector<double> _times; ///< Times of the records
+    std::vector<unsigned int> _tags; ///< Tags of the records
+    std::vector<sensor_t> _values; ///< Values, record after record
+
+    volatile unsigned int _head; ///< Records pushed, written by the producer
+    volatile unsigned int _tail; ///< Records popped, written by the consumer
+
+    volatile u64 _pushed;
+    volatile u64 _dropped;
+    volatile u64 _waits;
+    volatile unsigned int _highWater;
+
+    // not copyable: the indexes are shared by two threads
+    SampleRing(const SampleRing&);
+    SampleRing&
+    operator=(const SampleRing&);
+  };
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		TimeSeriesRing.h
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Ring of timestamped rows of values
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef LIBEC_TIMESERIESRING_H__
+#define LIBEC_TIMESERIESRING_H__
+
+#include <vector>
+
+#include "../../Globals.h"
+
+namespace cea
+{
+
+  /// @brief Ring of timestamped rows of values
+  ///
+  /// Keeps the latest rows of a time series, each row holding a fixed number
+  /// of values read at the same time (e.g. the inputs of an estimator). When
+  /// the ring is full, a new row replaces the oldest one. Rows must be pushed
+  /// in time order. The values at any time covered by the ring are linearly
+  /// interpolated between the two rows around it, so that series sampled at
+  /// different moments (e.g. a power meter and the sensors of a model) can be
+  /// joined on their timestamps.
+  class TimeSeriesRing
+  {
+  public:
+    /// @brief Constructor
+    /// @param width Number of values of a row
+    /// @param capacity Maximum number of rows kept
+    TimeSeriesRing(unsigned int width, unsigned int capacity);
+
+    /// @brief Appends a row, dropping the oldest one if the ring is full
+    /// @param time Time of the row (e.g. CLOCK_MONOTONIC, ns)
+    /// @param values Values of the row (width values)
+    void
+    push(u64 time, const double* values);
+
+    /// @brief Gets the values at a given time
+    /// @param time Time of the values
+    /// @param values Receives the interpolated values (width values)
+    /// @return False if the time is out of the range of the ring
+    bool
+    interpolate(u64 time, double* values) const;
+
+    /// @brief Removes all the rows
+    void
+    clear();
+
+    /// @brief Gets the number of rows kept
+    unsigned int
+    size() const;
+
+    /// @brief Gets the number of values of a row
+    unsigned int
+    getWidth() const;
+
+    /// @brief Gets the time of the oldest row (0 if empty)
+    u64
+    getOldestTime() const;
+
+    /// @brief Gets the time of the latest row (0 if empty)
+    u64
+    getLatestTime() const;
+
+  private:
+    /// @brief Gets the index of a row in the buffers
+    /// @param row 0 for the oldest row
+    unsigned int
+    index(unsigned int row) const;
+
+    unsigned int _width; ///< Number of values of a row
+    unsigned int _capacity; ///< Maximum number of rows
+    unsigned int _first; ///< Index of the oldest row
+    unsigned int _size; ///< Number of rows kept
+    std::vector<u64> _times; ///< Times of the rows
+    std::vector<double> _values; ///< Values of the rows, row after row
+  };
+
+}
+
+#endif
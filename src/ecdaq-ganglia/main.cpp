@@ -16,12 +16,22 @@ main()
 
   if (pe->getStatus())
     {
+      // energy of the last minute, from the real time between the samples
+      cea::EnergyAccumulator acc(60000);
+
       while (true)
         {
+          pe->update();
+          acc.addSample(cea::PowerMeter::now(), pe->getValue(-1).Float);
+
           std::ofstream ofs("/var/tmp/ecdaq-ganglia.out");
           ofs << pe->getValue(-1).Float << std::endl;
           ofs.close();
 
+          std::ofstream eofs("/var/tmp/ecdaq-ganglia-energy.out");
+          eofs << acc.getWindowEnergy() << std::endl;
+          eofs.close();
+
 //          std::cout << "pe: " << pe->getValue(-1).Float << "\tcpu: "
 //              << cpu->getValue(-1).Float << std::endl;
 
@@ -27,7 +27,11 @@ usageMessage()
       << std::endl;
   std::cout << "  -i <time>                  "
       << "idle time (in seconds) to collect data before "
-      << "and after the execution of a benchmark." << std::endl << std::endl;
+      << "and after the execution of a benchmark." << std::endl;
+  std::cout << "  -t <threads>               "
+      << "update the sensors concurrently on a pool of threads, "
+      << "a row being written on time even if some sensors are late."
+      << std::endl << std::endl;
 }
 
 int
@@ -36,6 +40,7 @@ main(int argc, char *argv[])
   char* bench;
   std::string outfile = "ecdaq.log";
   int idleTime = 0;
+  int threads = 0;
 
   if (argc == 1)
     {
@@ -57,6 +62,10 @@ main(int argc, char *argv[])
     if (!strcmp(argv[i], "-i"))
       idleTime = atoi(argv[i + 1]);
 
+  for (int i = 1; i < argc; i += 2)
+    if (!strcmp(argv[i], "-t"))
+      threads = atoi(argv[i + 1]);
+
   bench = argv[argc - 1];
 
   //Run the data acquisition in verbose mode
@@ -65,6 +74,8 @@ main(int argc, char *argv[])
 
   std::cout << "Data Acquisition ... [start]\n";
   cea::DataAcquisition daq(bench, idleTime, 1.0, outfile);
+  if (threads > 0)
+    daq.setUpdateThreads(threads);
 
   //Collect data from specific sensors
 //  daq.addSensor(new cea::CpuTimeUsage);
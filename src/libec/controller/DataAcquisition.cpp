@@ -13,9 +13,11 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include <libec/device/SystemInfo.h>
 #include <libec/DataAcquisition.h>
+#include <libec/tools/DebugLog.h>
 
 namespace cea
 {
@@ -25,6 +27,8 @@ namespace cea
     _benchCmd = bench;
     setFrequency(freq);
     setIdleTime(idleTime);
+    setUpdateThreads(0);
+    _ring = NULL;
 
     _logFile.clear();
     _logFile.set(FileLog(logfilename, true), GnuplotFormat());
@@ -40,6 +44,7 @@ namespace cea
     for (std::list<cea::Sensor*>::iterator it = _sensors.begin();
         it != _sensors.end(); it++)
       delete (*it);
+    delete _ring;
   }
 
   void
@@ -49,11 +54,30 @@ namespace cea
     time_t start_time;
     struct timeval tv;
     Sensor* s;
+    std::vector<sensor_t> values;
 
     if (_sensors.empty())
       getAvailableSensors(_sensors);
 
-    logHeader(_sensors);
+    // sensors declaring their own period are sampled at their rate
+    SensorScheduler scheduler(_clock.getPeriod() / 1000000ull);
+    for (std::list<Sensor*>::iterator it = _sensors.begin();
+        it != _sensors.end(); it++)
+      scheduler.add(*it);
+
+    // the rows of a parallel update count the sensors late for the tick
+    bool parallel = (_updateThreads > 0) && !scheduler.isMultiRate();
+    logHeader(_sensors, parallel);
+
+    // by default, a sensor may take half a period before being late
+    unsigned int budget = _updateBudget;
+    if (budget == 0)
+      budget = _clock.getPeriod() / 2000000ull;
+    SensorUpdater updater(_updateThreads, budget);
+
+    // the rows are written by another thread, not to delay the samples
+    values.resize(_sensors.size());
+    startWriter(scheduler.isMultiRate(), parallel);
 
     // The first time a sensor is updated its value don't have meaning
     for (std::list<Sensor*>::iterator it = _sensors.begin();
@@ -64,6 +88,11 @@ namespace cea
       }
 //    sleep(1);
 
+    if (parallel)
+      for (std::list<Sensor*>::iterator it = _sensors.begin();
+          it != _sensors.end(); it++)
+        updater.addShared(*it);
+
     start_time = time(NULL);
 
     if (_benchCmd != NULL)
@@ -85,33 +114,35 @@ namespace cea
     _isBenchRunning = true;
 
     // Keep collecting the data while benchmark is running
-    // wait a while to start the experiment on the precise second
+    // the first tick is on the precise second, the next ones are one period
+    // apart on the monotonic clock
     gettimeofday(&tv, NULL);
-    usleep(1000000 - tv.tv_usec);
+    u64 first = SamplingClock::now() + (1000000 - tv.tv_usec) * 1000ull;
+    _clock.startAt(first);
 
-    while (_isBenchRunning)
+    if (scheduler.isMultiRate())
+      collectMultiRate(scheduler, first);
+    else if (parallel)
+      collectParallel(updater);
+
+    while (_isBenchRunning && !scheduler.isMultiRate() && !parallel)
       {
-        _outFile.openBlock("");
-        _outFile.write(time(NULL));
+        _clock.wait();
 
+        unsigned int i = 0;
         for (std::list<Sensor*>::iterator it = _sensors.begin();
             it != _sensors.end(); it++)
           {
             s = *it;
             s->update();
-
-            if (s->getType() == U64)
-              _outFile.write(s->getValue().U64);
-            else
-              _outFile.write(s->getValue().Float);
+            values[i++] = s->getValue();
           }
-        _outFile.closeBlock("");
-        _outFile.update();
-
-        gettimeofday(&tv, NULL);
-        usleep(_periodTime * 1000000 - tv.tv_usec);
+        pushRow(time(NULL), values, 0);
       }
 
+    // the rows left are written before the summary
+    stopWriter();
+
     // Log benchmark data
     _logFile.addComment("");
     _logFile.addComment("Benchmark summary");
@@ -124,12 +155,186 @@ namespace cea
     _ss.str("");
     _ss << "  End time:          \t" << _benchEnd;
     _logFile.addComment(_ss.str());
+    _ss.str("");
+    if (scheduler.isMultiRate())
+      _ss << "  Missed deadlines:  \t" << scheduler.getMissed() << " of "
+          << scheduler.getUpdates() + scheduler.getMissed();
+    else
+      _ss << "  Missed deadlines:  \t" << _clock.getMissed() << " of "
+          << _clock.getTicks() + _clock.getMissed();
+    _logFile.addComment(_ss.str());
+    for (unsigned int i = 0; i < updater.size(); i++)
+      {
+        if (updater.getStaleTicks(i) == 0)
+          continue;
+
+        _ss.str("");
+        _ss << "  Stale " << updater.getSensor(i)->getAlias() << ":     \t"
+            << updater.getStaleTicks(i) << " of " << updater.getTicks()
+            << " (budget " << updater.getBudget(i) << " ms)";
+        _logFile.addComment(_ss.str());
+      }
+    _ss.str("");
+    _ss << "  Dropped samples:   \t" << _ring->getDropped() << " of "
+        << _ring->getPushed() + _ring->getDropped() << " (waits "
+        << _ring->getWaits() << ", max queued " << _ring->getHighWater()
+        << ")";
+    _logFile.addComment(_ss.str());
     _logFile.update();
 
     _outFile.flush();
     _logFile.flush();
   }
 
+  void
+  DataAcquisition::collectMultiRate(SensorScheduler &scheduler, u64 first)
+  {
+    std::vector<SensorScheduler::Sample> samples;
+    std::vector<sensor_t> values(scheduler.size());
+    struct timeval tv;
+
+    // wall clock time of the monotonic clock's origin, to date the samples
+    gettimeofday(&tv, NULL);
+    double origin = tv.tv_sec + tv.tv_usec / 1e6
+        - SamplingClock::now() / 1e9;
+
+    for (unsigned int i = 0; i < scheduler.size(); i++)
+      values[i] = scheduler.getSensor(i)->getValue();
+
+    // a row each time sensors are sampled, with the last value of the others
+    scheduler.startAt(first);
+    while (_isBenchRunning)
+      {
+        samples.clear();
+        if (scheduler.run(samples) == 0)
+          continue;
+
+        for (unsigned int i = 0; i < samples.size(); i++)
+          values[samples[i].index] = samples[i].value;
+
+        pushRow(origin + samples.back().time / 1e9, values, 0);
+      }
+  }
+
+  void
+  DataAcquisition::collectParallel(SensorUpdater &updater)
+  {
+    std::vector<sensor_t> values(updater.size());
+
+    // a row each tick, with the last value of the sensors late
+    while (_isBenchRunning)
+      {
+        _clock.wait();
+        unsigned int stale = updater.update();
+
+        for (unsigned int i = 0; i < updater.size(); i++)
+          values[i] = updater.getValue(i);
+        pushRow(time(NULL), values, stale);
+      }
+  }
+
+  void
+  DataAcquisition::startWriter(bool fractional, bool stale)
+  {
+    delete _ring;
+    _ring = new SampleRing(_sensors.size(), DAQ_RING_SIZE);
+
+    _types.clear();
+    for (std::list<Sensor*>::iterator it = _sensors.begin();
+        it != _sensors.end(); it++)
+      _types.push_back((*it)->getType());
+    _isFractional = fractional;
+    _hasStale = stale;
+
+    _isWriting = true;
+    _hasWriter = (pthread_create(&_writer, NULL, runWriter, this) == 0);
+    if (!_hasWriter)
+      DebugLog::writeMsg(DebugLog::WARNING, "DataAcquisition::startWriter()",
+          "The writer thread could not be created, rows written in turn");
+  }
+
+  void
+  DataAcquisition::stopWriter()
+  {
+    _isWriting = false;
+    if (_hasWriter)
+      pthread_join(_writer, NULL);
+    _hasWriter = false;
+
+    writeRows();
+  }
+
+  void
+  DataAcquisition::pushRow(double time, const std::vector<sensor_t> &values,
+      unsigned int stale)
+  {
+    // back-pressure: a full ring may delay a sample by a tenth of a period
+    _ring->push(time, &values[0], stale, _clock.getPeriod() / 10);
+
+    if (!_hasWriter)
+      writeRows();
+  }
+
+  void
+  DataAcquisition::writeRows()
+  {
+    std::vector<sensor_t> values(_ring->getWidth());
+    unsigned int stale;
+    double time;
+
+    while (_ring->pop(time, &values[0], stale))
+      {
+        _outFile.openBlock("");
+        if (_isFractional)
+          _outFile.write(time);
+        else
+          _outFile.write((time_t) time);
+
+        for (unsigned int i = 0; i < _types.size(); i++)
+          {
+            if (_types[i] == U64)
+              _outFile.write(values[i].U64);
+            else
+              _outFile.write(values[i].Float);
+          }
+        if (_hasStale)
+          _outFile.write(stale);
+        _outFile.closeBlock("");
+        _outFile.update();
+      }
+  }
+
+  void*
+  DataAcquisition::runWriter(void* data)
+  {
+    DataAcquisition* da = (DataAcquisition*) data;
+    struct timespec ts;
+
+    ts.tv_sec = 0;
+    ts.tv_nsec = 10000000; // 10 ms
+
+    // the rows pushed before the end of the sampling are all written
+    while (true)
+      {
+        bool writing = da->_isWriting;
+        __sync_synchronize();
+
+        da->writeRows();
+        if (!writing)
+          break;
+        nanosleep(&ts, NULL);
+      }
+
+    return NULL;
+  }
+
+  void
+  DataAcquisition::setUpdateThreads(unsigned int threads, unsigned int budget)
+  {
+    _updateThreads = threads;
+    _updateBudget = budget;
+  }
+
   void
   DataAcquisition::loadAvailableSensors()
   {
@@ -198,9 +403,17 @@ namespace cea
         newSensor = new PerfCount(PERF_TYPE_HARDWARE, perf_hw_id);
         nPC += addSensor(&sensors, newSensor);
       }
+
+    // Software counters are read as a single group (one read per CPU)
+    std::vector<PerfGroup::Event> swEvents;
     for (int perf_sw_id = 0; perf_sw_id < PERF_COUNT_SW_MAX; perf_sw_id++)
+      swEvents.push_back(PerfGroup::Event(PERF_TYPE_SOFTWARE, perf_sw_id));
+
+    PerfGroup* swGroup = new PerfGroup(swEvents);
+    nPC += addSensor(&sensors, swGroup);
+    for (unsigned int m = 1; m < swGroup->getMemberCount(); m++)
       {
-        newSensor = new PerfCount(PERF_TYPE_SOFTWARE, perf_sw_id);
+        newSensor = new PerfGroup(*swGroup, m);
         nPC += addSensor(&sensors, newSensor);
       }
 
@@ -252,12 +465,14 @@ namespace cea
         newSensor = new CpuStateMsr(c);
         nCPU += addSensor(&sensors, newSensor);
 
-        int nstates = CpuStateTime::getNumberofStates();
-        for (int s = 0; s < nstates; s++)
+        // the shares of all the CPUs and states cost one pass per tick
+        CpuIdleResidency* residency = CpuIdleResidency::acquire();
+        for (int s = -1; s < (int) residency->getStateCount(); s++)
           {
-            newSensor = new CpuStateTimeElapsed(s, c);
+            newSensor = new CpuIdleShare(c, s);
             nCPU += addSensor(&sensors, newSensor);
           }
+        CpuIdleResidency::release(residency);
       }
 
     newSensor = new MemRss;
@@ -267,12 +482,16 @@ namespace cea
     nCPU += addSensor(&sensors, newSensor);
 
     // Power sensors
-    newSensor = new G5kPowerMeter();
+    // G5k's API is slow to answer, it is polled on its own thread
+    newSensor = new AsyncPowerMeter(new G5kPowerMeter());
     nPow += addSensor(&sensors, newSensor);
 
     newSensor = new AcpiPowerMeter();
     nPow += addSensor(&sensors, newSensor);
 
+    newSensor = new RaplPowerMeter();
+    nPow += addSensor(&sensors, newSensor);
+
 //    newSensor = new RecsPowerMeter("192.168.0.250", 10001, 13);
 //    nPow += addSensor(&sensors, newSensor);
 
@@ -310,7 +529,7 @@ namespace cea
   void
   DataAcquisition::setFrequency(float freq)
   {
-    _periodTime = 1 / freq;
+    _clock.setPeriod((u64) (1e9 / freq));
   }
 
   void
@@ -347,7 +566,7 @@ namespace cea
   }
 
   void
-  DataAcquisition::logHeader(std::list<Sensor*> sensor)
+  DataAcquisition::logHeader(std::list<Sensor*> sensor, bool stale)
   {
     _outFile.openBlock("");
     _outFile.write("TS");
@@ -358,6 +577,8 @@ namespace cea
         Sensor* s = *it;
         _outFile.write(s->getAlias());
       }
+    if (stale)
+      _outFile.write("STALE");
     _outFile.closeBlock("");
   }
 
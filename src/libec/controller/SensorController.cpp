@@ -39,6 +39,8 @@ namespace cea
       sensor = new RecsPowerMeter();
     else if (classname == G5kPowerMeter::ClassName)
       sensor = new G5kPowerMeter();
+    else if (classname == RaplPowerMeter::ClassName)
+      sensor = new RaplPowerMeter();
     else if (classname == CpuTime::ClassName)
       sensor = new CpuTime();
 
@@ -122,6 +124,8 @@ namespace cea
               sensor = new RecsPowerMeter(sensorXmlTag);
             else if (classname == G5kPowerMeter::ClassName)
               sensor = new G5kPowerMeter(sensorXmlTag);
+            else if (classname == RaplPowerMeter::ClassName)
+              sensor = new RaplPowerMeter(sensorXmlTag, RAPL_POWERCAP_ROOT);
             else if (classname == CpuTime::ClassName)
               sensor = new CpuTime(sensorXmlTag);
           }
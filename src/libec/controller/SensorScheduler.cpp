@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <ctime>
+#include <cerrno>
+
+#include <libec/sensor/SensorScheduler.h>
+#include <libec/tools/SamplingClock.h>
+
+namespace cea
+{
+
+  bool
+  SensorScheduler::Entry::operator<(const Entry &e) const
+  {
+    // std::push_heap keeps the greatest on top: the earliest deadline
+    if (deadline != e.deadline)
+      return deadline > e.deadline;
+    return index > e.index;
+  }
+
+  SensorScheduler::SensorScheduler(unsigned int period) :
+      _period((u64) ((period > 0) ? period : 1) * 1000000ull), _updates(0),
+          _missed(0)
+  {
+  }
+
+  unsigned int
+  SensorScheduler::add(Sensor* sensor, unsigned int period)
+  {
+    if (period == 0)
+      period = sensor->getPeriod();
+
+    _sensors.push_back(sensor);
+    _periods.push_back((period > 0) ? (u64) period * 1000000ull : _period);
+
+    return _sensors.size() - 1;
+  }
+
+  unsigned int
+  SensorScheduler::size() const
+  {
+    return _sensors.size();
+  }
+
+  Sensor*
+  SensorScheduler::getSensor(unsigned int index) const
+  {
+    return _sensors[index];
+  }
+
+  unsigned int
+  SensorScheduler::getPeriod(unsigned int index) const
+  {
+    return _periods[index] / 1000000ull;
+  }
+
+  bool
+  SensorScheduler::isMultiRate() const
+  {
+    for (unsigned int i = 1; i < _periods.size(); i++)
+      if (_periods[i] != _periods[0])
+        return true;
+    return false;
+  }
+
+  void
+  SensorScheduler::start()
+  {
+    startAt(SamplingClock::now());
+  }
+
+  void
+  SensorScheduler::startAt(u64 first)
+  {
+    Entry e;
+
+    _heap.clear();
+    for (unsigned int i = 0; i < _sensors.size(); i++)
+      {
+        e.deadline = first;
+        e.index = i;
+        _heap.push_back(e);
+      }
+    std::make_heap(_heap.begin(), _heap.end());
+  }
+
+  unsigned int
+  SensorScheduler::run(std::vector<Sample> &samples)
+  {
+    struct timespec ts;
+    unsigned int count = 0;
+
+    if (_heap.empty())
+      return 0;
+
+    u64 deadline = _heap.front().deadline;
+    ts.tv_sec = deadline / 1000000000ull;
+    ts.tv_nsec = deadline % 1000000000ull;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+      ;
+
+    // update every sensor due, earliest deadline first
+    u64 now = SamplingClock::now();
+    while (_heap.front().deadline <= now)
+      {
+        std::pop_heap(_heap.begin(), _heap.end());
+        Entry &e = _heap.back();
+        Sensor* s = _sensors[e.index];
+
+        s->update();
+
+        Sample sample;
+        sample.time = SamplingClock::now();
+        sample.index = e.index;
+        sample.sensor = s;
+        sample.value = s->getValue();
+        samples.push_back(sample);
+        count++;
+
+        // next deadline, skipping the ones already passed
+        u64 period = _periods[e.index];
+        e.deadline += period;
+        if (e.deadline <= sample.time)
+          {
+            u64 skipped = (sample.time - e.deadline) / period + 1;
+            _missed += skipped;
+            e.deadline += skipped * period;
+          }
+        std::push_heap(_heap.begin(), _heap.end());
+      }
+
+    _updates += count;
+    return count;
+  }
+
+  u64
+  SensorScheduler::getDeadline() const
+  {
+    return _heap.empty() ? 0 : _heap.front().deadline;
+  }
+
+  u64
+  SensorScheduler::getUpdates() const
+  {
+    return _updates;
+  }
+
+  u64
+  SensorScheduler::getMissed() const
+  {
+    return _missed;
+  }
+
+}
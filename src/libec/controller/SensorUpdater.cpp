@@ -0,0 +1,341 @@
+#include <ctime>
+#include <cerrno>
+#include <map>
+
+#include <libec/sensor/SensorUpdater.h>
+#include <libec/sensor/SensorNetwork.h>
+#include <libec/sensor/SensorPerfGroup.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/tools/DebugLog.h>
+
+namespace cea
+{
+
+  SensorUpdater::SensorUpdater(unsigned int threads, unsigned int budget) :
+      _threads((threads > 0) ? threads : 1), _budget(
+          (u64) ((budget > 0) ? budget : 1) * 1000000ull), _tick(0), _pending(
+          0), _stop(false)
+  {
+    pthread_condattr_t attr;
+
+    // timeouts are not affected by changes of the wall clock
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_doneCond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_cond_init(&_workCond, NULL);
+    pthread_mutex_init(&_mutex, NULL);
+  }
+
+  SensorUpdater::~SensorUpdater()
+  {
+    stop();
+    pthread_cond_destroy(&_doneCond);
+    pthread_cond_destroy(&_workCond);
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  unsigned int
+  SensorUpdater::add(Sensor* sensor, unsigned int budget, int group)
+  {
+    Slot slot;
+
+    // the jobs are grouped again on the next update
+    stop();
+
+    slot.sensor = sensor;
+    slot.budget = (budget > 0) ? (u64) budget * 1000000ull : _budget;
+    slot.group = group;
+    slot.value = sensor->getValue();
+    slot.latency = 0;
+    slot.tick = _tick;
+    slot.overruns = 0;
+    slot.staleTicks = 0;
+    _slots.push_back(slot);
+
+    return _slots.size() - 1;
+  }
+
+  unsigned int
+  SensorUpdater::addShared(Sensor* sensor, unsigned int budget)
+  {
+    // -1 is no group: Network is -2, the PerfGroups -3 and below
+    if (dynamic_cast<Network*>(sensor) != NULL)
+      return add(sensor, budget, -2);
+
+    PerfGroup* pg = dynamic_cast<PerfGroup*>(sensor);
+    if (pg == NULL)
+      return add(sensor, budget);
+
+    unsigned int g = 0;
+    while ((g < _perfGroups.size()) && !_perfGroups[g]->isSameGroup(*pg))
+      g++;
+    if (g == _perfGroups.size())
+      _perfGroups.push_back(pg);
+
+    return add(sensor, budget, -3 - (int) g);
+  }
+
+  unsigned int
+  SensorUpdater::size() const
+  {
+    return _slots.size();
+  }
+
+  Sensor*
+  SensorUpdater::getSensor(unsigned int index) const
+  {
+    return _slots[index].sensor;
+  }
+
+  unsigned int
+  SensorUpdater::getBudget(unsigned int index) const
+  {
+    return _slots[index].budget / 1000000ull;
+  }
+
+  unsigned int
+  SensorUpdater::getThreads() const
+  {
+    return _workers.size();
+  }
+
+  void
+  SensorUpdater::start()
+  {
+    std::map<int, unsigned int> groups;
+    std::map<int, unsigned int>::iterator it;
+
+    _jobs.clear();
+    for (unsigned int i = 0; i < _slots.size(); i++)
+      {
+        unsigned int j = _jobs.size();
+
+        if (_slots[i].group != -1)
+          {
+            it = groups.find(_slots[i].group);
+            if (it != groups.end())
+              j = it->second;
+            else
+              groups[_slots[i].group] = j;
+          }
+
+        if (j == _jobs.size())
+          {
+            Job job;
+            job.budget = 0;
+            job.tick = 0;
+            job.busy = false;
+            _jobs.push_back(job);
+          }
+        // the tick waits the largest budget of a sensor, not the sum of a
+        // group: a long group is reported stale instead of holding the tick
+        _jobs[j].sensors.push_back(i);
+        if (_slots[i].budget > _jobs[j].budget)
+          _jobs[j].budget = _slots[i].budget;
+      }
+
+    // no more workers than jobs
+    unsigned int threads = (_threads < _jobs.size()) ? _threads : _jobs.size();
+    for (unsigned int i = 0; i < threads; i++)
+      {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, runWorker, this) != 0)
+          {
+            DebugLog::writeMsg(DebugLog::WARNING, "SensorUpdater::start()",
+                "Could not start worker %u", i);
+            break;
+          }
+        _workers.push_back(thread);
+      }
+  }
+
+  void
+  SensorUpdater::stop()
+  {
+    if (_workers.empty())
+      return;
+
+    pthread_mutex_lock(&_mutex);
+    _stop = true;
+    pthread_cond_broadcast(&_workCond);
+    pthread_mutex_unlock(&_mutex);
+
+    for (unsigned int i = 0; i < _workers.size(); i++)
+      pthread_join(_workers[i], NULL);
+
+    _workers.clear();
+    _queue.clear();
+    _pending = 0;
+    _stop = false;
+  }
+
+  unsigned int
+  SensorUpdater::update()
+  {
+    struct timespec deadline;
+    std::vector<unsigned int> late;
+    unsigned int stale = 0;
+    u64 budget = 0;
+    int err = 0;
+
+    if (_slots.empty())
+      return 0;
+
+    if (_workers.empty())
+      start();
+
+    pthread_mutex_lock(&_mutex);
+    _tick++;
+    _pending = 0;
+
+    // a job still running from a previous tick is not posted again
+    for (unsigned int j = 0; j < _jobs.size(); j++)
+      {
+        Job &job = _jobs[j];
+        if (job.busy)
+          continue;
+
+        job.busy = true;
+        job.tick = _tick;
+        _queue.push_back(j);
+        _pending++;
+        if (job.budget > budget)
+          budget = job.budget;
+      }
+    pthread_cond_broadcast(&_workCond);
+
+    u64 end = SamplingClock::now() + budget;
+    deadline.tv_sec = end / 1000000000ull;
+    deadline.tv_nsec = end % 1000000000ull;
+    while ((_pending > 0) && (err != ETIMEDOUT))
+      err = pthread_cond_timedwait(&_doneCond, &_mutex, &deadline);
+
+    for (unsigned int i = 0; i < _slots.size(); i++)
+      {
+        Slot &slot = _slots[i];
+        if (slot.tick == _tick)
+          continue;
+
+        stale++;
+        if (slot.staleTicks++ == 0)
+          late.push_back(i);
+      }
+    pthread_mutex_unlock(&_mutex);
+
+    for (unsigned int i = 0; i < late.size(); i++)
+      DebugLog::writeMsg(DebugLog::WARNING, "SensorUpdater::update()",
+          "%s overran its budget of %u ms", getSensor(late[i])->getAlias().c_str(),
+          getBudget(late[i]));
+
+    return stale;
+  }
+
+  sensor_t
+  SensorUpdater::getValue(unsigned int index) const
+  {
+    pthread_mutex_lock(&_mutex);
+    sensor_t value = _slots[index].value;
+    pthread_mutex_unlock(&_mutex);
+
+    return value;
+  }
+
+  bool
+  SensorUpdater::isStale(unsigned int index) const
+  {
+    pthread_mutex_lock(&_mutex);
+    bool stale = (_slots[index].tick != _tick);
+    pthread_mutex_unlock(&_mutex);
+
+    return stale;
+  }
+
+  u64
+  SensorUpdater::getLatency(unsigned int index) const
+  {
+    pthread_mutex_lock(&_mutex);
+    u64 latency = _slots[index].latency;
+    pthread_mutex_unlock(&_mutex);
+
+    return latency;
+  }
+
+  u64
+  SensorUpdater::getOverruns(unsigned int index) const
+  {
+    pthread_mutex_lock(&_mutex);
+    u64 overruns = _slots[index].overruns;
+    pthread_mutex_unlock(&_mutex);
+
+    return overruns;
+  }
+
+  u64
+  SensorUpdater::getStaleTicks(unsigned int index) const
+  {
+    pthread_mutex_lock(&_mutex);
+    u64 ticks = _slots[index].staleTicks;
+    pthread_mutex_unlock(&_mutex);
+
+    return ticks;
+  }
+
+  u64
+  SensorUpdater::getTicks() const
+  {
+    return _tick;
+  }
+
+  void
+  SensorUpdater::work()
+  {
+    pthread_mutex_lock(&_mutex);
+    while (true)
+      {
+        while (_queue.empty() && !_stop)
+          pthread_cond_wait(&_workCond, &_mutex);
+        if (_stop)
+          break;
+
+        Job &job = _jobs[_queue.front()];
+        _queue.pop_front();
+
+        // the sensors are updated out of the lock, their state is kept in it
+        for (unsigned int k = 0; k < job.sensors.size(); k++)
+          {
+            Slot &slot = _slots[job.sensors[k]];
+            Sensor* s = slot.sensor;
+            pthread_mutex_unlock(&_mutex);
+
+            u64 time = SamplingClock::now();
+            s->update();
+            sensor_t value = s->getValue();
+            time = SamplingClock::now() - time;
+
+            pthread_mutex_lock(&_mutex);
+            slot.value = value;
+            slot.latency = time;
+            slot.tick = job.tick;
+            if (time > slot.budget)
+              slot.overruns++;
+          }
+
+        job.busy = false;
+        if (job.tick == _tick)
+          {
+            _pending--;
+            pthread_cond_signal(&_doneCond);
+          }
+      }
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  void*
+  SensorUpdater::runWorker(void* updater)
+  {
+    ((SensorUpdater*) updater)->work();
+    return NULL;
+  }
+
+}
@@ -14,6 +14,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/types.h>
@@ -21,6 +22,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <set>
 
 namespace cea
 {
@@ -291,19 +293,66 @@ namespace cea
 //      }
   }
 
+  void
+  CpuInfo::readTopology(Processor *proc)
+  {
+    // Offline CPUs may have no topology directory, they are kept in the
+    // list (so that processors are indexed by their id) with unknown ids
+    proc->pkg = proc->core = -1;
+
+    //Package ID
+    if (topologyReadFile(proc->id, "physical_package_id", &(proc->pkg)) < 0)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "CpuInfo::readTopology()",
+            "The 'topology/physical_package_id' file of cpu%d could not be "
+                "read", proc->id);
+        proc->pkg = -1;
+        return;
+      }
+
+    // Core ID
+    if (topologyReadFile(proc->id, "core_id", &(proc->core)) < 0)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "CpuInfo::readTopology()",
+            "The 'topology/core_id' file of cpu%d could not be read",
+            proc->id);
+        proc->core = -1;
+      }
+  }
+
+  void
+  CpuInfo::countTopology()
+  {
+    // core ids are only unique inside a package
+    std::set<int> pkgs;
+    std::set<std::pair<int, int> > cores;
+
+    for (unsigned int cpu = 0; cpu < _processors.size(); cpu++)
+      {
+        Processor* proc = _processors[cpu];
+        if (proc->pkg < 0)
+          continue;
+
+        pkgs.insert(proc->pkg);
+        if (proc->core >= 0)
+          cores.insert(std::make_pair(proc->pkg, proc->core));
+      }
+
+    _pkgs = pkgs.size();
+    _cores = cores.size();
+  }
+
   CpuInfo::CpuInfo()
   {
-    std::string tmp; // temporary string to get data from console
-    std::ifstream file;
-    std::string line;
     Processor* proc;
 
     _cpus = sysconf(_SC_NPROCESSORS_CONF);
     _pkgs = _cores = 0;
-
-    int *isPkgCounted, *isCoreCounted;
-    isPkgCounted = new int[_cpus];
-    isCoreCounted = new int[_cpus];
+    _onlineFd = -1;
+    _onlineSeq = 0;
+    _onlineTime = 0;
+    _online.assign(_cpus, 0);
+    pthread_mutex_init(&_onlineMutex, NULL);
 
     for (unsigned int cpu = 0; cpu < _cpus; cpu++)
       {
@@ -312,44 +361,15 @@ namespace cea
         proc->id = cpu;
         proc->is_online = isCpuOnline(cpu);
 
-        //Package ID
-        if (topologyReadFile(cpu, "physical_package_id", &(proc->pkg)) < 0)
-          {
-            DebugLog::writeMsg(DebugLog::ERROR, "CpuInfo::CpuInfo()",
-                "The 'topology/physical_package_id' file could not be read");
-            delete proc;
-            continue;
-          }
-        if (!isPkgCounted[proc->pkg])
-          {
-            _pkgs++;
-            isPkgCounted[proc->pkg] = 1;
-          }
-
-        // Core ID
-        if (topologyReadFile(cpu, "core_id", &(proc->core)) < 0)
-          {
-            DebugLog::writeMsg(DebugLog::ERROR, "CpuInfo::CpuInfo()",
-                "The 'topology/core_id' file could not be read");
-            delete proc;
-            continue;
-          }
-        if (!isCoreCounted[proc->core])
-          {
-            _cores++;
-            isCoreCounted[proc->core] = 1;
-          }
-
+        readTopology(proc);
         get_cpu_info(cpu, proc);
         getCacheSize(proc);
 
         _processors.push_back(proc);
       }
 
+    countTopology();
     buildMap();
-
-    delete (isPkgCounted);
-    delete (isCoreCounted);
   }
 
   CpuInfo::~CpuInfo()
@@ -357,6 +377,100 @@ namespace cea
     for (unsigned i = 0; i < _processors.size(); i++)
       delete (_processors[i]);
     _processors.clear();
+
+    if (_onlineFd >= 0)
+      close(_onlineFd);
+    pthread_mutex_destroy(&_onlineMutex);
+  }
+
+  bool
+  CpuInfo::updateOnline()
+  {
+    char buf[MAX_LINE_LEN];
+    struct timespec ts;
+    ssize_t len;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    u64 now = ts.tv_sec * 1000000000ull + ts.tv_nsec;
+
+    pthread_mutex_lock(&_onlineMutex);
+    if ((_onlineTime > 0) && (now - _onlineTime < CPUINFO_ONLINE_PERIOD))
+      {
+        pthread_mutex_unlock(&_onlineMutex);
+        return false;
+      }
+    _onlineTime = now;
+
+    if (_onlineFd < 0)
+      _onlineFd = open(PATH_TO_CPU "online", O_RDONLY);
+    len = (_onlineFd >= 0) ? pread(_onlineFd, buf, sizeof(buf) - 1, 0) : -1;
+    if (len <= 0)
+      {
+        pthread_mutex_unlock(&_onlineMutex);
+        return false;
+      }
+    buf[len] = '\0';
+
+    // The list is made of ranges, e.g. "0-3,6,8-9"
+    _online.assign(_cpus, 0);
+    char *p = buf, *endp;
+    while ((*p >= '0') && (*p <= '9'))
+      {
+        unsigned long first = strtoul(p, &endp, 10), last = first;
+        p = endp;
+        if (*p == '-')
+          {
+            last = strtoul(p + 1, &endp, 10);
+            p = endp;
+          }
+        for (unsigned long cpu = first; (cpu <= last) && (cpu < _cpus); cpu++)
+          _online[cpu] = 1;
+        if (*p == ',')
+          p++;
+      }
+
+    bool changed = false;
+    for (unsigned int cpu = 0; cpu < _processors.size(); cpu++)
+      {
+        Processor* proc = _processors[cpu];
+        if (proc->is_online == _online[cpu])
+          continue;
+
+        proc->is_online = _online[cpu];
+        if (proc->is_online && (proc->pkg < 0))
+          readTopology(proc);
+        changed = true;
+      }
+
+    if (changed)
+      {
+        countTopology();
+        _onlineSeq++;
+      }
+    pthread_mutex_unlock(&_onlineMutex);
+
+    return changed;
+  }
+
+  unsigned int
+  CpuInfo::getOnlineSeq()
+  {
+    pthread_mutex_lock(&_onlineMutex);
+    unsigned int seq = _onlineSeq;
+    pthread_mutex_unlock(&_onlineMutex);
+
+    return seq;
+  }
+
+  bool
+  CpuInfo::isOnline(unsigned int cpu)
+  {
+    pthread_mutex_lock(&_onlineMutex);
+    bool online = (cpu < _processors.size())
+        && (_processors[cpu]->is_online == 1);
+    pthread_mutex_unlock(&_onlineMutex);
+
+    return online;
   }
 
   int
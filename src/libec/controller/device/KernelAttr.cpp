@@ -0,0 +1,255 @@
+#include <libec/device/KernelAttr.h>
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Enough for a number
+#define KERNELATTR_LINE 64
+/// Enough for /proc/meminfo or /proc/[pid]/status
+#define KERNELATTR_PAGE 4096
+
+namespace cea
+{
+  //Static members
+  u64 KernelAttr::_openCount = 0;
+  u64 KernelAttr::_readCount = 0;
+
+  KernelAttr::KernelAttr() :
+      _fd(-1)
+  {
+  }
+
+  KernelAttr::KernelAttr(const std::string &path) :
+      _fd(-1)
+  {
+    open(path);
+  }
+
+  KernelAttr::KernelAttr(const KernelAttr &attr) :
+      _path(attr._path), _fd(-1)
+  {
+    if (attr._fd >= 0)
+      _fd = dup(attr._fd);
+  }
+
+  KernelAttr::~KernelAttr()
+  {
+    close();
+  }
+
+  KernelAttr&
+  KernelAttr::operator=(const KernelAttr &attr)
+  {
+    if (this != &attr)
+      {
+        close();
+        _path = attr._path;
+        if (attr._fd >= 0)
+          _fd = dup(attr._fd);
+      }
+    return *this;
+  }
+
+  bool
+  KernelAttr::open(const std::string &path)
+  {
+    close();
+    _path = path;
+
+    return reopen();
+  }
+
+  void
+  KernelAttr::close()
+  {
+    if (_fd >= 0)
+      ::close(_fd);
+    _fd = -1;
+    _path.clear();
+  }
+
+  bool
+  KernelAttr::isOpen() const
+  {
+    return (_fd >= 0);
+  }
+
+  const std::string&
+  KernelAttr::getPath() const
+  {
+    return _path;
+  }
+
+  ssize_t
+  KernelAttr::read(char* buf, size_t size)
+  {
+    ssize_t len = -1;
+
+    if ((_fd >= 0) || reopen())
+      len = pread(_fd, buf, size - 1, 0);
+
+    // attributes are never empty: the file was removed or replaced
+    if ((len <= 0) && (_fd >= 0) && reopen())
+      len = pread(_fd, buf, size - 1, 0);
+
+    if (len < 0)
+      return -1;
+
+    buf[len] = '\0';
+    __sync_add_and_fetch(&_readCount, 1);
+    return len;
+  }
+
+  bool
+  KernelAttr::readU64(u64 &value)
+  {
+    return (readU64s(&value, 1) == 1);
+  }
+
+  bool
+  KernelAttr::readS64(long long &value)
+  {
+    char buf[KERNELATTR_LINE];
+    const char* p = buf;
+    u64 abs;
+
+    if (read(buf, sizeof(buf)) <= 0)
+      return false;
+
+    while ((*p == ' ') || (*p == '\t'))
+      p++;
+    bool negative = (*p == '-');
+    if (negative)
+      p++;
+    if ((*p < '0') || (*p > '9'))
+      return false;
+
+    scanU64(p, abs);
+    value = negative ? -(long long) abs : (long long) abs;
+    return true;
+  }
+
+  unsigned int
+  KernelAttr::readU64s(u64* values, unsigned int count)
+  {
+    char buf[KERNELATTR_PAGE];
+    const char* p = buf;
+    unsigned int n;
+
+    if (read(buf, sizeof(buf)) <= 0)
+      return 0;
+
+    for (n = 0; n < count; n++)
+      {
+        while ((*p == ' ') || (*p == '\t') || (*p == '\n'))
+          p++;
+        if ((*p < '0') || (*p > '9'))
+          break;
+        p = scanU64(p, values[n]);
+      }
+
+    return n;
+  }
+
+  bool
+  KernelAttr::readKey(const char* key, u64 &value)
+  {
+    return (readKeys(&key, &value, 1) == 1);
+  }
+
+  unsigned int
+  KernelAttr::readKeys(const char* const * keys, u64* values,
+      unsigned int count)
+  {
+    char buf[KERNELATTR_PAGE];
+
+    if (read(buf, sizeof(buf)) <= 0)
+      {
+        for (unsigned int k = 0; k < count; k++)
+          values[k] = 0;
+        return 0;
+      }
+
+    return parseKeys(buf, keys, values, count);
+  }
+
+  const char*
+  KernelAttr::scanU64(const char* p, u64 &value)
+  {
+    while ((*p == ' ') || (*p == '\t'))
+      p++;
+
+    value = 0;
+    while ((*p >= '0') && (*p <= '9'))
+      value = value * 10 + (*p++ - '0');
+
+    return p;
+  }
+
+  unsigned int
+  KernelAttr::parseKeys(const char* buf, const char* const * keys,
+      u64* values, unsigned int count)
+  {
+    const char* p = buf;
+    unsigned int found = 0;
+
+    for (unsigned int k = 0; k < count; k++)
+      values[k] = 0;
+
+    // key, then ':' or blanks, then the value
+    while ((*p != '\0') && (found < count))
+      {
+        for (unsigned int k = 0; k < count; k++)
+          {
+            size_t len = strlen(keys[k]);
+            if ((strncmp(p, keys[k], len) != 0)
+                || ((p[len] != ':') && (p[len] != ' ') && (p[len] != '\t')))
+              continue;
+
+            const char* v = p + len;
+            if (*v == ':')
+              v++;
+            scanU64(v, values[k]);
+            found++;
+            break;
+          }
+
+        while ((*p != '\n') && (*p != '\0'))
+          p++;
+        if (*p == '\n')
+          p++;
+      }
+
+    return found;
+  }
+
+  u64
+  KernelAttr::getOpenCount()
+  {
+    return _openCount;
+  }
+
+  u64
+  KernelAttr::getReadCount()
+  {
+    return _readCount;
+  }
+
+  bool
+  KernelAttr::reopen()
+  {
+    if (_fd >= 0)
+      ::close(_fd);
+    _fd = -1;
+
+    if (_path.empty())
+      return false;
+
+    _fd = ::open(_path.c_str(), O_RDONLY);
+    if (_fd >= 0)
+      __sync_add_and_fetch(&_openCount, 1);
+
+    return (_fd >= 0);
+  }
+}
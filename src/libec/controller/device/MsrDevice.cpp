@@ -0,0 +1,105 @@
+#include <libec/device/MsrDevice.h>
+
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cea
+{
+  //Static members
+  std::vector<int> MsrDevice::_devices;
+  std::string MsrDevice::_path = "/dev/cpu/%u/msr";
+  u64 MsrDevice::_openCount = 0;
+  u64 MsrDevice::_readCount = 0;
+  pthread_mutex_t MsrDevice::_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+  bool
+  MsrDevice::read(unsigned int cpu, unsigned int reg, u64 &value)
+  {
+    return read(cpu, &reg, &value, 1);
+  }
+
+  /*
+   * Each register is read at its address. Possible errno values:
+   * EFAULT -If the read did not fully complete
+   * EIO    -If the CPU does not support the register
+   * ENXIO  -If the CPU does not exist
+   */
+  bool
+  MsrDevice::read(unsigned int cpu, const unsigned int* regs, u64* values,
+      unsigned int count)
+  {
+    int fd = getDevice(cpu);
+    if (fd < 0)
+      return false;
+
+    for (unsigned int i = 0; i < count; i++)
+      if (pread(fd, &values[i], sizeof(u64), regs[i]) != sizeof(u64))
+        return false;
+
+    __sync_add_and_fetch(&_readCount, count);
+    return true;
+  }
+
+  bool
+  MsrDevice::isAvailable(unsigned int cpu)
+  {
+    return (getDevice(cpu) >= 0);
+  }
+
+  void
+  MsrDevice::close()
+  {
+    pthread_mutex_lock(&_mutex);
+    for (unsigned int i = 0; i < _devices.size(); i++)
+      if (_devices[i] >= 0)
+        ::close(_devices[i]);
+    _devices.clear();
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  void
+  MsrDevice::setPath(const std::string &path)
+  {
+    close();
+
+    pthread_mutex_lock(&_mutex);
+    _path = path;
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  u64
+  MsrDevice::getOpenCount()
+  {
+    return _openCount;
+  }
+
+  u64
+  MsrDevice::getReadCount()
+  {
+    return _readCount;
+  }
+
+  int
+  MsrDevice::getDevice(unsigned int cpu)
+  {
+    char name[256];
+    int fd;
+
+    pthread_mutex_lock(&_mutex);
+    if (cpu >= _devices.size())
+      _devices.resize(cpu + 1, -1);
+
+    fd = _devices[cpu];
+    if (fd == -1)
+      {
+        snprintf(name, sizeof(name), _path.c_str(), cpu);
+        fd = open(name, O_RDONLY);
+        _devices[cpu] = (fd >= 0) ? fd : -2;
+        _openCount++;
+      }
+    pthread_mutex_unlock(&_mutex);
+
+    return (fd >= 0) ? fd : -1;
+  }
+}
@@ -0,0 +1,141 @@
+#include <libec/device/ProcStat.h>
+#include <libec/device/KernelAttr.h>
+#include <libec/tools/SamplingClock.h>
+
+
+namespace cea
+{
+  //Static members
+  ProcStat::Jiffies ProcStat::_total;
+  ProcStat::Jiffies ProcStat::_cpus[PROCSTAT_MAX_CPUS];
+  int ProcStat::_cpuCount = -1;
+  u64 ProcStat::_time = 0;
+  u64 ProcStat::_maxAge = 10000000; // a jiffy at USER_HZ = 100
+  u64 ProcStat::_readCount = 0;
+  pthread_mutex_t ProcStat::_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+  /// The CPU lines come first: 160 bytes per line are enough for all of them
+  static char buffer[160 * (PROCSTAT_MAX_CPUS + 1)];
+
+  /// /proc/stat, opened on first use: the CPU time sensors may be built
+  /// during the static initialization, before a static member would be
+  static KernelAttr&
+  getFile()
+  {
+    static KernelAttr file("/proc/stat");
+    return file;
+  }
+
+  u64
+  ProcStat::Jiffies::getBusy() const
+  {
+    return field[USER] + field[NICE] + field[SYSTEM] + field[IRQ]
+        + field[SOFTIRQ] + field[STEAL];
+  }
+
+  u64
+  ProcStat::Jiffies::getTotal() const
+  {
+    return getBusy() + field[IDLE] + field[IOWAIT];
+  }
+
+  bool
+  ProcStat::getCpu(int cpu, Jiffies &jiffies)
+  {
+    bool ok;
+
+    pthread_mutex_lock(&_mutex);
+    ok = refresh() && (cpu < _cpuCount);
+    if (ok)
+      jiffies = (cpu < 0) ? _total : _cpus[cpu];
+    pthread_mutex_unlock(&_mutex);
+
+    return ok;
+  }
+
+  int
+  ProcStat::getCpuCount()
+  {
+    int count;
+
+    pthread_mutex_lock(&_mutex);
+    count = refresh() ? _cpuCount : -1;
+    pthread_mutex_unlock(&_mutex);
+
+    return count;
+  }
+
+  void
+  ProcStat::setMaxAge(u64 age)
+  {
+    pthread_mutex_lock(&_mutex);
+    _maxAge = age;
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  u64
+  ProcStat::getReadCount()
+  {
+    return _readCount;
+  }
+
+  bool
+  ProcStat::refresh()
+  {
+    u64 now = SamplingClock::now();
+    if ((_cpuCount >= 0) && (_maxAge > 0) && (now - _time < _maxAge))
+      return true;
+
+    if (getFile().read(buffer, sizeof(buffer)) <= 0)
+      return false;
+    _readCount++;
+
+    _cpuCount = parse(buffer, _total, _cpus, PROCSTAT_MAX_CPUS);
+    _time = now;
+
+    return (_cpuCount >= 0);
+  }
+
+  int
+  ProcStat::parse(const char* buf, Jiffies &total, Jiffies* cpus,
+      unsigned int count)
+  {
+    const char* p = buf;
+    bool aggregate = false;
+    int lines = 0;
+
+    // cpu  u n s i ...   then   cpuN u n s i ...
+    while ((p[0] == 'c') && (p[1] == 'p') && (p[2] == 'u'))
+      {
+        Jiffies* j = &total;
+        p += 3;
+
+        if (*p != ' ')
+          {
+            u64 id;
+            p = KernelAttr::scanU64(p, id);
+            j = (id < count) ? &cpus[id] : NULL;
+            if ((j != NULL) && ((int) id >= lines))
+              lines = id + 1;
+          }
+        else
+          aggregate = true;
+
+        for (int f = 0; f < FIELDS; f++)
+          {
+            u64 value = 0;
+            if ((*p != '\n') && (*p != '\0'))
+              p = KernelAttr::scanU64(p, value);
+            if (j != NULL)
+              j->field[f] = value;
+          }
+
+        while ((*p != '\n') && (*p != '\0'))
+          p++;
+        if (*p == '\n')
+          p++;
+      }
+
+    return aggregate ? lines : -1;
+  }
+}
@@ -14,12 +14,12 @@ namespace cea
 
   /** +Construtor */
   Monitor::Monitor() :
-      _frequency(1000), _lastTick(0)
+      _frequency(1000), _clock(1000 * 1000000ull)
   {
     eventMode = true;
   }
   Monitor::Monitor(cea_time_t frequency) :
-      _frequency(frequency), _lastTick(0)
+      _frequency(frequency), _clock(frequency * 1000000ull)
   {
     eventMode = true;
   }
@@ -56,6 +56,7 @@ namespace cea
   Monitor::setFrequency(cea_time_t freq)
   {
     _frequency = freq;
+    _clock.setPeriod(freq * 1000000ull);
   }
 
   /** #needUpdate */
@@ -66,7 +67,7 @@ namespace cea
     if (_frequency > 0)
       {
         /* Check the frequency */
-        if (Tools::tick() - _lastTick < _frequency)
+        if (!_clock.isDue())
           {
             return false;
           }
@@ -75,15 +76,20 @@ namespace cea
     return true;
   }
 
+  /** +getMissedUpdates */
+  u64
+  Monitor::getMissedUpdates() const
+  {
+    return _clock.getMissed();
+  }
+
   /** +update */
   void
   Monitor::update()
   {
     /* Check the Frequency if there is a frequency */
-    if (needUpdate())
+    if ((_frequency == 0) || _clock.advance())
       {
-        /* Keep the new tick */
-        _lastTick = Tools::tick();
         /* Do Update */
         onUpdate();
       }
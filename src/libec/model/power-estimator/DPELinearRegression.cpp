@@ -10,6 +10,8 @@
 
 #include <libec/estimator/DPELinearRegression.h>
 #include <libec/tools/Tools.h>
+#include <libec/tools/containers/TimeSeriesRing.h>
+#include <libec/sensor/SensorUpdater.h>
 
 #include <libec/tools/DebugLog.h>
 
@@ -20,6 +22,7 @@ namespace cea
       _lr(params, 1, 100)
   {
     _weights = NULL;
+    _updater = NULL;
     clean();
 
     _pm = pm;
@@ -80,6 +83,11 @@ namespace cea
         return;
       }
 
+    // a power sample is matched to the inputs read this delay before it
+    long delay = (_pmDelay >= 0) ? _pmDelay : pm_latency;
+    if (delay < 0)
+      delay = 0;
+
     gettimeofday(&tstart, NULL);
 #if DEBUG
     std::stringstream ss;
@@ -92,58 +100,76 @@ namespace cea
     ss << _latency;
     DebugLog::writeMsg(DebugLog::INFO, "DPELinearRegression::collectData",
         ss.str());
+    ss.str("");
+    ss << "power meter delay: ";
+    ss << delay;
+    DebugLog::writeMsg(DebugLog::INFO, "DPELinearRegression::collectData",
+        ss.str());
 #endif
 
     double inputs[_params + 1];
+    double row[_params + 1];
     double output;
 
     int i;
 
+    // the inputs of the last delay (plus a margin) are kept
+    TimeSeriesRing ring(_params, delay / ((_latency > 0) ? _latency : 1) + 8);
+    unsigned int dropped = 0;
+
     _pm->waitUpdate();
+    u64 seq = _pm->getSampleSeq();
 
     while (elapsed < total)
       {
         gettimeofday(&istart, NULL);
 
+        // inputs, timestamped when read
         i = 0;
-        if (pm_latency > _latency)
-          _pm->waitUpdate();
-
-        output = _pm->getValue().Float;
         for (SensorList::iterator it = _sensors.begin(); it != _sensors.end();
             it++)
           {
             (*it)->update();
             if ((*it)->getType() == Float)
-              {
-#if DEBUG
-                float f = (*it)->getValue().Float;
-                inputs[i] = f;
-                DebugLog::cout << "  sensor (float): " << inputs[i]
-                << DebugLog::endl;
-#else
-                inputs[i] = (*it)->getValue().Float;
-#endif
-              }
+              row[i] = (*it)->getValue().Float;
             else
-              {
-#if DEBUG
-                u64 u = (*it)->getValue().U64;
-                inputs[i] = (float) u;
-                DebugLog::cout << "  sensor (u64): " << u << DebugLog::endl;
-#else
-                inputs[i] = (float) (*it)->getValue().U64;
-#endif
-              }
+              row[i] = (float) (*it)->getValue().U64;
 
 #if DEBUG
-            DebugLog::cout << "  input[" << i << "]: " << inputs[i]
+            DebugLog::cout << "  input[" << i << "]: " << row[i]
             << DebugLog::endl;
 #endif
 
             i++;
           }
-        _lr.addPattern(inputs, &output);
+        ring.push(PowerMeter::now(), row);
+
+        // power, joined to the inputs at the time it was measured
+        bool sampled = true;
+        u64 time;
+        if (_pm->getSampleSeq() != seq)
+          {
+            // published by the meter with the time of the device
+            seq = _pm->getSampleSeq();
+            _pm->update();
+            time = _pm->getSampleTime();
+          }
+        else if (!_pm->isPublishing())
+          {
+            _pm->update();
+            time = PowerMeter::now();
+          }
+        else
+          sampled = false;
+
+        if (sampled)
+          {
+            output = _pm->getValue().Float;
+            if (ring.interpolate(time - delay * 1000000ull, inputs))
+              _lr.addPattern(inputs, &output);
+            else
+              dropped++;
+          }
 
         gettimeofday(&tnow, NULL);
         elapsed = Tools::timevaldiff(tstart, tnow);
@@ -160,6 +186,31 @@ namespace cea
         if (ielapsed < _latency)
           usleep((_latency - ielapsed) * 1000);
       }
+
+    if (dropped > 0)
+      DebugLog::writeMsg(DebugLog::WARNING,
+          "DPELinearRegression::collectData()",
+          "%u power samples had no inputs at their time and were dropped",
+          dropped);
+  }
+
+  void
+  DPELinearRegression::setMeterDelay(long delay)
+  {
+    _pmDelay = delay;
+  }
+
+  void
+  DPELinearRegression::setUpdateThreads(unsigned int threads,
+      unsigned int budget)
+  {
+    if (_updater != NULL)
+      {
+        delete _updater;
+        _updater = NULL;
+      }
+    _updateThreads = threads;
+    _updateBudget = budget;
   }
 
   unsigned
@@ -200,6 +251,12 @@ namespace cea
     double tmp;
     int i = 0;
 
+    if (_updateThreads > 0)
+      {
+        updateParallel();
+        return;
+      }
+
     tmp = _weights[i];
     for (SensorList::iterator it = _sensors.begin(); it != _sensors.end(); it++)
       {
@@ -213,6 +270,37 @@ namespace cea
     _cValue.Float = tmp;
   }
 
+  void
+  DPELinearRegression::updateParallel()
+  {
+    double tmp;
+
+    // the sensors are added to the pool the first time they are updated
+    if ((_updater == NULL) || (_updater->size() != _sensors.size()))
+      {
+        delete _updater;
+        _updater = new SensorUpdater(_updateThreads,
+            (_updateBudget > 0) ? _updateBudget : _latency / 2);
+        for (SensorList::iterator it = _sensors.begin(); it != _sensors.end();
+            it++)
+          _updater->addShared(*it);
+      }
+
+    // a late sensor contributes with its last value
+    _updater->update();
+
+    tmp = _weights[0];
+    for (unsigned int i = 0; i < _updater->size(); i++)
+      {
+        sensor_t value = _updater->getValue(i);
+        if (_updater->getSensor(i)->getType() == Float)
+          tmp += _weights[i + 1] * value.Float;
+        else
+          tmp += _weights[i + 1] * ((float) value.U64);
+      }
+    _cValue.Float = tmp;
+  }
+
   void
   DPELinearRegression::updatePid(pid_t pid)
   {
@@ -304,10 +392,21 @@ namespace cea
   void
   DPELinearRegression::clean()
   {
+    // the workers may still update the sensors
+    if (_updater != NULL)
+      {
+        delete _updater;
+        _updater = NULL;
+      }
+
     DynamicPowerEstimator::clean();
 
     _latency = 1000; // 1 second
     _pm = NULL;
+    pm_latency = 0;
+    _pmDelay = -1;
+    _updateThreads = 0;
+    _updateBudget = 0;
 
     if (_weights != NULL)
       {
@@ -0,0 +1,170 @@
+#include <libec/estimator/EnergyAccumulator.h>
+#include <libec/sensor/SensorPower.h>
+
+namespace cea
+{
+
+  EnergyAccumulator::Series::Series() :
+      first(0)
+  {
+  }
+
+  EnergyAccumulator::EnergyAccumulator(unsigned int window) :
+      _window((u64) window * 1000000ull)
+  {
+  }
+
+  void
+  EnergyAccumulator::addSample(u64 time, double power)
+  {
+    add(_machine, time, power, _window);
+  }
+
+  void
+  EnergyAccumulator::addSamplePid(pid_t pid, u64 time, double power)
+  {
+    add(_pids[pid], time, power, _window);
+  }
+
+  void
+  EnergyAccumulator::update(Sensor* sensor)
+  {
+    PowerMeter* pm = dynamic_cast<PowerMeter*>(sensor);
+    u64 time;
+
+    sensor->update();
+    if ((pm != NULL) && pm->isPublishing())
+      time = pm->getSampleTime();
+    else
+      time = PowerMeter::now();
+
+    addSample(time, sensor->getValue().Float);
+  }
+
+  void
+  EnergyAccumulator::updatePid(PIDSensor* sensor, pid_t pid)
+  {
+    sensor->updatePid(pid);
+    addSamplePid(pid, PowerMeter::now(), sensor->getValuePid(pid).Float);
+  }
+
+  double
+  EnergyAccumulator::getEnergy() const
+  {
+    return getEnergy(_machine);
+  }
+
+  double
+  EnergyAccumulator::getEnergyPid(pid_t pid) const
+  {
+    std::map<pid_t, Series>::const_iterator it = _pids.find(pid);
+    return (it != _pids.end()) ? getEnergy(it->second) : 0.0;
+  }
+
+  double
+  EnergyAccumulator::getWindowEnergy() const
+  {
+    return getWindowEnergy(_machine, _window);
+  }
+
+  double
+  EnergyAccumulator::getWindowEnergyPid(pid_t pid) const
+  {
+    std::map<pid_t, Series>::const_iterator it = _pids.find(pid);
+    return (it != _pids.end()) ? getWindowEnergy(it->second, _window) : 0.0;
+  }
+
+  double
+  EnergyAccumulator::getElapsed() const
+  {
+    return getElapsed(_machine);
+  }
+
+  double
+  EnergyAccumulator::getElapsedPid(pid_t pid) const
+  {
+    std::map<pid_t, Series>::const_iterator it = _pids.find(pid);
+    return (it != _pids.end()) ? getElapsed(it->second) : 0.0;
+  }
+
+  void
+  EnergyAccumulator::removePid(pid_t pid)
+  {
+    _pids.erase(pid);
+  }
+
+  void
+  EnergyAccumulator::add(Series &series, u64 time, double power, u64 window)
+  {
+    Point p;
+
+    if (series.window.empty())
+      {
+        series.first = time;
+        p.energy = 0.0;
+      }
+    else
+      {
+        const Point &last = series.window.back();
+
+        // samples out of order are ignored
+        if (time <= last.time)
+          return;
+
+        // trapezoidal rule
+        p.energy = last.energy
+            + (last.power + power) / 2.0 * (double) (time - last.time) / 1e9;
+      }
+
+    p.time = time;
+    p.power = power;
+    series.window.push_back(p);
+
+    // the first point is the last one not after the start of the window
+    if (time > window)
+      {
+        u64 start = time - window;
+        while ((series.window.size() > 1) && (series.window[1].time <= start))
+          series.window.pop_front();
+      }
+  }
+
+  double
+  EnergyAccumulator::getEnergy(const Series &series)
+  {
+    return series.window.empty() ? 0.0 : series.window.back().energy;
+  }
+
+  double
+  EnergyAccumulator::getWindowEnergy(const Series &series, u64 window)
+  {
+    if (series.window.empty())
+      return 0.0;
+
+    const Point &last = series.window.back();
+    const Point &first = series.window.front();
+    u64 start = (last.time > window) ? last.time - window : 0;
+
+    if ((first.time >= start) || (series.window.size() < 2))
+      return last.energy - first.energy;
+
+    // energy at the start, the power being linear in the first interval
+    const Point &next = series.window[1];
+    double dt = (double) (start - first.time);
+    double power = first.power
+        + (next.power - first.power) * dt / (double) (next.time - first.time);
+    double energy = first.energy + (first.power + power) / 2.0 * dt / 1e9;
+
+    return last.energy - energy;
+  }
+
+  double
+  EnergyAccumulator::getElapsed(const Series &series)
+  {
+    if (series.window.empty())
+      return 0.0;
+
+    return (double) (series.window.back().time - series.first) / 1e9;
+  }
+
+}
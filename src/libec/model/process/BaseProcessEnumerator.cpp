@@ -1,4 +1,5 @@
 #include <libec/process/BaseProcessEnumerator.h>
+#include <libec/process/PidStateSlab.h>
 
 #include <libec/tools/DebugLog.h>
 
@@ -8,7 +9,7 @@ namespace cea
   /** Constructor */
   BaseProcessEnumerator::BaseProcessEnumerator() :
       _updateTick(0), _cpuCalculUsageActivate(false), _totalCPULastTime(0), _totalCPUTimeElapsed(
-          0), _isBeginUpdateDone(false), _frequency(1000), _lastTick(0)
+          0), _isBeginUpdateDone(false), _frequency(1000), _clock(1000 * 1000000ull)
   {
     ;
   }
@@ -17,9 +18,9 @@ namespace cea
   BaseProcessEnumerator::~BaseProcessEnumerator()
   {
     /* Delete from memory the Process Pointer */
-    for (ProcessMap::iterator it = _process.begin(); it != _process.end(); ++it)
+    for (unsigned int i = 0; i < _process.size(); i++)
       {
-        delete it->second;
+        delete _process.at(i);
       }
   }
 
@@ -34,6 +35,7 @@ namespace cea
   BaseProcessEnumerator::setFrequency(cea_time_t freq)
   {
     _frequency = freq;
+    _clock.setPeriod(freq * 1000000ull);
   }
 
   /** #needUpdate */
@@ -44,7 +46,7 @@ namespace cea
     if (_frequency > 0)
       {
         /* Check the frequency */
-        if (Tools::tick() - _lastTick < _frequency)
+        if (!_clock.isDue())
           {
             return false;
           }
@@ -53,6 +55,13 @@ namespace cea
     return true;
   }
 
+  /** +getMissedUpdates */
+  u64
+  BaseProcessEnumerator::getMissedUpdates() const
+  {
+    return _clock.getMissed();
+  }
+
   /** +beginUpdate */
   void
   BaseProcessEnumerator::beginUpdate()
@@ -70,13 +79,11 @@ namespace cea
     /* Check the Frequency if there is a frequency */
     if (_frequency > 0)
       {
-        /* Check the frequency */
-        if (Tools::tick() - _lastTick < _frequency)
+        /* Check the frequency, on deadlines that do not drift */
+        if (!_clock.advance())
           {
             return;
           }
-        /* Keep the new tick */
-        _lastTick = Tools::tick();
       }
     /* Advance the Update Tick */
     _updateTick++;
@@ -92,30 +99,17 @@ namespace cea
     /* Enumerate the new Process */
     enumProcess();
     /* Delete the process which are dead */
-    for (ProcessMap::iterator it = _process.begin(); it != _process.end();)
+    for (unsigned int i = 0; i < _process.size();)
       {
-        if (it->second->_updateTick != _updateTick)
+        if (_process.at(i)->_updateTick != _updateTick)
           {
-            /* Feed the monitor */
-            feedDeleteItem(FEEDER_PROCESS_ITEM, it->second);
-            /* Remove the process from memory */
-            if (_isBeginUpdateDone)
-              {
-                /* Store in a list: the item will be deleted on endUpdate */
-                _deletedProcess.push_back(it->second);
-              }
-            else
-              {
-                /* Delete the item from memory */
-                delete it->second;
-              }
-            /* Remove the process from the list */
-            _process.erase(it++);
-
+            /* Remove the process from the list: the last process takes
+             * its position */
+            removeProcessAt(i);
           }
         else
           {
-            ++it;
+            ++i;
           }
       }
 
@@ -141,9 +135,9 @@ namespace cea
   BaseProcessEnumerator::clear()
   {
     /* Delete from memory the Process Pointer */
-    for (ProcessMap::iterator it = _process.begin(); it != _process.end(); ++it)
+    for (unsigned int i = 0; i < _process.size(); i++)
       {
-        delete it->second;
+        delete _process.at(i);
       }
     /* Clear the Process List */
     _process.clear();
@@ -173,30 +167,15 @@ namespace cea
   Process*
   BaseProcessEnumerator::getProcess_const(unsigned int id) const
   {
-    /* Search the process */
-    for (ProcessMap::const_iterator it = _process.begin(); it != _process.end();
-        ++it)
-      {
-        if (id == 0)
-          return it->second;
-        id--;
-      }
-    // If no item found return 0
-    return 0;
+    /* Direct access, 0 if out of range */
+    return _process.at(id);
   }
 
   Process*
   BaseProcessEnumerator::getProcess(unsigned int id)
   {
-    // Search the process
-    for (ProcessMap::iterator it = _process.begin(); it != _process.end(); ++it)
-      {
-        if (id == 0)
-          return it->second;
-        id--;
-      }
-    // If no item found return 0
-    return 0;
+    // Direct access, 0 if out of range
+    return _process.at(id);
   }
 
   /** #updateProcess(p : Process*) */
@@ -213,6 +192,41 @@ namespace cea
       }
   }
 
+  /** #removeProcess(pid : pid_t) */
+  bool
+  BaseProcessEnumerator::removeProcess(pid_t pid)
+  {
+    int id = _process.indexOf(pid);
+    if (id == -1)
+      return false;
+    removeProcessAt(id);
+    return true;
+  }
+
+  /** -removeProcessAt(id : unsigned int) */
+  void
+  BaseProcessEnumerator::removeProcessAt(unsigned int id)
+  {
+    Process* p = _process.at(id);
+    /* Feed the monitor */
+    feedDeleteItem(FEEDER_PROCESS_ITEM, p);
+    /* Remove the process from the list */
+    _process.removeAt(id);
+    /* Release the per-pid state of the sensors */
+    PidStateSlab::release(p->getPid());
+    /* Remove the process from memory */
+    if (_isBeginUpdateDone)
+      {
+        /* Store in a list: the item will be deleted on endUpdate */
+        _deletedProcess.push_back(p);
+      }
+    else
+      {
+        /* Delete the item from memory */
+        delete p;
+      }
+  }
+
   /** Apply Filter on a Process - return True if process ok with filter */
   bool
   BaseProcessEnumerator::applyFilter(Process* p)
@@ -239,20 +253,10 @@ namespace cea
       {
         if (applyFilter(p))
           {
-            /* Add the process - Check if the pid not already present
-             * and calcul the best position */
-            ProcessMap::iterator lb = _process.lower_bound(pid);
-            if ((lb != _process.end())
-                && (!(_process.key_comp()(pid, lb->first))))
-              {
-                /* Item already exist */
-                lb->second = p;
-              }
-            else
-              {
-                /* Add the process */
-                _process.insert(ProcessMap::value_type(pid, p));
-              }
+            /* Add the process - a process already present with the same
+             * pid is removed first */
+            removeProcess(pid);
+            _process.insert(p);
             p->_createdTick = _updateTick;
             /* Feed the monitor */
             feedCreateItem(FEEDER_PROCESS_ITEM, p);
@@ -271,34 +275,16 @@ namespace cea
   Process*
   BaseProcessEnumerator::getProcessByPID_const(pid_t pid) const
   {
-    /* Find the item */
-    ProcessMap::const_iterator it = _process.find(pid);
-    /* Return Item */
-    if (it != _process.end())
-      {
-        return it->second;
-      }
-    else
-      {
-        return 0;
-      }
+    /* Find the item, 0 if not found */
+    return _process.find(pid);
   }
 
   /** +getProcess(pid : pid_t) */
   Process*
   BaseProcessEnumerator::getProcessByPID(pid_t pid)
   {
-    /* Find the item */
-    ProcessMap::iterator it = _process.find(pid);
-    /* Return Item */
-    if (it != _process.end())
-      {
-        return it->second;
-      }
-    else
-      {
-        return 0;
-      }
+    /* Find the item, 0 if not found */
+    return _process.find(pid);
   }
 
   /** +getDeletedProcessCount */
@@ -383,10 +369,9 @@ namespace cea
   {
     o << "Process Count=<" << p._process.size() << ">" << std::endl << "-------"
         << std::endl;
-    for (BaseProcessEnumerator::ProcessMap::const_iterator it =
-        p._process.begin(); it != p._process.end(); ++it)
+    for (unsigned int i = 0; i < p._process.size(); i++)
       {
-        o << (*(it->second)) << std::endl;
+        o << (*(p._process.at(i))) << std::endl;
       }
     return o;
   }
@@ -0,0 +1,157 @@
+#include <libec/process/PidIndex.h>
+
+/* Initial number of buckets (power of 2) */
+#define PID_INDEX_MIN_BUCKETS 256
+
+namespace cea
+{
+
+  /** Constructor */
+  PidIndex::PidIndex() :
+      _mask(0), _count(0)
+  {
+    rehash(PID_INDEX_MIN_BUCKETS);
+  }
+
+  /** +size */
+  unsigned int
+  PidIndex::size() const
+  {
+    return _count;
+  }
+
+  /** +find */
+  int
+  PidIndex::find(pid_t pid) const
+  {
+    int b = findBucket(pid);
+    return (b != -1) ? _buckets[b].pos : -1;
+  }
+
+  /** +set */
+  void
+  PidIndex::set(pid_t pid, int pos)
+  {
+    /* Update the pid already indexed */
+    int b = findBucket(pid);
+    if (b != -1)
+      {
+        _buckets[b].pos = pos;
+        return;
+      }
+
+    /* Keep the load factor under 1/2 */
+    if (2 * (_count + 1) > _buckets.size())
+      rehash(2 * _buckets.size());
+
+    unsigned int i = hash(pid);
+    while (_buckets[i].pos != -1)
+      i = (i + 1) & _mask;
+    _buckets[i].pid = pid;
+    _buckets[i].pos = pos;
+    _count++;
+  }
+
+  /** +erase */
+  int
+  PidIndex::erase(pid_t pid)
+  {
+    int b = findBucket(pid);
+    if (b == -1)
+      return -1;
+
+    int pos = _buckets[b].pos;
+    unsigned int i = b, j = b;
+
+    /* Free the bucket by shifting back the following entries of the
+     * probe sequence */
+    while (true)
+      {
+        _buckets[i].pos = -1;
+        while (true)
+          {
+            j = (j + 1) & _mask;
+            if (_buckets[j].pos == -1)
+              break;
+            unsigned int k = hash(_buckets[j].pid);
+            /* j can move to i only if its home bucket k is not in (i, j] */
+            if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+              continue;
+            break;
+          }
+        if (_buckets[j].pos == -1)
+          break;
+        _buckets[i] = _buckets[j];
+        i = j;
+      }
+
+    _count--;
+    return pos;
+  }
+
+  /** +clear */
+  void
+  PidIndex::clear()
+  {
+    for (unsigned int i = 0; i < _buckets.size(); i++)
+      _buckets[i].pos = -1;
+    _count = 0;
+  }
+
+  /** +reserve */
+  void
+  PidIndex::reserve(unsigned int count)
+  {
+    unsigned int buckets = _buckets.size();
+    while (buckets < 2 * count)
+      buckets *= 2;
+    if (buckets != _buckets.size())
+      rehash(buckets);
+  }
+
+  /** #hash */
+  unsigned int
+  PidIndex::hash(pid_t pid) const
+  {
+    /* Multiplicative hashing: consecutive pids spread over the buckets */
+    return ((unsigned int) (pid) * 2654435761u) & _mask;
+  }
+
+  /** #findBucket */
+  int
+  PidIndex::findBucket(pid_t pid) const
+  {
+    for (unsigned int i = hash(pid);; i = (i + 1) & _mask)
+      {
+        if (_buckets[i].pos == -1)
+          return -1;
+        if (_buckets[i].pid == pid)
+          return i;
+      }
+  }
+
+  /** #rehash */
+  void
+  PidIndex::rehash(unsigned int buckets)
+  {
+    std::vector<Bucket> old;
+    Bucket empty;
+
+    empty.pid = 0;
+    empty.pos = -1;
+    old.swap(_buckets);
+    _buckets.assign(buckets, empty);
+    _mask = buckets - 1;
+
+    for (unsigned int b = 0; b < old.size(); b++)
+      {
+        if (old[b].pos == -1)
+          continue;
+        unsigned int i = hash(old[b].pid);
+        while (_buckets[i].pos != -1)
+          i = (i + 1) & _mask;
+        _buckets[i] = old[b];
+      }
+  }
+
+}
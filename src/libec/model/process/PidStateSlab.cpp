@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <libec/process/PidStateSlab.h>
+#include <libec/sensor/SensorPid.h>
+
+/* Number of rows per chunk */
+#define PID_STATE_CHUNK_ROWS 64
+/* Alignment of the blocks */
+#define PID_STATE_ALIGN 8
+
+namespace cea
+{
+  ///////////////////////////////////////////////////////////////////
+  // Static Members
+  ///////////////////////////////////////////////////////////////////
+  /** #storage */
+  PidStateSlab::Storage&
+  PidStateSlab::storage()
+  {
+    static Storage s;
+    return s;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Public Members
+  ///////////////////////////////////////////////////////////////////
+  /** +registerBlock */
+  unsigned int
+  PidStateSlab::registerBlock(unsigned int size, PIDSensor* owner)
+  {
+    Storage& s = storage();
+
+    size = (size + PID_STATE_ALIGN - 1) & ~(PID_STATE_ALIGN - 1);
+
+    /* Reuse the smallest free block large enough */
+    int best = -1;
+    for (unsigned int i = 0; i < s.blocks.size(); i++)
+      {
+        if (s.blocks[i].used || (s.blocks[i].size < size))
+          continue;
+        if ((best == -1) || (s.blocks[i].size < s.blocks[best].size))
+          best = i;
+      }
+    if (best != -1)
+      {
+        s.blocks[best].used = true;
+        s.blocks[best].owner = owner;
+        zeroBlock(s.blocks[best]);
+        return s.blocks[best].offset;
+      }
+
+    /* Append the block at the end of the rows */
+    Block b;
+    b.offset = s.rowSize;
+    b.size = size;
+    b.owner = owner;
+    b.used = true;
+    s.blocks.push_back(b);
+    resize(s.rowSize + size);
+
+    return b.offset;
+  }
+
+  /** +unregisterBlock */
+  void
+  PidStateSlab::unregisterBlock(unsigned int offset)
+  {
+    Storage& s = storage();
+    for (unsigned int i = 0; i < s.blocks.size(); i++)
+      {
+        if (s.blocks[i].offset == offset)
+          {
+            s.blocks[i].used = false;
+            s.blocks[i].owner = NULL;
+            return;
+          }
+      }
+  }
+
+  /** +setOwner */
+  void
+  PidStateSlab::setOwner(unsigned int offset, PIDSensor* owner)
+  {
+    Storage& s = storage();
+    for (unsigned int i = 0; i < s.blocks.size(); i++)
+      {
+        if (s.blocks[i].used && (s.blocks[i].offset == offset))
+          {
+            s.blocks[i].owner = owner;
+            return;
+          }
+      }
+  }
+
+  /** +acquire */
+  char*
+  PidStateSlab::acquire(pid_t pid)
+  {
+    Storage& s = storage();
+    int row = s.index.find(pid);
+    if (row != -1)
+      return getRow(row);
+
+    if (s.rowSize == 0)
+      return NULL;
+
+    /* Take a free row, or add a new one */
+    if (!s.freeRows.empty())
+      {
+        row = s.freeRows.back();
+        s.freeRows.pop_back();
+      }
+    else
+      {
+        row = s.rowPid.size();
+        if ((row % PID_STATE_CHUNK_ROWS) == 0)
+          s.chunks.push_back(
+              (char*) calloc(PID_STATE_CHUNK_ROWS, s.rowSize));
+        s.rowPid.push_back(pid);
+      }
+
+    char* r = getRow(row);
+    memset(r, 0, s.rowSize);
+    s.rowPid[row] = pid;
+    s.index.set(pid, row);
+
+    return r;
+  }
+
+  /** +find */
+  char*
+  PidStateSlab::find(pid_t pid)
+  {
+    Storage& s = storage();
+    int row = s.index.find(pid);
+    return (row != -1) ? getRow(row) : NULL;
+  }
+
+  /** +release */
+  void
+  PidStateSlab::release(pid_t pid)
+  {
+    Storage& s = storage();
+    int row = s.index.find(pid);
+    if (row == -1)
+      return;
+
+    /* Let the owners release their resources */
+    for (unsigned int i = 0; i < s.blocks.size(); i++)
+      {
+        if (s.blocks[i].used && (s.blocks[i].owner != NULL))
+          s.blocks[i].owner->remove(pid);
+      }
+
+    s.index.erase(pid);
+    s.freeRows.push_back(row);
+  }
+
+  /** +getPids */
+  void
+  PidStateSlab::getPids(std::vector<pid_t>& pids)
+  {
+    Storage& s = storage();
+    pids.clear();
+    for (unsigned int row = 0; row < s.rowPid.size(); row++)
+      {
+        if (isUsed(row))
+          pids.push_back(s.rowPid[row]);
+      }
+  }
+
+  /** +getRowCount */
+  unsigned int
+  PidStateSlab::getRowCount()
+  {
+    Storage& s = storage();
+    return s.index.size();
+  }
+
+  /** +getRowSize */
+  unsigned int
+  PidStateSlab::getRowSize()
+  {
+    Storage& s = storage();
+    return s.rowSize;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Protected Members
+  ///////////////////////////////////////////////////////////////////
+  /** #getRow */
+  char*
+  PidStateSlab::getRow(unsigned int row)
+  {
+    Storage& s = storage();
+    return s.chunks[row / PID_STATE_CHUNK_ROWS]
+        + (row % PID_STATE_CHUNK_ROWS) * s.rowSize;
+  }
+
+  /** #isUsed */
+  bool
+  PidStateSlab::isUsed(unsigned int row)
+  {
+    Storage& s = storage();
+    return (s.index.find(s.rowPid[row]) == (int) (row));
+  }
+
+  /** #resize */
+  void
+  PidStateSlab::resize(unsigned int rowSize)
+  {
+    Storage& s = storage();
+    unsigned int oldSize = s.rowSize;
+
+    /* The new room of each row is zero filled by calloc */
+    for (unsigned int c = 0; c < s.chunks.size(); c++)
+      {
+        char* chunk = (char*) calloc(PID_STATE_CHUNK_ROWS, rowSize);
+        if (s.chunks[c] != NULL)
+          {
+            for (unsigned int r = 0; r < PID_STATE_CHUNK_ROWS; r++)
+              memcpy(chunk + r * rowSize, s.chunks[c] + r * oldSize, oldSize);
+            free(s.chunks[c]);
+          }
+        s.chunks[c] = chunk;
+      }
+
+    s.rowSize = rowSize;
+  }
+
+  /** #zeroBlock */
+  void
+  PidStateSlab::zeroBlock(const Block& block)
+  {
+    Storage& s = storage();
+    for (unsigned int row = 0; row < s.rowPid.size(); row++)
+      {
+        if (isUsed(row))
+          memset(getRow(row) + block.offset, 0, block.size);
+      }
+  }
+
+}
@@ -0,0 +1,106 @@
+#include <libec/process/ProcessTable.h>
+
+namespace cea
+{
+
+  /** Constructor */
+  ProcessTable::ProcessTable()
+  {
+  }
+
+  /** +size */
+  unsigned int
+  ProcessTable::size() const
+  {
+    return _dense.size();
+  }
+
+  /** +at */
+  Process*
+  ProcessTable::at(unsigned int id) const
+  {
+    return (id < _dense.size()) ? _dense[id] : 0;
+  }
+
+  /** +find */
+  Process*
+  ProcessTable::find(pid_t pid) const
+  {
+    int id = _index.find(pid);
+    return (id != -1) ? _dense[id] : 0;
+  }
+
+  /** +indexOf */
+  int
+  ProcessTable::indexOf(pid_t pid) const
+  {
+    return _index.find(pid);
+  }
+
+  /** +insert */
+  Process*
+  ProcessTable::insert(Process* p)
+  {
+    pid_t pid = p->getPid();
+
+    /* Replace the process already stored */
+    int id = _index.find(pid);
+    if (id != -1)
+      {
+        Process* old = _dense[id];
+        _dense[id] = p;
+        return old;
+      }
+
+    _index.set(pid, _dense.size());
+    _dense.push_back(p);
+    return 0;
+  }
+
+  /** +remove */
+  Process*
+  ProcessTable::remove(pid_t pid)
+  {
+    int id = _index.find(pid);
+    return (id != -1) ? removeAt(id) : 0;
+  }
+
+  /** +removeAt */
+  Process*
+  ProcessTable::removeAt(unsigned int id)
+  {
+    if (id >= _dense.size())
+      return 0;
+
+    Process* p = _dense[id];
+    _index.erase(p->getPid());
+
+    /* Move the last process into the freed position */
+    unsigned int last = _dense.size() - 1;
+    if (id != last)
+      {
+        _dense[id] = _dense[last];
+        _index.set(_dense[id]->getPid(), id);
+      }
+    _dense.pop_back();
+
+    return p;
+  }
+
+  /** +clear */
+  void
+  ProcessTable::clear()
+  {
+    _dense.clear();
+    _index.clear();
+  }
+
+  /** +reserve */
+  void
+  ProcessTable::reserve(unsigned int count)
+  {
+    _index.reserve(count);
+    _dense.reserve(count);
+  }
+
+}
@@ -1,9 +1,53 @@
 #ifdef __unix__
 
 #include <libec/process/linux/LinuxProcess.h>
+#include <libec/process/linux/ProcessSampleCache.h>
 
 namespace cea
 {
+  /* Static Members */
+  void* LinuxProcess::_freeSlots = NULL;
+
+  /** +operator new */
+  void*
+  LinuxProcess::operator new(size_t size)
+  {
+    /* Derived classes are not pooled */
+    if (size != sizeof(LinuxProcess))
+      return ::operator new(size);
+
+    /* Pool empty: chain a new block of slots */
+    if (_freeSlots == NULL)
+      {
+        char* block = (char*) ::operator new(PoolBlockSize * size);
+        for (unsigned int i = 0; i < PoolBlockSize; i++)
+          {
+            void* slot = block + i * size;
+            *(void**) (slot) = _freeSlots;
+            _freeSlots = slot;
+          }
+      }
+
+    /* Take the first free slot */
+    void* slot = _freeSlots;
+    _freeSlots = *(void**) (slot);
+    return slot;
+  }
+
+  /** +operator delete */
+  void
+  LinuxProcess::operator delete(void* ptr, size_t size)
+  {
+    if (ptr == NULL)
+      return;
+    if (size != sizeof(LinuxProcess))
+      {
+        ::operator delete(ptr);
+        return;
+      }
+    *(void**) (ptr) = _freeSlots;
+    _freeSlots = ptr;
+  }
 
   /** Constructor */
   LinuxProcess::LinuxProcess(pid_t pid) :
@@ -15,6 +59,14 @@ namespace cea
     //ProcessStat::get(pid, ProcessStat::STIME, _startTime);
   }
 
+  /** Constructor */
+  LinuxProcess::LinuxProcess(pid_t pid, const ProcessStat::Snapshot& stat) :
+      Process(pid)
+  {
+    ProcessStat::get(stat, ProcessStat::COMM, _name);
+    retrievePath();
+  }
+
   /** #calculCPUUsage */
   void
   LinuxProcess::calculCPUUsage(long int totalCPUTimeElapsed)
@@ -24,9 +76,15 @@ namespace cea
     if (totalCPUTimeElapsed != 0)
       {
         /* Get the current Time */
-        long int userTime, systemTime;
-        ProcessStat::get(_pid, ProcessStat::UTIME, userTime);
-        ProcessStat::get(_pid, ProcessStat::UTIME, systemTime);
+        long unsigned int utime = 0, stime = 0;
+        const ProcessStat::Snapshot* stat = ProcessSampleCache::getStat(_pid);
+        if (stat != NULL)
+          {
+            ProcessStat::get(*stat, ProcessStat::UTIME, utime);
+            ProcessStat::get(*stat, ProcessStat::STIME, stime);
+          }
+        long int userTime = (long int) (utime);
+        long int systemTime = (long int) (stime);
         /* Calcul the percent of usage */
         _cpuUserUsage = 100 * (userTime - _cpuUserLastTime)
             / (totalCPUTimeElapsed);
@@ -3,6 +3,7 @@
 #include <sys/stat.h>
 
 #include <libec/process/linux/LinuxProcessEnumerator.h>
+#include <libec/process/linux/ProcessSampleCache.h>
 #include <libec/tools/Tools.h>
 
 namespace cea
@@ -40,6 +41,8 @@ namespace cea
     struct dirent *dir;
     long pid;
     char* endptr;
+    // Outdate the proc/[pid] samples shared by the PIDSensors
+    ProcessSampleCache::beginTick();
     // Open proc dir
     DIR* proc = opendir("/proc");
 
@@ -55,9 +58,11 @@ namespace cea
               continue;
             // Search the Process
             p = getProcessByPID(pid);
-            // If Process Not Found create it
+            // If Process Not Found create it, else sample its stat file
             if (p == 0)
               p = addProcess(pid);
+            else
+              ProcessSampleCache::getStat(pid);
             // Update
             if (p != 0)
               updateProcess(p);
@@ -73,20 +78,29 @@ namespace cea
   LinuxProcessEnumerator::createProcess(pid_t pid)
   {
     char state;
-    ProcessStat::get(pid, ProcessStat::STATE, state);
+    ProcessStat::Snapshot stat;
+
+    // Read proc/[pid]/stat only once for every needed field
+    if (!stat.read(pid))
+      return NULL;
+    ProcessSampleCache::setStat(pid, stat);
+    ProcessStat::get(stat, ProcessStat::STATE, state);
 
     // Ignore zombie processes.
     // Most sensors cannot be evaluated on such state.
     if (state == 'Z')
       return NULL;
 
-    return new LinuxProcess(pid);
+    return new LinuxProcess(pid, stat);
   }
 
   std::map<pid_t, Process*>
   LinuxProcessEnumerator::getAllProcesses()
   {
-    return _process;
+    ProcessMap m;
+    for (unsigned int i = 0; i < _process.size(); i++)
+      m.insert(ProcessMap::value_type(_process.at(i)->getPid(), _process.at(i)));
+    return m;
   }
 }
 
@@ -0,0 +1,251 @@
+#ifdef __unix__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#include <libec/process/linux/ProcConnectorEnumerator.h>
+#include <libec/process/linux/ProcessSampleCache.h>
+#include <libec/tools/DebugLog.h>
+
+namespace cea
+{
+
+  /* Send a multicast listen/ignore request to the proc connector */
+  static bool
+  sendMcastOp(int sock, enum proc_cn_mcast_op op)
+  {
+    char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))]
+        __attribute__ ((aligned(NLMSG_ALIGNTO)));
+    struct nlmsghdr* nl = (struct nlmsghdr*) buf;
+    struct cn_msg* cn = (struct cn_msg*) NLMSG_DATA(nl);
+
+    memset(buf, 0, sizeof(buf));
+    nl->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    nl->nlmsg_type = NLMSG_DONE;
+    nl->nlmsg_pid = getpid();
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(op);
+    memcpy(cn->data, &op, sizeof(op));
+
+    return (send(sock, buf, nl->nlmsg_len, 0) != -1);
+  }
+
+  /** Constructor */
+  ProcConnectorEnumerator::ProcConnectorEnumerator() :
+      _socket(-1), _needRescan(true), _rescanPeriod(10000), _lastRescan(0), _rescanCount(
+          0)
+  {
+    connect();
+  }
+
+  /** Destructor */
+  ProcConnectorEnumerator::~ProcConnectorEnumerator()
+  {
+    disconnect();
+  }
+
+  /** +isConnected */
+  bool
+  ProcConnectorEnumerator::isConnected() const
+  {
+    return (_socket != -1);
+  }
+
+  /** +getRescanPeriod */
+  cea_time_t
+  ProcConnectorEnumerator::getRescanPeriod() const
+  {
+    return _rescanPeriod;
+  }
+
+  /** +setRescanPeriod */
+  void
+  ProcConnectorEnumerator::setRescanPeriod(cea_time_t period)
+  {
+    _rescanPeriod = period;
+  }
+
+  /** +getRescanCount */
+  unsigned int
+  ProcConnectorEnumerator::getRescanCount() const
+  {
+    return _rescanCount;
+  }
+
+  /** #enumProcess */
+  void
+  ProcConnectorEnumerator::enumProcess()
+  {
+    /* Full rescan: not connected, events lost or safety net */
+    if ((_socket == -1) || _needRescan
+        || ((_rescanPeriod > 0)
+            && (Tools::tick() - _lastRescan >= _rescanPeriod)))
+      {
+        /* The rescan will see the effect of the pending events */
+        readEvents(false);
+        _needRescan = false;
+        LinuxProcessEnumerator::enumProcess();
+        _lastRescan = Tools::tick();
+        _rescanCount++;
+        return;
+      }
+
+    /* Outdate the proc/[pid] samples shared by the PIDSensors */
+    ProcessSampleCache::beginTick();
+
+    /* Apply the process creations/deletions */
+    readEvents(true);
+
+    /* Update the remaining process */
+    for (unsigned int i = 0; i < _process.size(); i++)
+      updateProcess(_process.at(i));
+  }
+
+  /** #connect */
+  bool
+  ProcConnectorEnumerator::connect()
+  {
+    struct sockaddr_nl addr;
+
+    /* Open the netlink connector socket */
+    _socket = socket(PF_NETLINK, SOCK_DGRAM, NETLINK_CONNECTOR);
+    if (_socket == -1)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING,
+            "ProcConnectorEnumerator::connect()",
+            "Could not open the netlink connector. /proc will be rescanned "
+                "on each update.");
+        return false;
+      }
+
+    /* Join the proc events group */
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+    if (bind(_socket, (struct sockaddr*) &addr, sizeof(addr)) == -1)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING,
+            "ProcConnectorEnumerator::connect()",
+            "Could not bind the proc connector (CAP_NET_ADMIN is needed). "
+                "/proc will be rescanned on each update.");
+        disconnect();
+        return false;
+      }
+
+    /* Ask the kernel to send the events */
+    if (!sendMcastOp(_socket, PROC_CN_MCAST_LISTEN))
+      {
+        DebugLog::writeMsg(DebugLog::WARNING,
+            "ProcConnectorEnumerator::connect()",
+            "Could not subscribe to the proc events. /proc will be "
+                "rescanned on each update.");
+        disconnect();
+        return false;
+      }
+
+    /* Events are read without waiting on each update */
+    fcntl(_socket, F_SETFL, fcntl(_socket, F_GETFL) | O_NONBLOCK);
+    _needRescan = true;
+    return true;
+  }
+
+  /** #disconnect */
+  void
+  ProcConnectorEnumerator::disconnect()
+  {
+    if (_socket == -1)
+      return;
+
+    sendMcastOp(_socket, PROC_CN_MCAST_IGNORE);
+    close(_socket);
+    _socket = -1;
+  }
+
+  /** #readEvents */
+  void
+  ProcConnectorEnumerator::readEvents(bool apply)
+  {
+    char buf[8192] __attribute__ ((aligned(NLMSG_ALIGNTO)));
+    ssize_t len;
+
+    if (_socket == -1)
+      return;
+
+    while (true)
+      {
+        len = recv(_socket, buf, sizeof(buf), 0);
+        if (len == -1)
+          {
+            /* Kernel dropped events: the process list may be wrong */
+            if (errno == ENOBUFS)
+              {
+                _needRescan = true;
+                continue;
+              }
+            if (errno == EINTR)
+              continue;
+            /* EAGAIN: nothing more to read */
+            break;
+          }
+        if (len == 0)
+          break;
+        if (!apply)
+          continue;
+
+        for (struct nlmsghdr* nl = (struct nlmsghdr*) buf; NLMSG_OK(nl, len);
+            nl = NLMSG_NEXT(nl, len))
+          {
+            if ((nl->nlmsg_type == NLMSG_ERROR)
+                || (nl->nlmsg_type == NLMSG_NOOP))
+              continue;
+
+            struct cn_msg* cn = (struct cn_msg*) NLMSG_DATA(nl);
+            if ((cn->id.idx != CN_IDX_PROC) || (cn->id.val != CN_VAL_PROC))
+              continue;
+            struct proc_event* ev = (struct proc_event*) cn->data;
+
+            switch (ev->what)
+              {
+            case proc_event::PROC_EVENT_FORK:
+              /* Ignore the new threads */
+              if ((ev->event_data.fork.child_pid
+                  == ev->event_data.fork.child_tgid)
+                  && (getProcessByPID(ev->event_data.fork.child_pid) == 0))
+                addProcess(ev->event_data.fork.child_pid);
+              break;
+            case proc_event::PROC_EVENT_EXEC:
+              /* New name and path: create the process again */
+              if (ev->event_data.exec.process_pid
+                  == ev->event_data.exec.process_tgid)
+                {
+                  removeProcess(ev->event_data.exec.process_pid);
+                  addProcess(ev->event_data.exec.process_pid);
+                }
+              break;
+            case proc_event::PROC_EVENT_EXIT:
+              /* Only the exit of the thread group leader ends a process */
+              if (ev->event_data.exit.process_pid
+                  == ev->event_data.exit.process_tgid)
+                {
+                  removeProcess(ev->event_data.exit.process_pid);
+                  ProcessSampleCache::remove(ev->event_data.exit.process_pid);
+                }
+              break;
+            default:
+              break;
+              }
+          }
+      }
+  }
+
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <libec/process/linux/ProcessSampleCache.h>
+
+namespace cea
+{
+  ///////////////////////////////////////////////////////////////////
+  // Static Members
+  ///////////////////////////////////////////////////////////////////
+  ProcessSampleCache::SampleMap ProcessSampleCache::_samples;
+  unsigned int ProcessSampleCache::_tick = 0;
+  u64 ProcessSampleCache::_readCount = 0;
+
+  /* Read a whole proc/[pid]/<name> file into buf ('\0' terminated) */
+  static ssize_t
+  readProcFile(pid_t pid, const char* name, char* buf, size_t size)
+  {
+    char path[64];
+    ssize_t len;
+    int fd;
+
+    snprintf(path, sizeof(path), "/proc/%d/%s", (int) (pid), name);
+    fd = open(path, O_RDONLY);
+    if (fd == -1)
+      return -1;
+    len = read(fd, buf, size - 1);
+    close(fd);
+    if (len < 0)
+      return -1;
+    buf[len] = '\0';
+    return len;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Public Members
+  ///////////////////////////////////////////////////////////////////
+  /** +beginTick */
+  void
+  ProcessSampleCache::beginTick()
+  {
+    /* Drop the processes not requested during the previous tick */
+    for (SampleMap::iterator it = _samples.begin(); it != _samples.end();)
+      {
+        Sample& s = it->second;
+        if ((s.statTick != _tick) && (s.statmTick != _tick)
+            && (s.ioTick != _tick))
+          _samples.erase(it++);
+        else
+          ++it;
+      }
+
+    /* Advance the tick, 0 is kept for "never ticked" */
+    _tick++;
+    if (_tick == 0)
+      _tick = 1;
+  }
+
+  /** +getTick */
+  unsigned int
+  ProcessSampleCache::getTick()
+  {
+    return _tick;
+  }
+
+  /** +setStat */
+  void
+  ProcessSampleCache::setStat(pid_t pid, const ProcessStat::Snapshot& stat)
+  {
+    Sample& s = getSample(pid);
+    s.stat = stat;
+    s.statTick = _tick;
+  }
+
+  /** +getStat */
+  const ProcessStat::Snapshot*
+  ProcessSampleCache::getStat(pid_t pid)
+  {
+    Sample& s = getSample(pid);
+    if (!isFresh(s.statTick))
+      {
+        s.stat.read(pid);
+        s.statTick = _tick;
+        _readCount++;
+      }
+    return (s.stat.valid) ? &s.stat : NULL;
+  }
+
+  /** +getStatm */
+  const ProcessSampleCache::Statm*
+  ProcessSampleCache::getStatm(pid_t pid)
+  {
+    Sample& s = getSample(pid);
+    if (!isFresh(s.statmTick))
+      {
+        s.statmValid = readStatm(pid, s.statm);
+        s.statmTick = _tick;
+        _readCount++;
+      }
+    return (s.statmValid) ? &s.statm : NULL;
+  }
+
+  /** +getIo */
+  const ProcessSampleCache::Io*
+  ProcessSampleCache::getIo(pid_t pid)
+  {
+    Sample& s = getSample(pid);
+    if (!isFresh(s.ioTick))
+      {
+        s.ioValid = readIo(pid, s.io);
+        s.ioTick = _tick;
+        _readCount++;
+      }
+    return (s.ioValid) ? &s.io : NULL;
+  }
+
+  /** +remove */
+  void
+  ProcessSampleCache::remove(pid_t pid)
+  {
+    _samples.erase(pid);
+  }
+
+  /** +clear */
+  void
+  ProcessSampleCache::clear()
+  {
+    _samples.clear();
+    _tick = 0;
+  }
+
+  /** +getReadCount */
+  u64
+  ProcessSampleCache::getReadCount()
+  {
+    return _readCount;
+  }
+
+  ///////////////////////////////////////////////////////////////////
+  // Protected Members
+  ///////////////////////////////////////////////////////////////////
+  /** #getSample */
+  ProcessSampleCache::Sample&
+  ProcessSampleCache::getSample(pid_t pid)
+  {
+    SampleMap::iterator it = _samples.lower_bound(pid);
+    if ((it == _samples.end()) || (_samples.key_comp()(pid, it->first)))
+      {
+        Sample s;
+        s.statTick = s.statmTick = s.ioTick = 0;
+        s.statmValid = s.ioValid = false;
+        memset(&s.statm, 0, sizeof(s.statm));
+        memset(&s.io, 0, sizeof(s.io));
+        it = _samples.insert(it, SampleMap::value_type(pid, s));
+      }
+    return it->second;
+  }
+
+  /** #isFresh */
+  bool
+  ProcessSampleCache::isFresh(unsigned int tick)
+  {
+    /* Without ticks the cache is disabled */
+    return (_tick != 0) && (tick == _tick);
+  }
+
+  /** #readStatm */
+  bool
+  ProcessSampleCache::readStatm(pid_t pid, Statm& statm)
+  {
+    char buf[256];
+    char* p = buf;
+    u64* field[] =
+      { &statm.size, &statm.resident, &statm.shared, &statm.text, &statm.lib,
+          &statm.data, &statm.dt };
+
+    if (readProcFile(pid, "statm", buf, sizeof(buf)) <= 0)
+      return false;
+
+    for (unsigned int i = 0; i < sizeof(field) / sizeof(field[0]); i++)
+      {
+        char* end;
+        *field[i] = strtoull(p, &end, 10);
+        if (end == p)
+          return (i > 1);
+        p = end;
+      }
+    return true;
+  }
+
+  /** #readIo */
+  bool
+  ProcessSampleCache::readIo(pid_t pid, Io& io)
+  {
+    static const struct
+    {
+      const char* key;
+      size_t offset;
+    } keys[] =
+      {
+        { "rchar:", offsetof(Io, rchar) },
+        { "wchar:", offsetof(Io, wchar) },
+        { "syscr:", offsetof(Io, syscr) },
+        { "syscw:", offsetof(Io, syscw) },
+        { "read_bytes:", offsetof(Io, readBytes) },
+        { "write_bytes:", offsetof(Io, writeBytes) },
+        { "cancelled_write_bytes:", offsetof(Io, cancelledWriteBytes) } };
+    char buf[512];
+    char* line = buf;
+
+    if (readProcFile(pid, "io", buf, sizeof(buf)) <= 0)
+      return false;
+
+    /* One "key: value" per line */
+    while ((line != NULL) && (*line != '\0'))
+      {
+        for (unsigned int i = 0; i < sizeof(keys) / sizeof(keys[0]); i++)
+          {
+            size_t len = strlen(keys[i].key);
+            if (strncmp(line, keys[i].key, len) == 0)
+              {
+                *(u64*) ((char*) (&io) + keys[i].offset) = strtoull(
+                    line + len, NULL, 10);
+                break;
+              }
+          }
+        line = strchr(line, '\n');
+        if (line != NULL)
+          line++;
+      }
+    return true;
+  }
+
+}
@@ -1,103 +1,342 @@
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
 #include <libec/process/linux/ProcessStat.h>
 
 namespace cea
 {
 
-  /** +get */
-  bool
-  ProcessStat::get(pid_t pid, ProcessStat::Field stat, char& c,
-      char defaultValue)
+  /* Type of each proc/[pid]/stat field, indexed by ProcessStat::Field */
+  static const ProcessStat::Type fieldType[] =
+    {
+    /*PID*/ProcessStat::INT,/*COMM*/ProcessStat::STR,
+    /*STATE*/ProcessStat::CHAR,/*PPID*/ProcessStat::INT,
+    /*PGRP*/ProcessStat::INT,/*SESSION*/ProcessStat::INT,
+    /*TTY_NR*/ProcessStat::INT,/*TPGID*/ProcessStat::INT,
+    /*FLAGS*/ProcessStat::UINT,/*MINFLT*/ProcessStat::LUINT,
+    /*CMINFLT*/ProcessStat::LUINT,/*MAJFLT*/ProcessStat::LUINT,
+    /*CMAJFLT*/ProcessStat::LUINT,/*UTIME*/ProcessStat::LUINT,
+    /*STIME*/ProcessStat::LUINT,/*CUTIME*/ProcessStat::LINT,
+    /*CSTIME*/ProcessStat::LINT,/*PRIORITY*/ProcessStat::LINT,
+    /*NICE*/ProcessStat::LINT,/*NUM_THREADS*/ProcessStat::LINT,
+    /*ITREALVALUE*/ProcessStat::LINT,/*STARTTIME*/ProcessStat::LLUINT,
+    /*VSIZE*/ProcessStat::LUINT,/*RSS*/ProcessStat::LINT,
+    /*RSSLIM*/ProcessStat::LUINT,/*STARTCODE*/ProcessStat::LUINT,
+    /*ENDCODE*/ProcessStat::LUINT,/*STARTSTACK*/ProcessStat::LUINT,
+    /*KSTKESP*/ProcessStat::LUINT,/*KSTKEIP*/ProcessStat::LUINT,
+    /*SIGNAL*/ProcessStat::LUINT,/*BLOCKED*/ProcessStat::LUINT,
+    /*SIGIGNORE*/ProcessStat::LUINT,/*SIGCATCH*/ProcessStat::LUINT,
+    /*WCHAN*/ProcessStat::LUINT,/*NSWAP*/ProcessStat::LUINT,
+    /*CNSWAP*/ProcessStat::LUINT,/*EXIT_SIGNAL*/ProcessStat::INT,
+    /*PROCESSOR*/ProcessStat::INT,/*RT_PRIORITY*/ProcessStat::UINT,
+    /*POLICY*/ProcessStat::UINT,/*DELAYACCT_BLKIO_TICKS*/ProcessStat::LLUINT,
+    /*GUEST_TIME*/ProcessStat::LUINT,/*CGUEST_TIME*/ProcessStat::LINT };
+
+  /* Scan one integer token, advance the pointer after it */
+  static bool
+  scanInteger(const char*& p, long long int& value)
   {
-    Value v = getValue(pid, stat);
-    if (v.type == CHAR)
+    bool negative = false;
+    unsigned long long int v = 0;
+
+    if (*p == '-')
       {
-        c = v.v.c;
-        return true;
+        negative = true;
+        p++;
       }
-    else
+    if ((*p < '0') || (*p > '9'))
+      return false;
+    for (; (*p >= '0') && (*p <= '9'); p++)
+      v = v * 10 + (*p - '0');
+
+    value = (negative) ? -(long long int) (v) : (long long int) (v);
+    return true;
+  }
+
+  /** Snapshot constructor */
+  ProcessStat::Snapshot::Snapshot() :
+      pid(0), valid(false), count(0)
+  {
+    comm[0] = '\0';
+    for (unsigned int i = 0; i < ProcStatFieldCount; i++)
       {
-        c = defaultValue;
-        return false;
+        field[i].type = UNKNOWN;
+        field[i].v.llu = 0;
       }
   }
+
+  /** +Snapshot::read */
   bool
-  ProcessStat::get(pid_t pid, ProcessStat::Field stat, int& d, int defaultValue)
+  ProcessStat::Snapshot::read(pid_t pid)
   {
-    Value v = getValue(pid, stat);
-    if (v.type == INT)
-      {
-        d = v.v.d;
-        return true;
-      }
-    else
+    char path[32];
+    char data[2048];
+    ssize_t len;
+    int fd;
+
+    valid = false;
+    count = 0;
+
+    /* One open/read/close for the whole file */
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int) (pid));
+    fd = open(path, O_RDONLY);
+    if (fd == -1)
+      return false;
+    len = ::read(fd, data, sizeof(data) - 1);
+    close(fd);
+    if (len <= 0)
+      return false;
+    data[len] = '\0';
+
+    return parse(data);
+  }
+
+  /** +Snapshot::parse */
+  bool
+  ProcessStat::Snapshot::parse(const char* data)
+  {
+    const char* p = data;
+    const char* open;
+    const char* close;
+    long long int v;
+    size_t len;
+
+    valid = false;
+    count = 0;
+
+    /* PID */
+    if (!scanInteger(p, v))
+      return false;
+    pid = (pid_t) (v);
+    field[PID].type = INT;
+    field[PID].v.d = (int) (v);
+
+    /* COMM is between the first '(' and the last ')' */
+    open = strchr(p, '(');
+    close = strrchr(p, ')');
+    if ((open == NULL) || (close == NULL) || (close < open))
+      return false;
+    len = close - open - 1;
+    if (len >= COMM_MAX)
+      len = COMM_MAX - 1;
+    memcpy(comm, open + 1, len);
+    comm[len] = '\0';
+    field[COMM].type = STR;
+    field[COMM].v.llu = 0;
+    count = COMM + 1;
+
+    /* Remaining fields are separated by a single space */
+    p = close + 1;
+    for (unsigned int i = STATE; i < ProcStatFieldCount; i++)
       {
-        d = defaultValue;
-        return false;
+        if (*p != ' ')
+          break;
+        p++;
+
+        Value& value = field[i];
+        value.type = fieldType[i];
+        if (value.type == CHAR)
+          {
+            if ((*p == '\0') || (*p == ' ') || (*p == '\n'))
+              break;
+            value.v.c = *p++;
+          }
+        else
+          {
+            if (!scanInteger(p, v))
+              break;
+            switch (value.type)
+              {
+            case INT:
+              value.v.d = (int) (v);
+              break;
+            case UINT:
+              value.v.u = (unsigned int) (v);
+              break;
+            case LINT:
+              value.v.ld = (long int) (v);
+              break;
+            case LUINT:
+              value.v.lu = (long unsigned int) (v);
+              break;
+            default:
+              value.v.llu = (long long unsigned int) (v);
+              break;
+              }
+          }
+        count = i + 1;
       }
+
+    /* Mark the fields not present in this kernel as unknown */
+    for (unsigned int i = count; i < ProcStatFieldCount; i++)
+      field[i].type = UNKNOWN;
+
+    valid = true;
+    return true;
   }
+
+  /** +get (snapshot) */
   bool
-  ProcessStat::get(pid_t pid, ProcessStat::Field stat, unsigned int& u,
-      unsigned int defaultValue)
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat, char& c,
+      char defaultValue)
   {
-    Value v = getValue(pid, stat);
-    if (v.type == UINT)
+    if (snap.valid && (stat < snap.count) && (snap.field[stat].type == CHAR))
       {
-        u = v.v.u;
+        c = snap.field[stat].v.c;
         return true;
       }
-    else
-      {
-        u = defaultValue;
-        return false;
-      }
+    c = defaultValue;
+    return false;
   }
   bool
-  ProcessStat::get(pid_t pid, ProcessStat::Field stat, long int& ld,
-      long int defaultValue)
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat, int& d,
+      int defaultValue)
   {
-    Value v = getValue(pid, stat);
-    if (v.type == LINT)
+    if (snap.valid && (stat < snap.count) && (snap.field[stat].type == INT))
       {
-        ld = v.v.ld;
+        d = snap.field[stat].v.d;
         return true;
       }
-    else
+    d = defaultValue;
+    return false;
+  }
+  bool
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat,
+      unsigned int& u, unsigned int defaultValue)
+  {
+    if (snap.valid && (stat < snap.count) && (snap.field[stat].type == UINT))
       {
-        ld = defaultValue;
-        return false;
+        u = snap.field[stat].v.u;
+        return true;
       }
+    u = defaultValue;
+    return false;
   }
   bool
-  ProcessStat::get(pid_t pid, ProcessStat::Field stat, long unsigned int& lu,
-      long unsigned int defaultValue)
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat,
+      long int& ld, long int defaultValue)
   {
-    Value v = getValue(pid, stat);
-    if (v.type == LUINT)
+    if (snap.valid && (stat < snap.count) && (snap.field[stat].type == LINT))
       {
-        lu = v.v.lu;
+        ld = snap.field[stat].v.ld;
         return true;
       }
-    else
+    ld = defaultValue;
+    return false;
+  }
+  bool
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat,
+      long unsigned int& lu, long unsigned int defaultValue)
+  {
+    if (snap.valid && (stat < snap.count) && (snap.field[stat].type == LUINT))
       {
-        lu = defaultValue;
-        return false;
+        lu = snap.field[stat].v.lu;
+        return true;
       }
+    lu = defaultValue;
+    return false;
   }
   bool
-  ProcessStat::get(pid_t pid, ProcessStat::Field stat,
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat,
       long long unsigned int& llu, long long unsigned int defaultValue)
   {
-    Value v = getValue(pid, stat);
-    if (v.type == LLUINT)
+    if (snap.valid && (stat < snap.count)
+        && (snap.field[stat].type == LLUINT))
       {
-        llu = v.v.llu;
+        llu = snap.field[stat].v.llu;
         return true;
       }
-    else
+    llu = defaultValue;
+    return false;
+  }
+  bool
+  ProcessStat::get(const Snapshot& snap, ProcessStat::Field stat,
+      std::string& s, const std::string& defaultValue)
+  {
+    if (!snap.valid || (stat >= snap.count))
       {
-        llu = defaultValue;
+        s.assign(defaultValue);
         return false;
       }
+    switch (snap.field[stat].type)
+      {
+    case STR:
+      s.assign(snap.comm);
+      break;
+    case CHAR:
+      s.assign(1, snap.field[stat].v.c);
+      break;
+    case INT:
+      s = Tools::CStr(snap.field[stat].v.d);
+      break;
+    case UINT:
+      s = Tools::CStr(snap.field[stat].v.u);
+      break;
+    case LINT:
+      s = Tools::CStr(snap.field[stat].v.ld);
+      break;
+    case LUINT:
+      s = Tools::CStr(snap.field[stat].v.lu);
+      break;
+    case LLUINT:
+      s = Tools::CStr(snap.field[stat].v.llu);
+      break;
+    default:
+      s.assign(defaultValue);
+      return false;
+      }
+    return true;
+  }
+
+  /** +get */
+  bool
+  ProcessStat::get(pid_t pid, ProcessStat::Field stat, char& c,
+      char defaultValue)
+  {
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, c, defaultValue);
+  }
+  bool
+  ProcessStat::get(pid_t pid, ProcessStat::Field stat, int& d, int defaultValue)
+  {
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, d, defaultValue);
+  }
+  bool
+  ProcessStat::get(pid_t pid, ProcessStat::Field stat, unsigned int& u,
+      unsigned int defaultValue)
+  {
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, u, defaultValue);
+  }
+  bool
+  ProcessStat::get(pid_t pid, ProcessStat::Field stat, long int& ld,
+      long int defaultValue)
+  {
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, ld, defaultValue);
+  }
+  bool
+  ProcessStat::get(pid_t pid, ProcessStat::Field stat, long unsigned int& lu,
+      long unsigned int defaultValue)
+  {
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, lu, defaultValue);
+  }
+  bool
+  ProcessStat::get(pid_t pid, ProcessStat::Field stat,
+      long long unsigned int& llu, long long unsigned int defaultValue)
+  {
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, llu, defaultValue);
   }
   bool
   ProcessStat::get(pid_t pid, ProcessStat::Field stat, std::string& s,
@@ -118,57 +357,18 @@ namespace cea
   ProcessStat::Value
   ProcessStat::getValue(pid_t pid, ProcessStat::Field stat)
   {
-    /* Variable for Optimization */
-    static Type fieldType[] =
-      {
-      /*PID*/INT,/*COMM*/STR,/*STATE*/CHAR,/*PPID*/INT,/*PGRP*/INT,
-      /*SESSION*/INT,/*TTY_NR*/INT,/*TPGID*/INT,/*FLAGS*/UINT,
-      /*MINFLT*/LUINT,/*CMINFLT*/LUINT,/*MAJFLT*/LUINT,/*CMAJFLT*/LUINT,
-      /*UTIME*/LUINT,/*STIME*/LUINT,/*CUTIME*/LINT,/*CSTIME*/LINT,
-      /*PRIORITY*/LINT,/*NICE*/LINT,/*NUM_THREADS*/LINT,
-      /*ITREALVALUE*/LINT,/*STARTTIME*/LLUINT,/*VSIZE*/LUINT,/*RSS*/LINT,
-      /*RSSLIM*/LUINT,/*STARTCODE*/LUINT,/*ENDCODE*/LUINT,
-      /*STARTSTACK*/LUINT,/*KSTKESP*/LUINT,/*KSTKEIP*/LUINT,
-      /*SIGNAL*/LUINT,/*BLOCKED*/LUINT,/*SIGIGNORE*/LUINT,
-      /*SIGCATCH*/LUINT,/*WCHAN*/LUINT,/*NSWAP*/LUINT,/*CNSWAP*/LUINT,
-      /*EXIT_SIGNAL*/INT,/*PROCESSOR*/INT,/*RT_PRIORITY*/UINT,
-      /*POLICY*/UINT,/*DELAYACCT_BLKIO_TICKS*/LLUINT,/*GUEST_TIME*/LUINT,
-      /*CGUEST_TIME*/LINT };
-    /* Get the String value */
-    std::string str = getStr(pid, stat);
-    /* Initialize the value variable */
     Value value;
     value.type = UNKNOWN;
-    /* Avoid to exceed the fieldType table */
-    unsigned int fieldId = (unsigned int) (stat);
-    if (fieldId >= sizeof(fieldType) / sizeof(Type))
+    value.v.llu = 0;
+
+    /* Avoid to exceed the field table */
+    if ((unsigned int) (stat) >= ProcStatFieldCount)
       return value;
-    /* Get the correct type value */
-    value.type = fieldType[fieldId];
-    switch (fieldType[fieldId])
-      {
-    case CHAR:
-      Tools::CStrTo(str, value.v.c);
-      break;
-    case INT:
-      Tools::CStrTo(str, value.v.d);
-      break;
-    case UINT:
-      Tools::CStrTo(str, value.v.u);
-      break;
-    case LINT:
-      Tools::CStrTo(str, value.v.ld);
-      break;
-    case LUINT:
-      Tools::CStrTo(str, value.v.lu);
-      break;
-    case LLUINT:
-      Tools::CStrTo(str, value.v.llu);
-      break;
-    default:
-      break;
-      };
-    /* Return the value */
+
+    Snapshot snap;
+    if (snap.read(pid) && ((unsigned int) (stat) < snap.count))
+      value = snap.field[stat];
+
     return value;
   }
 
@@ -183,106 +383,23 @@ namespace cea
     return result;
   }
 
+  /** +getType */
+  ProcessStat::Type
+  ProcessStat::getType(ProcessStat::Field stat)
+  {
+    if ((unsigned int) (stat) >= ProcStatFieldCount)
+      return UNKNOWN;
+    return fieldType[stat];
+  }
+
   /** #getStrValue */
   bool
   ProcessStat::getStrValue(pid_t pid, ProcessStat::Field stat,
       std::string& retString)
   {
-    /* Open the cmdline file */
-    std::string file = "/proc/" + Tools::CStr(pid) + "/stat";
-    std::ifstream f(file.c_str());
-    std::string data;
-
-    /* If Opened extract Path */
-    if (f.is_open())
-      {
-        /* Get the first line */
-        if (f.good())
-          std::getline(f, data);
-        /* Close the file */
-        f.close();
-      }
-
-    /* Set the variable */
-    unsigned int max = data.length();
-    int fieldId = (int) (ProcStatFieldCount) - (int) (stat);
-
-    /* Search the  value */
-    if (stat == PID)
-      {
-        /* Found the first ' ' */
-        unsigned int end = 0;
-        for (; end < max; end++)
-          {
-            if (data[end] == ' ')
-              break;
-          }
-        /* Return the value */
-        retString.assign(data, 0, end);
-        return true;
-      }
-    else if (stat == COMM)
-      {
-        /* Get the name */
-        unsigned int start = 0;
-        /* Found the first '(' */
-        for (; start < max; start++)
-          {
-            if (data[start] == '(')
-              {
-                start++;
-                break;
-              }
-          }
-        /* Found the last ')' */
-        for (; max > start; max--)
-          {
-            if (data[max] == ')')
-              break;
-          }
-        /* Return the name*/
-        retString.assign(data, start, max - start);
-        return true;
-      }
-    else
-      {
-        /* Get the field after COMM field */
-        unsigned int oldTok = max, tok = max;
-        for (; tok > 0; tok--)
-          {
-            switch (data[tok])
-              {
-            case ')': /* reach the end of research */
-              if (fieldId == 1)
-                {
-                  /* Field found */
-                  retString.assign(data, tok + 1, oldTok - tok);
-                  return true;
-                }
-              else
-                {
-                  return false;
-                }
-              break;
-            case ' ': /* new token */
-              fieldId--;
-              if (fieldId == 0)
-                {
-                  /* Field found */
-                  retString.assign(data, tok + 1, oldTok - tok);
-                  return true;
-                }
-              else
-                {
-                  /* Advance the token */
-                  oldTok = tok - 1;
-                }
-              break;
-              }
-          }
-      }
-    /* Not found by default */
-    return false;
+    Snapshot snap;
+    snap.read(pid);
+    return get(snap, stat, retString);
   }
 
 }
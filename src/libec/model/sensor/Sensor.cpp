@@ -84,6 +84,7 @@ namespace cea
     XMLReader::readAttributeFromTag(sensorXmlTag, "sensor", "name", _name);
     XMLReader::readAttributeFromTag(sensorXmlTag, "sensor", "alias", _alias);
     XMLReader::readSingleValuedTag(sensorXmlTag, "latency", _latency);
+    XMLReader::readSingleValuedTag(sensorXmlTag, "period", _period);
   }
 
   const char*
@@ -111,6 +112,8 @@ namespace cea
     ss << ">" << std::endl;
     ss << "  <params>" << std::endl;
     ss << "    <latency value=\"" << _latency << "\"/>" << std::endl;
+    if (_period > 0)
+      ss << "    <period value=\"" << _period << "\"/>" << std::endl;
     ss << getParamsXml("    ");
     ss << "  </params>" << std::endl;
     ss << "</sensor>" << std::endl;
@@ -154,6 +157,18 @@ namespace cea
     return _cValue;
   }
 
+  unsigned int
+  Sensor::getPeriod() const
+  {
+    return _period;
+  }
+
+  void
+  Sensor::setPeriod(unsigned int period)
+  {
+    _period = period;
+  }
+
   bool
   Sensor::needUpdate(const struct timeval &tv_now,
       const struct timeval &tv_prev)
@@ -166,6 +181,7 @@ namespace cea
   {
     _alias = _name = "";
     _latency = 0;
+    _period = 0;
     _isActive = false;
     _type = Unknown;
     _cTime = _pTime = 0;
@@ -181,6 +197,7 @@ namespace cea
     _alias = source._alias;
     _name = source._name;
     _latency = source._latency;
+    _period = source._period;
     _isActive = source._isActive;
     _type = source._type;
     _cValue = source._cValue;
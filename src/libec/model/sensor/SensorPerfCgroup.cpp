@@ -0,0 +1,327 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <mntent.h>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/device/SystemInfo.h>
+#include <libec/sensor/SensorPerfCount.h>
+#include <libec/sensor/SensorPerfCgroup.h>
+
+namespace cea
+{
+  PerfCgroup::PerfCgroup(u32 type, u64 config)
+  {
+    _type = U64;
+    _cValue.U64 = 0;
+    _count = 0;
+
+    std::memset(&_attr, 0, sizeof(_attr));
+    _attr.size = sizeof(_attr);
+    _attr.type = type;
+    _attr.config = config;
+    _attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    if (PerfCount::getEventName(type, config, _name, _alias))
+      {
+        _name += "_CGROUP";
+        _alias += "_cg";
+      }
+
+    _isActive = !getCgroupRoot().empty();
+    if (!_isActive)
+      DebugLog::writeMsg(DebugLog::WARNING, "PerfCgroup::PerfCgroup()",
+          "cgroup v2 is not mounted");
+
+    registerState(sizeof(PidState));
+  }
+
+  PerfCgroup::~PerfCgroup()
+  {
+    for (unsigned int i = 0; i < _cgroups.size(); i++)
+      closeCgroup(i);
+  }
+
+  unsigned int
+  PerfCgroup::getCgroupCount() const
+  {
+    return _count;
+  }
+
+  unsigned int
+  PerfCgroup::getFdCount() const
+  {
+    unsigned int n = 0;
+
+    for (unsigned int i = 0; i < _cgroups.size(); i++)
+      if (_cgroups[i] != NULL)
+        for (unsigned int c = 0; c < _cgroups[i]->fd.size(); c++)
+          n += (_cgroups[i]->fd[c] >= 0);
+
+    return n;
+  }
+
+  const std::string&
+  PerfCgroup::getCgroupRoot()
+  {
+    static std::string root;
+    static bool found = false;
+
+    if (!found)
+      {
+        found = true;
+
+        ::FILE* mounts = setmntent("/proc/mounts", "r");
+        struct mntent* ent;
+        while ((mounts != NULL) && ((ent = getmntent(mounts)) != NULL))
+          {
+            if (std::strcmp(ent->mnt_type, "cgroup2") == 0)
+              {
+                root = ent->mnt_dir;
+                break;
+              }
+          }
+        if (mounts != NULL)
+          endmntent(mounts);
+      }
+
+    return root;
+  }
+
+  bool
+  PerfCgroup::getPidCgroup(pid_t pid, std::string &path)
+  {
+    char fname[64], line[4096];
+    bool found = false;
+
+    snprintf(fname, sizeof(fname), "/proc/%d/cgroup", pid);
+    ::FILE* f = fopen(fname, "r");
+    if (f == NULL)
+      return false;
+
+    // the cgroup v2 line is "0::/path"
+    while (!found && (fgets(line, sizeof(line), f) != NULL))
+      {
+        if (std::strncmp(line, "0::", 3) != 0)
+          continue;
+
+        path = line + 3;
+        if (!path.empty() && (path[path.size() - 1] == '\n'))
+          path.erase(path.size() - 1);
+        found = true;
+      }
+    fclose(f);
+
+    return found;
+  }
+
+  int
+  PerfCgroup::openCgroup(const std::string &path)
+  {
+    std::map<std::string, int>::iterator it = _index.find(path);
+    if (it != _index.end())
+      return it->second;
+
+    std::string dir = getCgroupRoot() + path;
+    int dirFd = open(dir.c_str(), O_RDONLY);
+    if (dirFd < 0)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "PerfCgroup::openCgroup()",
+            "cgroup '%s' could not be opened", dir.c_str());
+        return -1;
+      }
+
+    Cgroup* cg = new Cgroup;
+    cg->path = path;
+    cg->dirFd = dirFd;
+    cg->value = 0;
+    cg->seq = 0;
+    cg->pids = 0;
+
+    // cgroup counters can only be opened per CPU
+    CpuInfo* cpuInfo = SystemInfo::getCpuInfo();
+    int cpus = cpuInfo->getCpuCount();
+    cg->fd.assign(cpus, -1);
+    cg->raw.assign(cpus, 0);
+    cg->rawEna.assign(cpus, 0);
+    cg->rawRun.assign(cpus, 0);
+    for (int c = 0; c < cpus; c++)
+      {
+        if (cpuInfo->isOnline(c))
+          cg->fd[c] = perf_event_open(&_attr, dirFd, c, -1,
+              PERF_FLAG_PID_CGROUP);
+      }
+
+    // reuse a free position
+    int id = -1;
+    for (unsigned int i = 0; (id == -1) && (i < _cgroups.size()); i++)
+      if (_cgroups[i] == NULL)
+        id = i;
+    if (id == -1)
+      {
+        id = _cgroups.size();
+        _cgroups.push_back(NULL);
+      }
+
+    _cgroups[id] = cg;
+    _index[path] = id;
+    _count++;
+
+    // start the first period
+    readCgroup(*cg);
+    cg->value = 0;
+
+    return id;
+  }
+
+  void
+  PerfCgroup::closeCgroup(int id)
+  {
+    Cgroup* cg = _cgroups[id];
+    if (cg == NULL)
+      return;
+
+    for (unsigned int c = 0; c < cg->fd.size(); c++)
+      if (cg->fd[c] >= 0)
+        close(cg->fd[c]);
+    close(cg->dirFd);
+
+    _index.erase(cg->path);
+    delete cg;
+    _cgroups[id] = NULL;
+    _count--;
+  }
+
+  void
+  PerfCgroup::readCgroup(Cgroup &cg)
+  {
+    // value, time enabled, time running
+    u64 tmp[3];
+
+    cg.value = 0;
+    for (unsigned int c = 0; c < cg.fd.size(); c++)
+      {
+        if ((cg.fd[c] < 0)
+            || (read(cg.fd[c], tmp, sizeof(tmp)) < (ssize_t) sizeof(tmp)))
+          continue;
+
+        cg.value += PerfCount::scaleValue(tmp[0] - cg.raw[c],
+            tmp[1] - cg.rawEna[c], tmp[2] - cg.rawRun[c]);
+        cg.raw[c] = tmp[0];
+        cg.rawEna[c] = tmp[1];
+        cg.rawRun[c] = tmp[2];
+      }
+
+    cg.seq++;
+  }
+
+  bool
+  PerfCgroup::hasDescendant(const std::string &path) const
+  {
+    // the descendants of "/a" are the paths from "/a/", the ones of the
+    // root all the other paths
+    std::string prefix = (path == "/") ? path : path + "/";
+    std::map<std::string, int>::const_iterator it = _index.lower_bound(prefix);
+    if ((it != _index.end()) && (it->first == path))
+      it++;
+
+    return (it != _index.end())
+        && (it->first.compare(0, prefix.size(), prefix) == 0);
+  }
+
+  PerfCgroup::Cgroup*
+  PerfCgroup::getCgroup(pid_t pid)
+  {
+    PidState* st = findState<PidState>(pid);
+    if ((st == NULL) || (st->cgroup <= 0))
+      return NULL;
+
+    return _cgroups[st->cgroup - 1];
+  }
+
+  void
+  PerfCgroup::update()
+  {
+    // a cgroup counts its descendants too: only the leaves are summed
+    _cValue.U64 = 0;
+    for (unsigned int i = 0; i < _cgroups.size(); i++)
+      if (_cgroups[i] != NULL)
+        {
+          readCgroup(*_cgroups[i]);
+          if (!hasDescendant(_cgroups[i]->path))
+            _cValue.U64 += _cgroups[i]->value;
+        }
+  }
+
+  sensor_t
+  PerfCgroup::getValue()
+  {
+    return _cValue;
+  }
+
+  void
+  PerfCgroup::updatePid(pid_t pid)
+  {
+    if (pid <= 0)
+      return;
+
+    add(pid);
+    PidState* st = getState<PidState>(pid);
+    Cgroup* cg = getCgroup(pid);
+    if (cg == NULL)
+      return;
+
+    // the first process of the cgroup updated in a tick reads it, the
+    // others use the values read
+    if (st->seq == cg->seq)
+      readCgroup(*cg);
+    st->seq = cg->seq;
+  }
+
+  sensor_t
+  PerfCgroup::getValuePid(pid_t pid)
+  {
+    sensor_t ret;
+
+    add(pid);
+    Cgroup* cg = getCgroup(pid);
+    ret.U64 = (cg != NULL) ? cg->value : 0;
+
+    return ret;
+  }
+
+  void
+  PerfCgroup::add(pid_t pid)
+  {
+    PidState* st = getState<PidState>(pid);
+    if ((st->cgroup != 0) || !_isActive)
+      return;
+
+    std::string path;
+    int id = -1;
+    if (getPidCgroup(pid, path))
+      id = openCgroup(path);
+
+    // -1 is kept when the cgroup could not be counted, not to look it up
+    // again at each tick
+    st->cgroup = (id >= 0) ? id + 1 : -1;
+    if (id < 0)
+      return;
+
+    _cgroups[id]->pids++;
+    st->seq = _cgroups[id]->seq;
+  }
+
+  void
+  PerfCgroup::remove(pid_t pid)
+  {
+    Cgroup* cg = getCgroup(pid);
+    if ((cg != NULL) && (--cg->pids == 0))
+      closeCgroup(findState<PidState>(pid)->cgroup - 1);
+
+    PIDSensor::remove(pid);
+  }
+
+}
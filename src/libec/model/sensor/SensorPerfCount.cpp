@@ -17,6 +17,7 @@
 #include <libec/tools/Tools.h>
 #include <libec/sensor/Sensor.h>
 #include <libec/sensor/SensorPerfCount.h>
+#include <libec/device/SystemInfo.h>
 
 #define LEN(a) sizeof(a) / sizeof(a[0]);
 
@@ -45,7 +46,9 @@ namespace cea
         "PERF_COUNT_HW_BUS_CYCLES", "PERF_COUNT_HW_STALLED_CYCLES_FRONTEND",
         "PERF_COUNT_HW_STALLED_CYCLES_BACKEND", "PERF_COUNT_HW_REF_CPU_CYCLES" };
 
-  PerfCount::PerfCount(u32 type_id, u64 config, int core_id)
+  bool
+  PerfCount::getEventName(u32 type, u64 config, std::string &name,
+      std::string &alias)
   {
     // Array of performance counter names and alias according to their
     // type and config inputs
@@ -87,30 +90,22 @@ namespace cea
     static char hwCacheOpResultAlias[] =
       { 'A', 'M' };
 
-    _type = U64;
-    _cValue.U64 = 0;
-    _pValue.U64 = 0;
-
-    std::memset(&_attr, 0, sizeof(_attr));
-    _attr.type = type_id;
-    _attr.config = config;
-
-    _cpus_total = sysconf(_SC_NPROCESSORS_ONLN);
-    _cpu_id = core_id;
+    bool known = false;
 
-    switch (type_id)
+    switch (type)
       {
     case 0: //PERF_TYPE_HARDWARE
       {
         if (config < (sizeof(hwName) / sizeof(std::string)))
           {
-            _name = hwName[config] + "_" + Tools::CStr(_cpu_id);
-            _alias = hwAlias[config] + "_" + Tools::CStr(_cpu_id);
+            name = hwName[config];
+            alias = hwAlias[config];
+            known = true;
           }
         else
           {
-            _name = "UNKNOWN";
-            _alias = "Unkn";
+            name = "UNKNOWN";
+            alias = "Unkn";
           }
         break;
       }
@@ -119,13 +114,14 @@ namespace cea
       {
         if (config < (sizeof(swName) / sizeof(std::string)))
           {
-            _name = swName[config] + "_" + Tools::CStr(_cpu_id);
-            _alias = swAlias[config] + "_" + Tools::CStr(_cpu_id);
+            name = swName[config];
+            alias = swAlias[config];
+            known = true;
           }
         else
           {
-            _name = "UNKNOWN";
-            _alias = "Unkn";
+            name = "UNKNOWN";
+            alias = "Unkn";
           }
         break;
       }
@@ -148,22 +144,20 @@ namespace cea
         if ((perf_hw_cache_id < 7) && (perf_hw_cache_op_id < 3)
             && (perf_hw_cache_op_result_id < 2))
           {
-            _name = hwCacheName[perf_hw_cache_id];
-            _alias = hwCacheAlias[perf_hw_cache_id];
-
-            _name += hwCacheOpName[perf_hw_cache_op_id];
-            _alias += hwCacheOpAlias[perf_hw_cache_op_id];
+            name = hwCacheName[perf_hw_cache_id];
+            alias = hwCacheAlias[perf_hw_cache_id];
 
-            _name += hwCacheOpResultName[perf_hw_cache_op_result_id];
-            _alias += hwCacheOpResultAlias[perf_hw_cache_op_result_id];
+            name += hwCacheOpName[perf_hw_cache_op_id];
+            alias += hwCacheOpAlias[perf_hw_cache_op_id];
 
-            _name += "_" + Tools::CStr(_cpu_id);
-            _alias += "_" + Tools::CStr(_cpu_id);
+            name += hwCacheOpResultName[perf_hw_cache_op_result_id];
+            alias += hwCacheOpResultAlias[perf_hw_cache_op_result_id];
+            known = true;
           }
         else
           {
-            _name = "UNKNOWN";
-            _alias = "Unkn";
+            name = "UNKNOWN";
+            alias = "Unkn";
           }
 
         break;
@@ -180,41 +174,116 @@ namespace cea
       }
     default:
       {
-        _name = "UNKNOWN";
-        _alias = "Unkn";
+        name = "UNKNOWN";
+        alias = "Unkn";
         break;
       }
       }
 
-    // initialize node related file descriptors
+    return known;
+  }
+
+  PerfCount::PerfCount(u32 type_id, u64 config, int core_id)
+  {
+    _type = U64;
+    _cValue.U64 = 0;
+    _pValue.U64 = 0;
+
+    std::memset(&_attr, 0, sizeof(_attr));
+    _attr.type = type_id;
+    _attr.config = config;
+    // times to scale the value when the counter is multiplexed
+    _attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    CpuInfo* cpuInfo = SystemInfo::getCpuInfo();
+    cpuInfo->updateOnline();
+
+    _cpus_total = cpuInfo->getCpuCount();
+    _online_seq = cpuInfo->getOnlineSeq();
+    _cpu_id = core_id;
+
+    if (getEventName(type_id, config, _name, _alias))
+      {
+        _name += "_" + Tools::CStr(_cpu_id);
+        _alias += "_" + Tools::CStr(_cpu_id);
+      }
+
+    // initialize node related file descriptors, one per online CPU,
     // and check if performance counter is present in the hardware
     _nArr = new hpc_ent[_cpus_total];
-    _isActive = true;
+    _isActive = false;
 
     for (int i = 0; i < _cpus_total; i++)
       {
-        struct hpc_ent v;
-//        v.fd = sys_perf_event_open(&_attr, -1, 0, -1, 0);
-        v.fd = perf_event_open(&_attr, -1, 0, -1, 0);
-        v.pVal = v.cVal = 0;
-        _nArr[i] = v;
+        std::memset(&_nArr[i], 0, sizeof(hpc_ent));
+        _nArr[i].fd = -1;
+
+        if (((_cpu_id == -1) || (_cpu_id == i)) && cpuInfo->isOnline(i))
+          openCpu(i);
 
-        _isActive &= (v.fd >= 0);
+        _isActive |= (_nArr[i].fd >= 0);
       }
+
+    registerState(sizeof(hpc_ent));
   }
 
   PerfCount::~PerfCount()
   {
-    while (_pidMap.begin() != _pidMap.end())
-      {
-        std::map<pid_t, hpc_ent>::iterator it = _pidMap.begin();
-        pid_t pid = it->first;
-        remove(pid);
-      }
+    std::vector<pid_t> pids;
+
+    PidStateSlab::getPids(pids);
+    for (unsigned int i = 0; i < pids.size(); i++)
+      remove(pids[i]);
+
+    for (int i = 0; i < _cpus_total; i++)
+      closeCpu(i);
 
     delete[] _nArr;
   }
 
+  void
+  PerfCount::openCpu(int cpu)
+  {
+    std::memset(&_nArr[cpu], 0, sizeof(hpc_ent));
+    _nArr[cpu].fd = perf_event_open(&_attr, -1, cpu, -1, 0);
+  }
+
+  void
+  PerfCount::closeCpu(int cpu)
+  {
+    if (_nArr[cpu].fd >= 0)
+      close(_nArr[cpu].fd);
+    std::memset(&_nArr[cpu], 0, sizeof(hpc_ent));
+    _nArr[cpu].fd = -1;
+  }
+
+  void
+  PerfCount::updateCpus()
+  {
+    CpuInfo* cpuInfo = SystemInfo::getCpuInfo();
+
+    cpuInfo->updateOnline();
+    if (cpuInfo->getOnlineSeq() == _online_seq)
+      return;
+    _online_seq = cpuInfo->getOnlineSeq();
+
+    for (int i = 0; i < _cpus_total; i++)
+      {
+        if ((_cpu_id != -1) && (_cpu_id != i))
+          continue;
+
+        bool online = cpuInfo->isOnline(i);
+
+        // counters of an offline CPU stop for good, they are reopened (from
+        // zero) when the CPU is brought back
+        if (!online)
+          closeCpu(i);
+        else if (_nArr[i].fd < 0)
+          openCpu(i);
+      }
+  }
+
   int
   PerfCount::openfd(pid_t pid)
   {
@@ -232,76 +301,104 @@ namespace cea
     return NULL;
   }
 
-  u64
-  PerfCount::readPC(int fd)
+  bool
+  PerfCount::readPC(hpc_ent &ent)
   {
-    u64 tmp = 0ull;
+    // value, time enabled, time running
+    u64 tmp[3];
+
+    ent.pVal = ent.cVal;
+    ent.pEna = ent.cEna;
+    ent.pRun = ent.cRun;
 
-    if (read(fd, &tmp, sizeof(tmp)) < 0)
+    if (read(ent.fd, tmp, sizeof(tmp)) < (ssize_t) sizeof(tmp))
       {
         std::cerr << "error: performance counter [" << this->_alias
             << "] could not read.";
-        return NULL;
+        return false;
       }
-    else
-      return tmp;
+
+    ent.cVal = tmp[0];
+    ent.cEna = tmp[1];
+    ent.cRun = tmp[2];
+    return true;
+  }
+
+  u64
+  PerfCount::scale(const hpc_ent &ent)
+  {
+    return scaleValue(ent.cVal - ent.pVal, ent.cEna - ent.pEna,
+        ent.cRun - ent.pRun);
+  }
+
+  u64
+  PerfCount::scaleValue(u64 val, u64 ena, u64 run)
+  {
+    // not multiplexed
+    if (run == ena)
+      return val;
+    // not scheduled at all during the period
+    if (run == 0)
+      return 0;
+    // extrapolate the count to the whole period
+    return (u64) ((double) (val) * ena / run);
+  }
+
+  float
+  PerfCount::ratio(const hpc_ent &ent)
+  {
+    u64 ena = ent.cEna - ent.pEna;
+    return (ena > 0) ? (float) (ent.cRun - ent.pRun) / ena : 1.0f;
   }
 
   void
   PerfCount::updatePid(pid_t pid)
   {
-    u64 tmp;
-
     // the update is only done if the pid has a file descriptor associated to it
     if (pid > 0)
       {
         // is the update time important? than it should be on the hpc entity structure
-        _pidMap[pid].pVal = _pidMap[pid].cVal;
+        hpc_ent* ent = findState<hpc_ent>(pid);
+        if ((ent == NULL) || (ent->fd <= 0))
+          return;
 
-        if ((tmp = readPC(_pidMap[pid].fd)) != NULL)
-          _pidMap[pid].cVal = tmp;
+        readPC(*ent);
       }
   }
 
   void
   PerfCount::update()
   {
-    u64 tmp;
+    updateCpus();
 
     for (int i = 0; i < _cpus_total; i++)
-      {
-        _nArr[i].pVal = _nArr[i].cVal;
-
-        if ((tmp = readPC(_nArr[i].fd)) != NULL)
-          _nArr[i].cVal = tmp;
-      }
+      if (_nArr[i].fd >= 0)
+        readPC(_nArr[i]);
   }
 
   void
   PerfCount::add(pid_t pid)
   {
-    // if map does not contains key ..
-    if (_pidMap.find(pid) == _pidMap.end())
+    // if the counter was not opened yet ..
+    hpc_ent* ent = getState<hpc_ent>(pid);
+    if (ent->fd <= 0)
       {
         int fd = openfd(pid);
 
         // check if the file descriptors were properly initiated
         if (fd > 0)
-          {
-            hpc_ent val;
-            val.fd = fd;
-
-            _pidMap.insert(std::pair<pid_t, hpc_ent>(pid, val));
-          }
+          ent->fd = fd;
       }
   }
 
   void
   PerfCount::remove(pid_t pid)
   {
-    close(_pidMap[pid].fd);
+    hpc_ent* ent = findState<hpc_ent>(pid);
+    if ((ent != NULL) && (ent->fd > 0))
+      close(ent->fd);
 
-    _pidMap.erase(pid);
+    PIDSensor::remove(pid);
   }
 
   sensor_t
@@ -310,7 +407,7 @@ namespace cea
     _cValue.U64 = 0;
 
     for (int i = 0; i < _cpus_total; i++)
-      _cValue.U64 += _nArr[i].cVal - _nArr[i].pVal;
+      _cValue.U64 += scale(_nArr[i]);
 
     return _cValue;
   }
@@ -321,8 +418,70 @@ namespace cea
     sensor_t ret;
 
     add(pid);
-    ret.U64 = _pidMap[pid].cVal - _pidMap[pid].pVal;
+    ret.U64 = scale(*getState<hpc_ent>(pid));
 
     return ret;
   }
+
+  float
+  PerfCount::getMultiplexRatio()
+  {
+    u64 ena = 0, run = 0;
+
+    for (int i = 0; i < _cpus_total; i++)
+      {
+        ena += _nArr[i].cEna - _nArr[i].pEna;
+        run += _nArr[i].cRun - _nArr[i].pRun;
+      }
+
+    return (ena > 0) ? (float) (run) / ena : 1.0f;
+  }
+
+  u64
+  PerfCount::getValueCpu(int cpu)
+  {
+    if ((cpu < 0) || (cpu >= _cpus_total) || (_nArr[cpu].fd < 0))
+      return 0;
+
+    return scale(_nArr[cpu]);
+  }
+
+  u64
+  PerfCount::getValueCore(int pkg, int core)
+  {
+    CpuInfo* cpuInfo = SystemInfo::getCpuInfo();
+    u64 val = 0;
+
+    for (int i = 0; i < _cpus_total; i++)
+      {
+        Processor* proc = cpuInfo->getProcessor(i);
+        if ((proc != NULL) && (proc->pkg == pkg) && (proc->core == core))
+          val += getValueCpu(i);
+      }
+
+    return val;
+  }
+
+  u64
+  PerfCount::getValuePackage(int pkg)
+  {
+    CpuInfo* cpuInfo = SystemInfo::getCpuInfo();
+    u64 val = 0;
+
+    for (int i = 0; i < _cpus_total; i++)
+      {
+        Processor* proc = cpuInfo->getProcessor(i);
+        if ((proc != NULL) && (proc->pkg == pkg))
+          val += getValueCpu(i);
+      }
+
+    return val;
+  }
+
+  float
+  PerfCount::getMultiplexRatioPid(pid_t pid)
+  {
+    hpc_ent* ent = findState<hpc_ent>(pid);
+    return (ent != NULL) ? ratio(*ent) : 1.0f;
+  }
 }
@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <cstring>
+#include <stddef.h>
+#include <unistd.h>
+
+#include <libec/tools/Tools.h>
+#include <libec/tools/DebugLog.h>
+#include <libec/device/SystemInfo.h>
+#include <libec/sensor/SensorPerfCount.h>
+#include <libec/sensor/SensorPerfGroup.h>
+#include <libec/process/PidStateSlab.h>
+
+namespace cea
+{
+  /// Counters shared by all the sensors of a group
+  struct PerfGroup::Group
+  {
+    std::vector<struct perf_event_attr> attr; ///< Events of the group
+    std::vector<std::string> name, alias; ///< Names of the events
+    int cpuId; ///< Core identifier (-1 for all)
+    std::vector<std::vector<int> > fd; ///< Machine level fds [cpu][event]
+    std::vector<std::vector<u64> > raw; ///< Last values read [cpu][event]
+    std::vector<u64> rawEna, rawRun; ///< Last times read [cpu]
+    std::vector<u64> value; ///< Scaled values of the last period
+    u64 ena, run; ///< Times enabled and running of the last period
+    unsigned int seq; ///< Number of machine level reads
+    u64 readCount; ///< Number of read() done
+    std::vector<PerfGroup*> sensors; ///< Sensors sharing the group
+    unsigned int pidOffset; ///< Offset of the PidGroup in the PidStateSlab
+  };
+
+  /* Read a group leader: times[0] and times[1] receive the time enabled and
+   * running, values[i] the i-th counter opened */
+  static unsigned int
+  readGroup(int leader, u64* times, u64* values)
+  {
+    u64 buf[3 + PERF_GROUP_MAX_EVENTS];
+
+    ssize_t len = read(leader, buf, sizeof(buf));
+    if (len < (ssize_t) (3 * sizeof(u64)))
+      return 0;
+
+    unsigned int nr = buf[0];
+    if ((nr > PERF_GROUP_MAX_EVENTS)
+        || (len < (ssize_t) ((3 + nr) * sizeof(u64))))
+      return 0;
+
+    times[0] = buf[1];
+    times[1] = buf[2];
+    std::memcpy(values, buf + 3, nr * sizeof(u64));
+    return nr;
+  }
+
+  /* Open a group on a pid/cpu, fds[e] is -1 if the event was not opened */
+  static void
+  openGroup(std::vector<struct perf_event_attr> &attr, pid_t pid, int cpu,
+      int* fds)
+  {
+    int leader = perf_event_open(&attr[0], pid, cpu, -1, 0);
+    fds[0] = leader;
+    for (unsigned int e = 1; e < attr.size(); e++)
+      fds[e] =
+          (leader >= 0) ? perf_event_open(&attr[e], pid, cpu, leader, 0) : -1;
+  }
+
+  PerfGroup::PerfGroup(const std::vector<Event> &events, int core_id)
+  {
+    _group = new Group;
+    _group->cpuId = core_id;
+    _group->seq = 0;
+    _group->readCount = 0;
+
+    unsigned int n = events.size();
+    if (n > PERF_GROUP_MAX_EVENTS)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "PerfGroup::PerfGroup()",
+            "Too many events, the group is truncated.");
+        n = PERF_GROUP_MAX_EVENTS;
+      }
+
+    for (unsigned int e = 0; e < n; e++)
+      {
+        struct perf_event_attr attr;
+        std::string name, alias;
+
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[e].type;
+        attr.config = events[e].config;
+        attr.read_format = PERF_FORMAT_GROUP
+            | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        _group->attr.push_back(attr);
+
+        if (PerfCount::getEventName(events[e].type, events[e].config, name,
+            alias))
+          {
+            name += "_" + Tools::CStr(core_id);
+            alias += "_" + Tools::CStr(core_id);
+          }
+        _group->name.push_back(name);
+        _group->alias.push_back(alias);
+      }
+    _group->value.assign(n, 0);
+    _group->ena = _group->run = 0;
+
+    // machine level groups: one per online CPU, or the one of core_id
+    CpuInfo* cpuInfo = SystemInfo::getCpuInfo();
+    cpuInfo->updateOnline();
+
+    for (int cpu = 0; (n > 0) && (cpu < cpuInfo->getCpuCount()); cpu++)
+      {
+        if (((core_id == -1) || (core_id == cpu)) && cpuInfo->isOnline(cpu))
+          {
+            std::vector<int> fds(n, -1);
+            openGroup(_group->attr, -1, cpu, &fds[0]);
+            _group->fd.push_back(fds);
+            _group->raw.push_back(std::vector<u64>(n, 0));
+            _group->rawEna.push_back(0);
+            _group->rawRun.push_back(0);
+          }
+      }
+
+    // process level groups
+    _group->pidOffset = PidStateSlab::registerBlock(
+        offsetof(PidGroup, counter) + n * sizeof(PidCounter), this);
+
+    _member = 0;
+    _group->sensors.push_back(this);
+    init();
+  }
+
+  PerfGroup::PerfGroup(PerfGroup &group, unsigned int member)
+  {
+    _group = group._group;
+    _member = member;
+    if (_member >= getMemberCount())
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "PerfGroup::PerfGroup()",
+            "Invalid member, the first event is used.");
+        _member = 0;
+      }
+    _group->sensors.push_back(this);
+    init();
+  }
+
+  PerfGroup::~PerfGroup()
+  {
+    std::vector<PerfGroup*> &sensors = _group->sensors;
+
+    for (unsigned int i = 0; i < sensors.size(); i++)
+      {
+        if (sensors[i] == this)
+          {
+            sensors.erase(sensors.begin() + i);
+            break;
+          }
+      }
+
+    if (!sensors.empty())
+      {
+        // the first remaining sensor closes the process groups
+        PidStateSlab::setOwner(_group->pidOffset, sensors[0]);
+        return;
+      }
+
+    // last sensor of the group: close everything
+    std::vector<pid_t> pids;
+    PidStateSlab::getPids(pids);
+    for (unsigned int i = 0; i < pids.size(); i++)
+      closePid(pids[i]);
+    PidStateSlab::unregisterBlock(_group->pidOffset);
+
+    for (unsigned int c = 0; c < _group->fd.size(); c++)
+      for (unsigned int e = 0; e < _group->fd[c].size(); e++)
+        if (_group->fd[c][e] >= 0)
+          close(_group->fd[c][e]);
+
+    delete _group;
+  }
+
+  unsigned int
+  PerfGroup::getMemberCount() const
+  {
+    return _group->attr.size();
+  }
+
+  unsigned int
+  PerfGroup::getMember() const
+  {
+    return _member;
+  }
+
+  bool
+  PerfGroup::isSameGroup(const PerfGroup &group) const
+  {
+    return (_group == group._group);
+  }
+
+  u64
+  PerfGroup::getReadCount() const
+  {
+    return _group->readCount;
+  }
+
+  void
+  PerfGroup::update()
+  {
+    // the first sensor of the tick reads the group, the others reuse it
+    if (_seq == _group->seq)
+      {
+        unsigned int n = getMemberCount();
+        u64 times[2], values[PERF_GROUP_MAX_EVENTS];
+
+        _group->value.assign(n, 0);
+        _group->ena = _group->run = 0;
+
+        for (unsigned int c = 0; c < _group->fd.size(); c++)
+          {
+            std::vector<int> &fds = _group->fd[c];
+            if (fds[0] < 0)
+              continue;
+
+            unsigned int nr = readGroup(fds[0], times, values);
+            _group->readCount++;
+            if (nr == 0)
+              continue;
+
+            u64 ena = times[0] - _group->rawEna[c];
+            u64 run = times[1] - _group->rawRun[c];
+            _group->rawEna[c] = times[0];
+            _group->rawRun[c] = times[1];
+            _group->ena += ena;
+            _group->run += run;
+
+            // values follow the order in which the events were opened
+            std::vector<u64> &raw = _group->raw[c];
+            for (unsigned int e = 0, k = 0; (e < n) && (k < nr); e++)
+              if (fds[e] >= 0)
+                {
+                  _group->value[e] += PerfCount::scaleValue(values[k] - raw[e],
+                      ena, run);
+                  raw[e] = values[k++];
+                }
+          }
+
+        _group->seq++;
+      }
+    _seq = _group->seq;
+  }
+
+  sensor_t
+  PerfGroup::getValue()
+  {
+    _cValue.U64 = 0;
+    if (_member < getMemberCount())
+      _cValue.U64 = _group->value[_member];
+
+    return _cValue;
+  }
+
+  void
+  PerfGroup::updatePid(pid_t pid)
+  {
+    if ((pid <= 0) || (getMemberCount() == 0))
+      return;
+
+    PidGroup* g = getPidGroup(pid);
+    unsigned int* seq = getState<unsigned int>(pid);
+
+    if (*seq == g->seq)
+      {
+        unsigned int n = getMemberCount();
+        u64 times[2], values[PERF_GROUP_MAX_EVENTS];
+        unsigned int nr = 0;
+
+        if (g->counter[0].fd >= 0)
+          {
+            nr = readGroup(g->counter[0].fd, times, values);
+            _group->readCount++;
+          }
+
+        g->pEna = g->cEna;
+        g->pRun = g->cRun;
+        if (nr > 0)
+          {
+            g->cEna = times[0];
+            g->cRun = times[1];
+          }
+
+        for (unsigned int e = 0, k = 0; e < n; e++)
+          {
+            PidCounter &ctr = g->counter[e];
+            ctr.pVal = ctr.cVal;
+            if ((ctr.fd >= 0) && (k < nr))
+              ctr.cVal = values[k++];
+          }
+
+        g->seq++;
+      }
+    *seq = g->seq;
+  }
+
+  sensor_t
+  PerfGroup::getValuePid(pid_t pid)
+  {
+    sensor_t ret;
+
+    ret.U64 = 0;
+    if (_member < getMemberCount())
+      {
+        PidGroup* g = getPidGroup(pid);
+        PidCounter &ctr = g->counter[_member];
+        ret.U64 = PerfCount::scaleValue(ctr.cVal - ctr.pVal,
+            g->cEna - g->pEna, g->cRun - g->pRun);
+      }
+
+    return ret;
+  }
+
+  float
+  PerfGroup::getMultiplexRatio()
+  {
+    return (_group->ena > 0) ? (float) (_group->run) / _group->ena : 1.0f;
+  }
+
+  float
+  PerfGroup::getMultiplexRatioPid(pid_t pid)
+  {
+    char* row = PidStateSlab::find(pid);
+    if (row == NULL)
+      return 1.0f;
+
+    PidGroup* g = (PidGroup*) (row + _group->pidOffset);
+    u64 ena = g->cEna - g->pEna;
+    return (ena > 0) ? (float) (g->cRun - g->pRun) / ena : 1.0f;
+  }
+
+  void
+  PerfGroup::createRotation(const std::vector<Event> &events,
+      unsigned int slots, std::vector<PerfGroup*> &sensors, int core_id)
+  {
+    if (slots == 0)
+      slots = 1;
+
+    for (unsigned int first = 0; first < events.size(); first += slots)
+      {
+        unsigned int last = std::min(first + slots, (unsigned int) events.size());
+        std::vector<Event> chunk(events.begin() + first, events.begin() + last);
+
+        PerfGroup* leader = new PerfGroup(chunk, core_id);
+        sensors.push_back(leader);
+        for (unsigned int m = 1; m < leader->getMemberCount(); m++)
+          sensors.push_back(new PerfGroup(*leader, m));
+      }
+  }
+
+  void
+  PerfGroup::add(pid_t pid)
+  {
+    if (getMemberCount() > 0)
+      getPidGroup(pid);
+  }
+
+  void
+  PerfGroup::remove(pid_t pid)
+  {
+    // the process group is closed by the owner of its block
+    if (this == _group->sensors[0])
+      closePid(pid);
+
+    PIDSensor::remove(pid);
+  }
+
+  void
+  PerfGroup::init()
+  {
+    _type = U64;
+    _cValue.U64 = 0;
+    _seq = 0;
+
+    if (_member < getMemberCount())
+      {
+        _name = _group->name[_member];
+        _alias = _group->alias[_member];
+      }
+
+    // last process level read used by this sensor
+    registerState(sizeof(unsigned int));
+
+    _isActive = (getMemberCount() > 0) && !_group->fd.empty();
+    for (unsigned int c = 0; c < _group->fd.size(); c++)
+      _isActive &= (_group->fd[c][_member] >= 0);
+  }
+
+  PerfGroup::PidGroup*
+  PerfGroup::getPidGroup(pid_t pid)
+  {
+    char* row = PidStateSlab::acquire(pid);
+    PidGroup* g = (PidGroup*) (row + _group->pidOffset);
+
+    if (!g->opened)
+      {
+        int fds[PERF_GROUP_MAX_EVENTS];
+
+        openGroup(_group->attr, pid, -1, fds);
+        for (unsigned int e = 0; e < getMemberCount(); e++)
+          {
+            g->counter[e].fd = fds[e];
+            g->counter[e].cVal = g->counter[e].pVal = 0;
+          }
+        g->opened = true;
+      }
+
+    return g;
+  }
+
+  void
+  PerfGroup::closePid(pid_t pid)
+  {
+    char* row = PidStateSlab::find(pid);
+    if (row == NULL)
+      return;
+
+    PidGroup* g = (PidGroup*) (row + _group->pidOffset);
+    if (g->opened)
+      {
+        for (unsigned int e = 0; e < getMemberCount(); e++)
+          if (g->counter[e].fd >= 0)
+            close(g->counter[e].fd);
+        g->opened = false;
+      }
+  }
+
+}
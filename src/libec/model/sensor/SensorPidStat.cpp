@@ -10,6 +10,8 @@
 #include <libec/Globals.h>
 #include <libec/tools.h>
 #include <libec/sensor/SensorPidStat.h>
+#include <libec/device/ProcStat.h>
+#include <libec/process/linux/ProcessSampleCache.h>
 
 #include <cmath>
 #include <fcntl.h>
@@ -64,6 +66,8 @@ namespace cea
 
       }
 
+    registerState(sizeof(PidState));
+
     _isActive = Tools::fileExists("/proc/stat");
 
 //    fd = open("/proc/stat", O_RDONLY, 0);
@@ -82,35 +86,13 @@ namespace cea
   void
   PidStat::add(pid_t pid)
   {
-    // if map does not contains key ..
-    if (_cvPIDMap.find(pid) == _cvPIDMap.end())
-      {
-        /*        // Creates the values vectors for the current and previous data
-         std::vector<u64> *val_tmp;
-         val_tmp = new std::vector<u64>(TYPE_MAX * sizeof(u64), 0);
-         _cvPIDMap.insert(std::pair<pid_t, std::vector<u64>*>(pid, val_tmp));
-         val_tmp = new std::vector<u64>(TYPE_MAX * sizeof(u64), 0);
-         _pvPIDMap.insert(std::pair<pid_t, std::vector<u64>*>(pid, val_tmp));
-         */
-
-        struct pid_stats cval, pval;
-        _cvPIDMap.insert(std::pair<pid_t, struct pid_stats>(pid, cval));
-        _pvPIDMap.insert(std::pair<pid_t, struct pid_stats>(pid, pval));
-
-        struct timeval ctime, ptime;
-        _ctimePIDMap.insert(std::pair<pid_t, struct timeval>(pid, ctime));
-        _ptimePIDMap.insert(std::pair<pid_t, struct timeval>(pid, ptime));
-      }
+    getState<PidState>(pid);
   }
 
   void
   PidStat::remove(pid_t pid)
   {
-    _pvPIDMap.erase(pid);
-    _cvPIDMap.erase(pid);
-
-    _ctimePIDMap.erase(pid);
-    _ptimePIDMap.erase(pid);
+    PIDSensor::remove(pid);
   }
 
   sensor_t
@@ -120,13 +102,14 @@ namespace cea
 
     updatePid(pid);
 
+    PidState* st = getState<PidState>(pid);
+
     switch (_typeId)
       {
     case PidStat::CPU_USAGE:
       float f1, f2;
       f1 = 100.0f
-          * (_cvPIDMap[pid].utime + _cvPIDMap[pid].stime - _pvPIDMap[pid].utime
-              - _pvPIDMap[pid].stime);
+          * (st->cur.utime + st->cur.stime - st->prev.utime - st->prev.stime);
 
       //better precision, more cpu consumption
       f2 = _cValue.U64 - _pValue.U64;
@@ -135,16 +118,16 @@ namespace cea
 
       break;
     case PidStat::CPU_LAST:
-      retVal.U64 = _cvPIDMap[pid].processor;
+      retVal.U64 = st->cur.processor;
       break;
     case PidStat::VIRTUAL_MEM_SIZE:
-      retVal.U64 = _cvPIDMap[pid].vsz;
+      retVal.U64 = st->cur.vsz;
       break;
     case PidStat::RESIDENT_SET_SIZE:
-      retVal.U64 = _cvPIDMap[pid].rss;
+      retVal.U64 = st->cur.rss;
       break;
     case PidStat::PID_STATE:
-      retVal.U64 = _cvPIDMap[pid].state;
+      retVal.U64 = st->cur.state;
       break;
       }
     return retVal;
@@ -153,74 +136,60 @@ namespace cea
   void
   PidStat::updatePid(pid_t pid)
   {
-    int fd;
-    char sbuf[1024];
     char pstate;
-    unsigned long int putime, pstime;
+    unsigned long int putime, pstime, pgtime;
     unsigned long int pvsize;
     long int prss;
     int processor;
-
-    static char path[1024];
+    ProcStat::Jiffies jiffies;
 
     struct timeval timenow;
     gettimeofday(&timenow, NULL);
 
-    if (_ctimePIDMap[pid].tv_sec < timenow.tv_sec)
+    PidState* st = getState<PidState>(pid);
+
+    if (st->ctime.tv_sec < timenow.tv_sec)
       {
-        _ptimePIDMap[pid] = _ctimePIDMap[pid];
-        _ctimePIDMap[pid] = timenow;
+        st->ptime = st->ctime;
+        st->ctime = timenow;
 
         if (pid > 0)
           {
-            sprintf(path, "/proc/%d/stat", pid);
-
-            fd = open(path, O_RDONLY, 0);
-            if (fd == -1)
+            // proc/[pid]/stat is shared by all the sensors of the tick
+            const ProcessStat::Snapshot* stat = ProcessSampleCache::getStat(
+                pid);
+            if (stat == NULL)
               return;
-            read(fd, sbuf, 1023);
-            close(fd);
-
-            sscanf(sbuf,
-                "%d (%s %c "
-                    "%d %d %d %d %d "
-                    "%lu %lu %lu %lu %lu "
-                    "%lu %lu " // utime stime
-                    "%ld %ld %ld %ld %ld %ld %llu "
-                    "%lu %ld "// vsize rss
-                    "%lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %d "
-                    "%d"// processor
-                , &d_int, d_buf, &pstate, &d_int, &d_int, &d_int, &d_int,
-                &d_int,
-                &d_ulong, &d_ulong, &d_ulong, &d_ulong, &d_ulong, &putime,
-                &pstime, &d_long, &d_long, &d_long, &d_long, &d_long, &d_long,
-                &d_ulonglong, &pvsize, &prss, &d_ulong, &d_ulong, &d_ulong,
-                &d_ulong, &d_ulong, &d_ulong, &d_ulong, &d_ulong, &d_ulong,
-                &d_ulong, &d_ulong, &d_ulong, &d_ulong, &d_int, &processor);
-
-            _pvPIDMap[pid] = _cvPIDMap[pid];
-
-            _cvPIDMap[pid].state = pstate;
-            _cvPIDMap[pid].utime = putime;
-            _cvPIDMap[pid].stime = pstime;
-            _cvPIDMap[pid].vsz = pvsize;
-            _cvPIDMap[pid].rss = prss;
-            _cvPIDMap[pid].processor = processor;
+
+            ProcessStat::get(*stat, ProcessStat::STATE, pstate);
+            ProcessStat::get(*stat, ProcessStat::UTIME, putime);
+            ProcessStat::get(*stat, ProcessStat::STIME, pstime);
+            ProcessStat::get(*stat, ProcessStat::GUEST_TIME, pgtime);
+            ProcessStat::get(*stat, ProcessStat::VSIZE, pvsize);
+            ProcessStat::get(*stat, ProcessStat::RSS, prss);
+            ProcessStat::get(*stat, ProcessStat::PROCESSOR, processor);
+
+            st->prev = st->cur;
+
+            st->cur.state = pstate;
+            st->cur.utime = putime;
+            st->cur.stime = pstime;
+            st->cur.gtime = pgtime;
+            st->cur.vsz = pvsize;
+            st->cur.rss = prss;
+            st->cur.processor = processor;
 
             //better precision, more cpu consumption
             if (time(NULL) > _cTime)
               {
-                unsigned long tuser, tnice, tsys, tidle;
-
-                sprintf(path, "/proc/stat");
-                fd = open(path, O_RDONLY, 0);
-                if (fd == -1)
+                // /proc/stat is shared by all the sensors of the tick
+                if (!ProcStat::getCpu(-1, jiffies))
                   return;
-                read(fd, sbuf, 1023);
-                close(fd);
 
-                sscanf(sbuf, "cpu %lu %lu %lu %lu", // %lu %lu %lu %lu %lu", // utime stime
-                    &tuser, &tnice, &tsys, &tidle);
+                u64 tuser = jiffies.field[ProcStat::USER];
+                u64 tnice = jiffies.field[ProcStat::NICE];
+                u64 tsys = jiffies.field[ProcStat::SYSTEM];
+                u64 tidle = jiffies.field[ProcStat::IDLE];
 
                 _pValue.U64 = _cValue.U64;
                 _cValue.U64 = tuser + tnice + tsys + tidle;
@@ -234,24 +203,20 @@ namespace cea
           }
         else if (pid == -1)
           {
-            unsigned long tuser, tnice, tsys, tidle;
-
-            sprintf(path, "/proc/stat");
-            fd = open(path, O_RDONLY, 0);
-            if (fd == -1)
+            if (!ProcStat::getCpu(-1, jiffies))
               return;
-            read(fd, sbuf, 1023);
-            close(fd);
 
-            sscanf(sbuf, "cpu %lu %lu %lu %lu", // %lu %lu %lu %lu %lu", /* utime stime */
-                &tuser, &tnice, &tsys, &tidle);
+            u64 tuser = jiffies.field[ProcStat::USER];
+            u64 tnice = jiffies.field[ProcStat::NICE];
+            u64 tsys = jiffies.field[ProcStat::SYSTEM];
+            u64 tidle = jiffies.field[ProcStat::IDLE];
 
-            _pvPIDMap[pid] = _cvPIDMap[pid];
+            st->prev = st->cur;
 
-            _cvPIDMap[pid].state = 'R';
-            _cvPIDMap[pid].utime = tuser;
-            _cvPIDMap[pid].stime = tsys;
-            _cvPIDMap[pid].processor = 0;
+            st->cur.state = 'R';
+            st->cur.utime = tuser;
+            st->cur.stime = tsys;
+            st->cur.processor = 0;
 
             if (time(NULL) > _cTime)
               {
@@ -1,20 +1,39 @@
 #include <libec/sensor/SensorPid.h>
+#include <libec/process/PidStateSlab.h>
 #include <map>
+#include <string.h>
 
 namespace cea
 {
 
-  PIDSensor::PIDSensor()
+  PIDSensor::PIDSensor() :
+      _stateOffset(0), _stateSize(0)
   {
   }
 
   PIDSensor::PIDSensor(const std::string &xmlTag) :
-      Sensor(xmlTag)
+      Sensor(xmlTag), _stateOffset(0), _stateSize(0)
   {
   }
 
+  PIDSensor::PIDSensor(const PIDSensor &sensor) :
+      Sensor(sensor), _stateOffset(0), _stateSize(0)
+  {
+    if (sensor._stateSize > 0)
+      registerState(sensor._stateSize);
+  }
+
   PIDSensor::~PIDSensor()
   {
+    if (_stateSize > 0)
+      PidStateSlab::unregisterBlock(_stateOffset);
+  }
+
+  PIDSensor&
+  PIDSensor::operator=(const PIDSensor &sensor)
+  {
+    Sensor::operator=(sensor);
+    return *this;
   }
 
   sensor_t
@@ -43,8 +62,19 @@ namespace cea
   void
   PIDSensor::remove(pid_t pid)
   {
-//    _pvPIDMap.erase(pid);
-//    _cvPIDMap.erase(pid);
+    if (_stateSize > 0)
+      {
+        char* row = PidStateSlab::find(pid);
+        if (row != NULL)
+          memset(row + _stateOffset, 0, _stateSize);
+      }
+  }
+
+  void
+  PIDSensor::registerState(unsigned int size)
+  {
+    _stateOffset = PidStateSlab::registerBlock(size, this);
+    _stateSize = size;
   }
 
 }
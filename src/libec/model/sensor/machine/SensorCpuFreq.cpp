@@ -24,6 +24,8 @@
 
 #include <typeinfo>
 #include <fstream>
+#include <cstring>
+#include <unistd.h>
 #include <libec/tools/DebugLog.h>
 #include <libec/tools/Tools.h>
 #include <libec/tools/XMLReader.h>
@@ -35,11 +37,12 @@ namespace cea
   // Static Members
   ///////////////////////////////////////////////////////////////////
   const char* CpuFreq::ClassName = "CpuFreq";
+  std::string CpuFreq::_path = "/sys/devices/system/cpu/";
 
   ///////////////////////////////////////////////////////////////////
   // Public Members
   ///////////////////////////////////////////////////////////////////
-  CpuFreq::CpuFreq(unsigned short cpu_id, suseconds_t latency) :
+  CpuFreq::CpuFreq(unsigned short cpu_id, suseconds_t latency, Mode mode) :
       Sensor(latency)
   {
     clean();
@@ -49,8 +52,14 @@ namespace cea
     cpuIdStr = Tools::CStr(cpu_id);
     _name = "CPU" + cpuIdStr + "_FREQUENCY";
     _alias = "CPU" + cpuIdStr + "FREQ";
+    if (mode == TIME_IN_STATE)
+      {
+        _name.append("_MEAN");
+        _alias.append("AVG");
+      }
 
     _cpuId = cpu_id;
+    _mode = mode;
     _isActive = checkActivity();
 
     // if no latency was set, use the minimum latency possible
@@ -61,6 +70,7 @@ namespace cea
   CpuFreq::CpuFreq(const std::string &xmlTag) :
       Sensor(xmlTag)
   {
+    _mode = CURRENT;
     setParamsXml(xmlTag.c_str());
     _type = U64;
     _isActive = checkActivity();
@@ -88,13 +98,18 @@ namespace cea
   {
     std::stringstream ss;
     ss << indentation << "<cpu_id value=\"" << _cpuId << "\"/>" << std::endl;
+    ss << indentation << "<mode value=\"" << _mode << "\"/>" << std::endl;
     return ss.str();
   }
 
   void
   CpuFreq::setParamsXml(const char* xmlTag)
   {
+    unsigned int mode = CURRENT;
+
     XMLReader::readSingleValuedTag(xmlTag, "cpu_id", _cpuId);
+    XMLReader::readSingleValuedTag(xmlTag, "mode", mode);
+    _mode = (mode == TIME_IN_STATE) ? TIME_IN_STATE : CURRENT;
   }
 
   void
@@ -109,6 +124,26 @@ namespace cea
     return _cValue;
   }
 
+  const std::vector<u64>&
+  CpuFreq::getFrequencies() const
+  {
+    return _freqs;
+  }
+
+  const std::vector<u64>&
+  CpuFreq::getResidency() const
+  {
+    return _residency;
+  }
+
+  void
+  CpuFreq::setPath(const std::string &path)
+  {
+    _path = path;
+    if ((_path.size() > 0) && (_path[_path.size() - 1] != '/'))
+      _path.append("/");
+  }
+
   CpuFreq&
   CpuFreq::operator=(const CpuFreq& s)
   {
@@ -132,7 +167,14 @@ namespace cea
     _alias = "CPUFREQ";
     _type = U64;
     _cpuId = 0;
+    _mode = CURRENT;
     _filepath = "";
+
+    _file.close();
+    _buffer.clear();
+    _freqs.clear();
+    _ticks.clear();
+    _residency.clear();
   }
 
   void
@@ -142,75 +184,114 @@ namespace cea
 
     updatePtr = source.updatePtr;
     _cpuId = source._cpuId;
+    _mode = source._mode;
     _filepath = source._filepath;
+    _file = source._file;
+    _buffer = source._buffer;
+    _freqs = source._freqs;
+    _ticks = source._ticks;
+    _residency = source._residency;
   }
 
   bool
   CpuFreq::checkActivity()
   {
-    if (checkRootAccess(_cpuId))
+    if (_mode == TIME_IN_STATE)
       {
-        CpuFreq::updatePtr = &CpuFreq::updateAsRoot;
-        return true;
+        CpuFreq::updatePtr = &CpuFreq::updateTimeInState;
+        return checkStatsAccess(_cpuId);
       }
+
+    CpuFreq::updatePtr = &CpuFreq::updateCurrent;
+    if (checkRootAccess(_cpuId))
+      return true;
     else if (checkUserAccess(_cpuId))
-      {
-        CpuFreq::updatePtr = &CpuFreq::updateAsUser;
-        return true;
-      }
+      return true;
 
+    CpuFreq::updatePtr = &CpuFreq::updateCpuinfo;
+    if (checkCpuinfoAccess(_cpuId))
+      return true;
+
+    std::stringstream ss;
+    ss << "Sensor " << _name << " could not open the frequency files of CPU "
+        << _cpuId << ". Make sure you have cpufreq-utils package installed.";
+    DebugLog::writeMsg(DebugLog::ERROR, "CpuFreq", ss.str().c_str());
     return false;
   }
 
   bool
   CpuFreq::checkRootAccess(unsigned short cpu_id)
   {
-    std::string cpufreq;
-    std::string cpuIdStr;
-
-    cpuIdStr = Tools::CStr(cpu_id);
-
-    cpufreq = "/sys/devices/system/cpu/cpu" + cpuIdStr + "/cpufreq/";
+    _filepath = _path + "cpu" + Tools::CStr(cpu_id)
+        + "/cpufreq/cpuinfo_cur_freq";
 
-    // Set filepath
-    _filepath = cpufreq + "cpuinfo_cur_freq";
-    if (access(_filepath.c_str(), R_OK) == -1)
-      {
-        std::stringstream ss;
-        ss << "Sensor " << _name << " could not access the file " << _filepath
-            << ". Make sure you have cpufreq-utils package installed and you "
-                "have the proper permissions to acces the file.";
-        DebugLog::writeMsg(DebugLog::ERROR, "CpuFreq", ss.str().c_str());
-        return false;
-      }
-
-    return true;
+    return _file.open(_filepath);
   }
 
   bool
   CpuFreq::checkUserAccess(unsigned short cpu_id)
   {
-    std::stringstream ss;
-    std::string cpuIdStr;
-    std::string cpuinfo_str;
+    // the frequency asked by the governor, readable by anyone
+    _filepath = _path + "cpu" + Tools::CStr(cpu_id)
+        + "/cpufreq/scaling_cur_freq";
 
-    if (access("/proc/cpuinfo", R_OK) == -1)
+    return _file.open(_filepath);
+  }
+
+  bool
+  CpuFreq::checkCpuinfoAccess(unsigned short cpu_id)
+  {
+    _filepath = "/proc/cpuinfo";
+    if (!_file.open(_filepath))
       return false;
 
-    cpuIdStr = Tools::CStr(cpu_id + 1);
+    // a processor takes about 1.5 KB, the lines after the CPU are not read
+    _buffer.resize((cpu_id + 1) * 4096);
+
+    return (updateCpuinfo() > 0);
+  }
+
+  bool
+  CpuFreq::checkStatsAccess(unsigned short cpu_id)
+  {
+    char buffer[4096];
+    const char* p;
+    u64 freq, ticks;
 
-    // Set filepath
-    _filepath = "awk '/cpu MHz/ { ++x; if ( x == " + cpuIdStr
-        + " ) print $4 }' /proc/cpuinfo";
+    _filepath = _path + "cpu" + Tools::CStr(cpu_id)
+        + "/cpufreq/stats/time_in_state";
+    if (!_file.open(_filepath))
+      {
+        std::stringstream ss;
+        ss << "Sensor " << _name << " could not open the file " << _filepath
+            << ". Make sure the kernel has CONFIG_CPU_FREQ_STAT.";
+        DebugLog::writeMsg(DebugLog::ERROR, "CpuFreq", ss.str().c_str());
+        return false;
+      }
 
-    cpuinfo_str = cea::Tools::exec(_filepath.c_str());
+    if (_file.read(buffer, sizeof(buffer)) < 0)
+      buffer[0] = '\0';
 
-    // remove return character from string
-    unsigned found = cpuinfo_str.rfind("\n");
-    if (found != std::string::npos)
-      cpuinfo_str = cpuinfo_str.substr(0, found);
+    // one line per frequency: the updates reuse these arrays
+    _freqs.clear();
+    _ticks.clear();
+    for (p = buffer; *p != '\0';)
+      {
+        p = KernelAttr::scanU64(p, freq);
+        p = KernelAttr::scanU64(p, ticks);
+        if (freq > 0)
+          {
+            _freqs.push_back(freq);
+            _ticks.push_back(ticks);
+          }
+        while ((*p != '\n') && (*p != '\0'))
+          p++;
+        if (*p == '\n')
+          p++;
+      }
+    _residency.assign(_freqs.size(), 0);
 
-    return Tools::isNumeric(cpuinfo_str);
+    return !_freqs.empty();
   }
 
   suseconds_t
@@ -242,36 +323,92 @@ namespace cea
   }
 
   u64
-  CpuFreq::updateAsRoot()
+  CpuFreq::updateCurrent()
   {
     u64 val;
 
-    std::ifstream ifs(_filepath.c_str());
-    if (ifs.good())
-      {
-        ifs >> val;
-        ifs.close();
-      }
+    if (!_file.readU64(val))
+      return _cValue.U64;
+
     return val;
   }
 
   u64
-  CpuFreq::updateAsUser()
+  CpuFreq::updateCpuinfo()
   {
-    u64 val;
-    std::string cpuinfo_str;
+    const char* p = &_buffer[0];
+    unsigned int found = 0;
+    u64 mhz, frac = 0;
+
+    if (_file.read(&_buffer[0], _buffer.size()) <= 0)
+      return _cValue.U64;
+
+    // the (cpu_id + 1)-th "cpu MHz\t\t: 2000.000" line
+    while (*p != '\0')
+      {
+        if ((strncmp(p, "cpu MHz", 7) == 0) && (found++ == _cpuId))
+          {
+            while ((*p != ':') && (*p != '\n') && (*p != '\0'))
+              p++;
+            if (*p != ':')
+              return _cValue.U64;
+
+            // MHz to KHz, keeping 3 decimals
+            p = KernelAttr::scanU64(p + 1, mhz);
+            if (*p == '.')
+              p++;
+            for (int d = 0; d < 3; d++)
+              {
+                frac *= 10;
+                if ((*p >= '0') && (*p <= '9'))
+                  frac += *p++ - '0';
+              }
+
+            return mhz * 1000 + frac;
+          }
+
+        while ((*p != '\n') && (*p != '\0'))
+          p++;
+        if (*p == '\n')
+          p++;
+      }
+
+    return _cValue.U64;
+  }
 
-    cpuinfo_str = cea::Tools::exec(_filepath.c_str());
+  u64
+  CpuFreq::updateTimeInState()
+  {
+    char buffer[4096];
+    const char* p = buffer;
+    u64 freq, ticks, sum = 0, weighted = 0;
+    long hz = sysconf(_SC_CLK_TCK);
 
-    // remove return character from string
-    unsigned found = cpuinfo_str.rfind("\n");
-    if (found != std::string::npos)
-      cpuinfo_str = cpuinfo_str.substr(0, found);
+    if (_file.read(buffer, sizeof(buffer)) <= 0)
+      return _cValue.U64;
 
-    Tools::CStrTo(cpuinfo_str, val);
-    val *= 1000;
+    for (unsigned int i = 0; (i < _freqs.size()) && (*p != '\0'); i++)
+      {
+        p = KernelAttr::scanU64(p, freq);
+        p = KernelAttr::scanU64(p, ticks);
+
+        // the time is in clock ticks (USER_HZ)
+        u64 elapsed = (ticks > _ticks[i]) ? ticks - _ticks[i] : 0;
+        _residency[i] = elapsed * 1000 / hz;
+        _ticks[i] = ticks;
+        _freqs[i] = freq;
+
+        sum += elapsed;
+        weighted += elapsed * freq;
+
+        while ((*p != '\n') && (*p != '\0'))
+          p++;
+        if (*p == '\n')
+          p++;
+      }
 
-    return val;
+    // an interval shorter than a tick keeps the last mean
+    return (sum > 0) ? weighted / sum : _cValue.U64;
   }
 
   ///////////////////////////////////////////////////////////////////
@@ -0,0 +1,302 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @file		SensorCpuIdleResidency.cpp
+/// @author		Leandro Fontoura Cupertino
+/// @version	0.1
+/// @date		2013.09
+/// @copyright	2013, CoolEmAll (INFSO-ICT-288701)
+/// @brief		Residency of all the CPUs in their idle states (C-states)
+///////////////////////////////////////////////////////////////////////////////
+
+#include <libec/sensor/SensorCpuIdleResidency.h>
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/tools/Tools.h>
+
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+namespace cea
+{
+  //Static members
+  CpuIdleResidency* CpuIdleResidency::_shared = NULL;
+  unsigned int CpuIdleResidency::_users = 0;
+  pthread_mutex_t CpuIdleResidency::_sharedMutex = PTHREAD_MUTEX_INITIALIZER;
+
+  CpuIdleResidency::CpuIdleResidency(const std::string &path) :
+      _path(path), _cpus(0), _states(0), _last(0), _elapsed(0), _openCount(
+          0), _passCount(0)
+  {
+    char file[256];
+
+    _name = "CPU_IDLE_RESIDENCY";
+    _alias = "CIdle";
+    _type = Float;
+    _cValue.Float = 0.0;
+    pthread_mutex_init(&_mutex, NULL);
+
+    if ((_path.size() > 0) && (_path[_path.size() - 1] != '/'))
+      _path.append("/");
+
+    // CPUs and the largest number of states of a CPU
+    for (;; _cpus++)
+      {
+        snprintf(file, sizeof(file), "%scpu%u", _path.c_str(), _cpus);
+        if (access(file, R_OK) != 0)
+          break;
+
+        unsigned int states = 0;
+        for (;; states++)
+          {
+            snprintf(file, sizeof(file), "%scpu%u/cpuidle/state%u/time",
+                _path.c_str(), _cpus, states);
+            if (access(file, R_OK) != 0)
+              break;
+          }
+        if (states > _states)
+          _states = states;
+      }
+
+    _isActive = (_states > 0);
+    if (!_isActive)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING,
+            "CpuIdleResidency::CpuIdleResidency()",
+            "No idle state found in %s. Make sure the cpuidle driver is "
+                "loaded.", _path.c_str());
+        return;
+      }
+
+    // the names are read once, from the first CPU having the state
+    _stateNames.resize(_states);
+    for (unsigned int s = 0; s < _states; s++)
+      for (unsigned int c = 0; (c < _cpus) && _stateNames[s].empty(); c++)
+        {
+          snprintf(file, sizeof(file), "%scpu%u/cpuidle/state%u/name",
+              _path.c_str(), c, s);
+          std::ifstream ifs(file);
+          if (ifs.good())
+            ifs >> _stateNames[s];
+          if (_stateNames[s].empty())
+            _stateNames[s] = "S" + Tools::CStr(s);
+        }
+
+    _files.resize(_cpus * _states);
+    _time.resize(_cpus * _states, 0);
+    _residency.resize(_cpus * _states, 0);
+
+    for (unsigned int c = 0; c < _cpus; c++)
+      for (unsigned int s = 0; s < _states; s++)
+        {
+          snprintf(file, sizeof(file), "%scpu%u/cpuidle/state%u/time",
+              _path.c_str(), c, s);
+          if ((access(file, R_OK) == 0) && _files[c * _states + s].open(file))
+            _openCount++;
+        }
+
+    // the first pass sets the times the next one is compared to
+    pass();
+  }
+
+  CpuIdleResidency::~CpuIdleResidency()
+  {
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  void
+  CpuIdleResidency::update()
+  {
+    pthread_mutex_lock(&_mutex);
+    pass();
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  sensor_t
+  CpuIdleResidency::getValue()
+  {
+    return _cValue;
+  }
+
+  unsigned int
+  CpuIdleResidency::getCpuCount() const
+  {
+    return _cpus;
+  }
+
+  unsigned int
+  CpuIdleResidency::getStateCount() const
+  {
+    return _states;
+  }
+
+  std::string
+  CpuIdleResidency::getStateName(unsigned int state) const
+  {
+    return (state < _states) ? _stateNames[state] : "C0";
+  }
+
+  const u64*
+  CpuIdleResidency::getResidencyMatrix() const
+  {
+    return _residency.empty() ? NULL : &_residency[0];
+  }
+
+  u64
+  CpuIdleResidency::getElapsed() const
+  {
+    return _elapsed;
+  }
+
+  float
+  CpuIdleResidency::getShare(unsigned int cpu, int state) const
+  {
+    pthread_mutex_lock(&_mutex);
+    float value = computeShare(cpu, state);
+    pthread_mutex_unlock(&_mutex);
+
+    return value;
+  }
+
+  float
+  CpuIdleResidency::refresh(u64 &seq, unsigned int cpu, int state)
+  {
+    pthread_mutex_lock(&_mutex);
+    if (seq == _passCount)
+      pass();
+    seq = _passCount;
+    float value = computeShare(cpu, state);
+    pthread_mutex_unlock(&_mutex);
+
+    return value;
+  }
+
+  float
+  CpuIdleResidency::computeShare(unsigned int cpu, int state) const
+  {
+    if ((cpu >= _cpus) || (_elapsed == 0) || (state >= (int) _states))
+      return 0.0;
+
+    const u64* row = &_residency[cpu * _states];
+    float share;
+
+    if (state >= 0)
+      share = (float) row[state] / _elapsed;
+    else
+      {
+        // C0 is the time left by the idle states
+        u64 idle = 0;
+        for (unsigned int s = 0; s < _states; s++)
+          idle += row[s];
+        share = 1.0 - (float) idle / _elapsed;
+      }
+
+    // the times of the states are not read at the same instant
+    if (share < 0.0)
+      return 0.0;
+    return (share > 1.0) ? 1.0 : share;
+  }
+
+  u64
+  CpuIdleResidency::getOpenCount() const
+  {
+    return _openCount;
+  }
+
+  u64
+  CpuIdleResidency::getPassCount() const
+  {
+    return _passCount;
+  }
+
+  CpuIdleResidency*
+  CpuIdleResidency::acquire()
+  {
+    pthread_mutex_lock(&_sharedMutex);
+    if (_shared == NULL)
+      _shared = new CpuIdleResidency();
+    _users++;
+    pthread_mutex_unlock(&_sharedMutex);
+
+    return _shared;
+  }
+
+  void
+  CpuIdleResidency::release(CpuIdleResidency* residency)
+  {
+    pthread_mutex_lock(&_sharedMutex);
+    if ((residency != NULL) && (residency == _shared) && (--_users == 0))
+      {
+        delete _shared;
+        _shared = NULL;
+      }
+    pthread_mutex_unlock(&_sharedMutex);
+  }
+
+  void
+  CpuIdleResidency::pass()
+  {
+    u64 now = SamplingClock::now();
+    u64 idle = 0;
+
+    for (unsigned int i = 0; i < _files.size(); i++)
+      {
+        // the states missing on a CPU have no path: nothing is read
+        u64 time;
+        if (!_files[i].readU64(time))
+          continue;
+
+        _residency[i] = (time > _time[i]) ? time - _time[i] : 0;
+        _time[i] = time;
+        idle += _residency[i];
+      }
+
+    _elapsed = (_last > 0) ? (now - _last) / 1000 : 0;
+    _last = now;
+    _passCount++;
+
+    if ((_elapsed > 0) && (_cpus > 0))
+      {
+        float share = (float) idle / (_elapsed * _cpus);
+        _cValue.Float = (share > 1.0) ? 1.0 : share;
+      }
+  }
+
+  CpuIdleShare::CpuIdleShare(unsigned int cpu, int state,
+      CpuIdleResidency* residency) :
+      _residency(residency), _shared(residency == NULL), _cpu(cpu), _state(
+          state)
+  {
+    if (_shared)
+      _residency = CpuIdleResidency::acquire();
+
+    _seq = _residency->getPassCount();
+    _type = Float;
+    _cValue.Float = 0.0;
+    _isActive = _residency->getStatus() && (cpu < _residency->getCpuCount())
+        && (state < (int) _residency->getStateCount());
+
+    std::string state_name =
+        (state < 0) ? std::string("C0") : _residency->getStateName(state);
+    _name = "CPU_IDLE_SHARE_" + Tools::CStr(cpu) + "_" + state_name;
+    _alias = "CIdle_" + Tools::CStr(cpu) + state_name;
+  }
+
+  CpuIdleShare::~CpuIdleShare()
+  {
+    if (_shared)
+      CpuIdleResidency::release(_residency);
+  }
+
+  void
+  CpuIdleShare::update()
+  {
+    _cValue.Float = _residency->refresh(_seq, _cpu, _state);
+  }
+
+  sensor_t
+  CpuIdleShare::getValue()
+  {
+    return _cValue;
+  }
+
+}
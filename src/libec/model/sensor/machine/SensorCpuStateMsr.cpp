@@ -11,9 +11,9 @@
 #include <libec/tools/DebugLog.h>
 #include <libec/tools/Tools.h>
 #include <libec/device/SystemInfo.h>
+#include <libec/device/MsrDevice.h>
 #include <libec/sensor/SensorCpuStateMsr.h>
 
-#include <fcntl.h>
 #include <time.h>
 #include <cpufreq.h>
 
@@ -113,8 +113,7 @@ namespace cea
   int
   CpuStateMsr::init_maxfreq_mode(void)
   {
-    int ret;
-    unsigned long long hwcr;
+    u64 hwcr;
     unsigned long min;
     CpuInfo *cpuInfo;
     cpuInfo = SystemInfo::getCpuInfo();
@@ -136,12 +135,11 @@ namespace cea
          * capable AMD machines and is therefore safe to test here.
          * Compare with Linus kernel git commit: acf01734b1747b1ec4
          */
-        ret = read_msr(0, MSR_AMD_HWCR, &hwcr);
         /*
          * If the MSR read failed, assume a Xen system that did
          * not explicitly provide access to it and assume TSC works
          */
-        if (ret != 0)
+        if (!MsrDevice::read(0, MSR_AMD_HWCR, hwcr))
           {
             //dprint("TSC read 0x%x failed - assume TSC working\n", MSR_AMD_HWCR);
             return 0;
@@ -181,57 +179,19 @@ namespace cea
       return;
   }
 
-  /*
-   * read_msr
-   *
-   * Will return 0 on success and -1 on failure.
-   * Possible errno values could be:
-   * EFAULT -If the read/write did not fully complete
-   * EIO    -If the CPU does not support MSRs
-   * ENXIO  -If the CPU does not exist
-   */
-  int
-  CpuStateMsr::read_msr(int cpu, unsigned int idx, unsigned long long *val)
-  {
-    int fd;
-    char msr_file_name[64];
-
-    sprintf(msr_file_name, "/dev/cpu/%d/msr", cpu);
-    fd = open(msr_file_name, O_RDONLY);
-    if (fd < 0)
-      return -1;
-    if (lseek(fd, idx, SEEK_CUR) == -1)
-      goto err;
-    if (read(fd, val, sizeof *val) != sizeof *val)
-      goto err;
-    close(fd);
-    return 0;
-    err: close(fd);
-    return -1;
-  }
-
-  int
-  CpuStateMsr::mperf_get_tsc(unsigned long long *tsc)
-  {
-    int ret;
-    ret = read_msr(0, MSR_TSC, tsc);
-    if (ret)
-      DebugLog::writeMsg(DebugLog::ERROR, "CpuStateMsr::mperf_get_tsc()",
-          "Reading TSC MSR failed.");
-    return ret;
-  }
+  /* the counters of a CPU are read in one pass on its open device */
+  static const unsigned int mperf_regs[] =
+    { MSR_APERF, MSR_MPERF, MSR_TSC };
 
   int
   CpuStateMsr::mperf_init_stats(unsigned int cpu)
   {
-    unsigned long long val;
-    int ret;
+    u64 val[3];
 
-    ret = read_msr(cpu, MSR_APERF, &val);
-    aperf_previous_count = val;
-    ret |= read_msr(cpu, MSR_MPERF, &val);
-    mperf_previous_count = val;
-    is_valid = !ret;
+    is_valid = MsrDevice::read(cpu, mperf_regs, val, 3);
+    aperf_previous_count = val[0];
+    mperf_previous_count = val[1];
+    tsc_at_measure_start = val[2];
 
     return 0;
   }
@@ -240,8 +200,6 @@ namespace cea
   CpuStateMsr::mperf_start(void)
   {
     clock_gettime(CLOCK_REALTIME, &time_start);
-    mperf_get_tsc(&tsc_at_measure_start);
-
     mperf_init_stats(_cpuId);
 
     return 0;
@@ -250,14 +208,12 @@ namespace cea
   int
   CpuStateMsr::mperf_measure_stats(unsigned int cpu)
   {
-    unsigned long long val;
-    int ret;
+    u64 val[3];
 
-    ret = read_msr(cpu, MSR_APERF, &val);
-    aperf_current_count = val;
-    ret |= read_msr(cpu, MSR_MPERF, &val);
-    mperf_current_count = val;
-    is_valid = !ret;
+    is_valid = MsrDevice::read(cpu, mperf_regs, val, 3);
+    aperf_current_count = val[0];
+    mperf_current_count = val[1];
+    tsc_at_measure_end = val[2];
 
     return 0;
   }
@@ -317,8 +273,6 @@ namespace cea
   CpuStateMsr::mperf_stop(void)
   {
     mperf_measure_stats(_cpuId);
-
-    mperf_get_tsc(&tsc_at_measure_end);
     clock_gettime(CLOCK_REALTIME, &time_end);
 
     return 0;
@@ -48,7 +48,7 @@ namespace cea
       }
 
     snprintf(_file, SYSFS_PATH_MAX, "%s/time", _filepath);
-    if (access(_file, R_OK) == -1)
+    if (!_time.open(_file))
       {
         std::stringstream ss;
         ss << "Sensor " << _name << " could not access the file " << _file
@@ -86,26 +86,20 @@ namespace cea
       ifs >> _cstatePower;
     ifs.close();
 
+    snprintf(_file, SYSFS_PATH_MAX, "%s/usage", _filepath);
+    _usage.open(_file);
+
     return true;
   }
 
   void
   CpuStateTime::update()
   {
-    char _file[SYSFS_PATH_MAX];
-    std::ifstream ifs;
+    u64 usage;
 
-    snprintf(_file, SYSFS_PATH_MAX, "%s/time", _filepath);
-    ifs.open(_file);
-    if (ifs.good())
-      ifs >> _cstateTime;
-    ifs.close();
-
-    snprintf(_file, SYSFS_PATH_MAX, "%s/usage", _filepath);
-    ifs.open(_file);
-    if (ifs.good())
-      ifs >> _cstateUsage;
-    ifs.close();
+    _time.readU64(_cstateTime);
+    if (_usage.readU64(usage))
+      _cstateUsage = usage;
 
     _cValue.U64 = _cstateTime;
   }
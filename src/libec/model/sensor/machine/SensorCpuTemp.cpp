@@ -111,6 +111,7 @@ namespace cea
     _type = Float;
     _cpuId = 0;
     _filepath = "";
+    _input.close();
     updatePtr = NULL;
   }
 
@@ -122,6 +123,7 @@ namespace cea
     updatePtr = source.updatePtr;
     _cpuId = source._cpuId;
     _filepath = source._filepath;
+    _input = source._input;
   }
 
   bool
@@ -146,7 +148,7 @@ namespace cea
 
             _filepath = ss.str();
 
-            if (access(_filepath.c_str(), R_OK) == 0)
+            if (_input.open(_filepath))
               _isActive = true;
             else
               DebugLog::cout << "error: The specified CPU (cpuId " << _cpuId
@@ -208,17 +210,13 @@ namespace cea
   float
   CpuTemp::updateIntel()
   {
-    std::ifstream ifs;
-    double val = -1;
+    long long val;
 
-    ifs.open(_filepath.c_str());
-    if (ifs.good())
-      {
-        ifs >> val;
-        val /= 1000;
-      }
+    // in millidegrees Celsius
+    if (_input.readS64(val))
+      return val / 1000.0;
 
-    return val;
+    return -1;
   }
 
 }
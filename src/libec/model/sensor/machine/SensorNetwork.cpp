@@ -1,10 +1,10 @@
 #include <cstdio>
 #include <iostream>
-#include <fstream>
 
 #include <libec/tools.h>
 #include <libec/Globals.h>
 #include <libec/sensor/SensorNetwork.h>
+#include <libec/device/KernelAttr.h>
 
 namespace cea
 {
@@ -14,6 +14,15 @@ namespace cea
   u64 Network::_pValue[4];
   time_t Network::_sTime;
 
+  /// /proc/net/dev shared by the 4 sensors, opened on first use: a sensor
+  /// may be built during the static initialization
+  static KernelAttr&
+  getNetDev()
+  {
+    static KernelAttr netDev("/proc/net/dev");
+    return netDev;
+  }
+
   Network::Network(Network::TypeId netType)
   {
     const std::string name[] =
@@ -68,7 +77,7 @@ namespace cea
     if (_netType >= TYPE_MAX)
       return false;
 
-    if (access("/proc/net/dev", R_OK) == 0)
+    if (getNetDev().isOpen())
       return true;
 
     return false;
@@ -95,42 +104,39 @@ namespace cea
         _cValue[2] = 0; // Transmit bytes
         _cValue[3] = 0; // Transmit packets
 
-        std::ifstream ifs("/proc/net/dev", std::ifstream::in);
-        char line[1024];
+        // about 130 bytes per interface
+        char buffer[16384];
+        if (getNetDev().read(buffer, sizeof(buffer)) <= 0)
+          return;
 
-        // read the first two lines (headers)
-        ifs.getline(line, 1024);
-        ifs.getline(line, 1024);
-
-        unsigned long d_ulong; //dummy variable
-        unsigned long rcv_bytes, rcv_pkt, snt_bytes, snt_pkt;
+        u64 field[10];
+        const char* p = buffer;
 
         // updates the value of each sensor as the sum of the
-        // packages/bytes sent/trasmitted from/to each network interface
-        while (!ifs.eof())
+        // packages/bytes sent/trasmitted from/to each network interface;
+        // the lines of the two headers have no ':'
+        while (*p != '\0')
           {
-            ifs.ignore(256, ':');
-            if (ifs.eof())
-              break;
-
-            ifs >> rcv_bytes;
-            ifs >> rcv_pkt;
-            ifs >> d_ulong; //ignore value
-            ifs >> d_ulong; //ignore value
-            ifs >> d_ulong; //ignore value
-            ifs >> d_ulong; //ignore value
-            ifs >> d_ulong; //ignore value
-            ifs >> d_ulong; //ignore value
-            ifs >> snt_bytes;
-            ifs >> snt_pkt;
-
-            _cValue[0] += rcv_bytes;
-            _cValue[1] += rcv_pkt;
-            _cValue[2] += snt_bytes;
-            _cValue[3] += snt_pkt;
+            while ((*p != ':') && (*p != '\n') && (*p != '\0'))
+              p++;
+
+            if (*p == ':')
+              {
+                p++;
+                for (int f = 0; f < 10; f++)
+                  p = KernelAttr::scanU64(p, field[f]);
+
+                _cValue[0] += field[0]; // Receive bytes
+                _cValue[1] += field[1]; // Receive packets
+                _cValue[2] += field[8]; // Transmit bytes
+                _cValue[3] += field[9]; // Transmit packets
+              }
+
+            while ((*p != '\n') && (*p != '\0'))
+              p++;
+            if (*p == '\n')
+              p++;
           }
-
-        ifs.close();
       }
   }
 
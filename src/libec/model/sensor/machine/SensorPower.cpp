@@ -7,6 +7,9 @@
 // Description : Power Sensor available on the G5K plataform
 //============================================================================
 
+#include <ctime>
+#include <cerrno>
+
 #include <libec/sensor/SensorPower.h>
 #include <libec/tools/Tools.h>
 #include <libec/tools/DebugLog.h>
@@ -16,11 +19,45 @@ namespace cea
   PowerMeter::PowerMeter()
   {
     clean();
+    initSamples();
   }
 
   PowerMeter::PowerMeter(const std::string &xmlTag) :
       Sensor(xmlTag)
   {
+    initSamples();
+  }
+
+  PowerMeter::~PowerMeter()
+  {
+    pthread_cond_destroy(&_sampleCond);
+    pthread_mutex_destroy(&_sampleMutex);
+  }
+
+  void
+  PowerMeter::initSamples()
+  {
+    pthread_condattr_t attr;
+
+    _publishes = false;
+    _sampleSeq = 0;
+    _sampleTime = 0;
+
+    // timeouts are not affected by changes of the wall clock
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_sampleCond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&_sampleMutex, NULL);
+  }
+
+  u64
+  PowerMeter::now()
+  {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) (ts.tv_sec) * 1000000000ull + ts.tv_nsec;
   }
 
   unsigned
@@ -28,20 +65,17 @@ namespace cea
   {
     if (_latency == -1)
       {
-        unsigned time;
-        timeval tstart, tend; // Start and end times
+        u64 tstart, tend; // Times of the samples
 
         // wait 'till the first change on the power
-        time = 0;
         waitUpdate();
+        tstart = getSampleTime();
 
-        // keep track of the update time
-        gettimeofday(&tstart, NULL);
+        // the latency is the time between the two samples of the device
         waitUpdate();
-        gettimeofday(&tend, NULL);
-        time = Tools::timevaldiff(tstart, tend);
+        tend = getSampleTime();
 
-        return time;
+        return (unsigned) ((tend - tstart) / 1000000ull);
       }
     else
       return _latency;
@@ -50,6 +84,17 @@ namespace cea
   void
   PowerMeter::waitUpdate()
   {
+    if (_publishes)
+      {
+        if (!waitSample(getSampleSeq(), POWER_WAIT_UPDATE_TIMEOUT))
+          DebugLog::writeMsg(DebugLog::ERROR, "PowerMeter::waitUpdate()",
+              "The time spent waiting for a new value for the power "
+                  "meter is greater than 2 minutes. Leaving the method..");
+        update();
+        return;
+      }
+
+    // the meter is only read here, poll it until its value changes
     float curr, prev;
     int count;
 
@@ -58,11 +103,11 @@ namespace cea
     count = 0;
     while (curr == prev)
       {
+        usleep(10000);
         update();
         curr = getValue().Float;
-        usleep(10000);
         count++;
-        if (count > 12000)
+        if (count > POWER_WAIT_UPDATE_TIMEOUT / 10)
           {
             DebugLog::writeMsg(DebugLog::ERROR, "PowerMeter::waitUpdate()",
                 "The time spent waiting for a new value for the power "
@@ -70,6 +115,67 @@ namespace cea
             return;
           }
       }
+    publishSample(now());
+  }
+
+  bool
+  PowerMeter::waitSample(u64 seq, unsigned int timeout)
+  {
+    struct timespec deadline;
+    int err = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * 1000000l;
+    if (deadline.tv_nsec >= 1000000000l)
+      {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000l;
+      }
+
+    pthread_mutex_lock(&_sampleMutex);
+    while ((_sampleSeq <= seq) && (err != ETIMEDOUT))
+      err = pthread_cond_timedwait(&_sampleCond, &_sampleMutex, &deadline);
+    bool ok = (_sampleSeq > seq);
+    pthread_mutex_unlock(&_sampleMutex);
+
+    return ok;
+  }
+
+  void
+  PowerMeter::publishSample(u64 time)
+  {
+    pthread_mutex_lock(&_sampleMutex);
+    _sampleSeq++;
+    _sampleTime = time;
+    pthread_cond_broadcast(&_sampleCond);
+    pthread_mutex_unlock(&_sampleMutex);
+  }
+
+  bool
+  PowerMeter::isPublishing()
+  {
+    return _publishes;
+  }
+
+  u64
+  PowerMeter::getSampleSeq()
+  {
+    pthread_mutex_lock(&_sampleMutex);
+    u64 seq = _sampleSeq;
+    pthread_mutex_unlock(&_sampleMutex);
+
+    return seq;
+  }
+
+  u64
+  PowerMeter::getSampleTime()
+  {
+    pthread_mutex_lock(&_sampleMutex);
+    u64 time = _sampleTime;
+    pthread_mutex_unlock(&_sampleMutex);
+
+    return time;
   }
 
   void
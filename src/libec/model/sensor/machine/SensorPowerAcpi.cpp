@@ -1,5 +1,4 @@
 #include <iostream>
-#include <fstream>
 #include <libec/sensor/SensorPowerAcpi.h>
 #include <libec/tools/Tools.h>
 #include <libec/tools/DebugLog.h>
@@ -17,11 +16,11 @@ namespace cea
     _cValue.Float = 0.0;
 
     // Voltage in uV (micro volts):
-    _fpVoltage = "/sys/class/power_supply/BAT0/voltage_now";
+    _voltage.open("/sys/class/power_supply/BAT0/voltage_now");
     // Current in uA (micro amperes):
-    _fpCurrent = "/sys/class/power_supply/BAT0/current_now";
+    _current.open("/sys/class/power_supply/BAT0/current_now");
     // Battery state
-    _fpState = "/sys/class/power_supply/BAT0/status";
+    _state.open("/sys/class/power_supply/BAT0/status");
 
     _type = Float;
     _isActive = checkActivity();
@@ -31,11 +30,11 @@ namespace cea
       PowerMeter(xmlTag)
   {
     // Voltage in uV (micro volts):
-    _fpVoltage = "/sys/class/power_supply/BAT0/voltage_now";
+    _voltage.open("/sys/class/power_supply/BAT0/voltage_now");
     // Current in uA (micro amperes):
-    _fpCurrent = "/sys/class/power_supply/BAT0/current_now";
+    _current.open("/sys/class/power_supply/BAT0/current_now");
     // Battery state
-    _fpState = "/sys/class/power_supply/BAT0/status";
+    _state.open("/sys/class/power_supply/BAT0/status");
 
     _type = Float;
     _isActive = checkActivity();
@@ -48,8 +47,8 @@ namespace cea
 
     // Check if files containing the current voltage and current
     // have reading permissions
-    val = (access(_fpVoltage, R_OK) == 0);
-    val &= (access(_fpCurrent, R_OK) == 0);
+    val = _voltage.isOpen();
+    val &= _current.isOpen();
 
     return val;
   }
@@ -61,22 +60,15 @@ namespace cea
   void
   AcpiPowerMeter::update()
   {
-    unsigned long int c, v;
+    u64 c, v;
 
     _pTime = _cTime;
     _cTime = time(NULL);
 
     if (getState() == Discharging)
       {
-        _input.open(_fpCurrent, std::ifstream::in);
-        _input >> c;
-        _input.close();
-
-        _input.open(_fpVoltage, std::ifstream::in);
-        _input >> v;
-        _input.close();
-
-        _cValue.Float = c * v * (1.0e-12f);
+        if (_current.readU64(c) && _voltage.readU64(v))
+          _cValue.Float = c * v * (1.0e-12f);
       }
     else
       _cValue.Float = 0.0f;
@@ -110,13 +102,12 @@ namespace cea
   char
   AcpiPowerMeter::getState()
   {
-    char c;
+    char c[16];
 
-    _input.open(_fpState, std::ifstream::in);
-    _input >> c;
-    _input.close();
+    if (_state.read(c, sizeof(c)) <= 0)
+      return Unknown;
 
-    switch (c)
+    switch (c[0])
       {
     case 'F':
       return Full;
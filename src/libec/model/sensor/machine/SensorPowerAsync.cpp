@@ -0,0 +1,192 @@
+#include <ctime>
+#include <cstring>
+
+#include <libec/sensor/SensorPowerAsync.h>
+#include <libec/tools/DebugLog.h>
+
+namespace cea
+{
+  const char* AsyncPowerMeter::ClassName = "AsyncPowerMeter";
+
+  AsyncPowerMeter::AsyncPowerMeter(PowerMeter* meter, unsigned int period)
+  {
+    _meter = meter;
+    _period = (period > 0) ? period : 1;
+    _count = 0;
+    _published = -1.0f;
+    _running = false;
+    _started = false;
+    std::memset(_ring, 0, sizeof(_ring));
+
+    _name = meter->getName();
+    _alias = meter->getAlias();
+    _type = Float;
+    _cValue.Float = 0.0f;
+    _isActive = meter->getStatus();
+
+    if (_isActive)
+      {
+        _publishes = true;
+        _running = true;
+        _started = (pthread_create(&_thread, NULL, run, this) == 0);
+        if (!_started)
+          {
+            DebugLog::writeMsg(DebugLog::ERROR,
+                "AsyncPowerMeter::AsyncPowerMeter()",
+                "The polling thread of '%s' could not be created",
+                _name.c_str());
+            _running = false;
+            _publishes = false;
+            _isActive = false;
+          }
+      }
+  }
+
+  AsyncPowerMeter::~AsyncPowerMeter()
+  {
+    if (_started)
+      {
+        _running = false;
+        __sync_synchronize();
+        pthread_join(_thread, NULL);
+      }
+
+    delete _meter;
+  }
+
+  void*
+  AsyncPowerMeter::run(void* arg)
+  {
+    AsyncPowerMeter* pm = (AsyncPowerMeter*) arg;
+    struct timespec wait;
+    Sample s;
+
+    wait.tv_sec = pm->_period / 1000;
+    wait.tv_nsec = (pm->_period % 1000) * 1000000l;
+
+    while (pm->_running)
+      {
+        pm->_meter->update();
+        s.value = pm->_meter->getValue().Float;
+        s.time = now();
+        pm->push(s);
+
+        // a new value of the device is a new sample
+        if ((pm->_count == 1) || (s.value != pm->_published))
+          {
+            pm->_published = s.value;
+            pm->publishSample(s.time);
+          }
+
+        nanosleep(&wait, NULL);
+      }
+
+    return NULL;
+  }
+
+  void
+  AsyncPowerMeter::push(const Sample &sample)
+  {
+    Slot &slot = _ring[_count & (ASYNC_POWER_RING_SIZE - 1)];
+
+    // readers retry while the sequence is odd or changed
+    slot.seq++;
+    __sync_synchronize();
+    slot.sample = sample;
+    __sync_synchronize();
+    slot.seq++;
+
+    // publish the sample
+    __sync_synchronize();
+    _count = _count + 1;
+  }
+
+  bool
+  AsyncPowerMeter::getSample(unsigned int age, Sample &sample)
+  {
+    for (;;)
+      {
+        u64 count = _count;
+        __sync_synchronize();
+
+        // keep a slot of margin for the one being written
+        if ((age >= count) || (age >= ASYNC_POWER_RING_SIZE - 1))
+          return false;
+
+        const Slot &slot = _ring[(count - 1 - age)
+            & (ASYNC_POWER_RING_SIZE - 1)];
+        unsigned int seq = slot.seq;
+        __sync_synchronize();
+        sample.time = slot.sample.time;
+        sample.value = slot.sample.value;
+        __sync_synchronize();
+
+        if (((seq & 1) == 0) && (seq == slot.seq))
+          return true;
+      }
+  }
+
+  void
+  AsyncPowerMeter::update()
+  {
+    Sample s;
+
+    _pTime = _cTime;
+    _cTime = time(NULL);
+
+    if (getSample(0, s))
+      _cValue.Float = s.value;
+  }
+
+  sensor_t
+  AsyncPowerMeter::getValue()
+  {
+    return _cValue;
+  }
+
+  float
+  AsyncPowerMeter::getValueAt(u64 time)
+  {
+    Sample next, prev;
+
+    if (!getSample(0, next))
+      return 0.0f;
+
+    // walk back to the first sample not after the time
+    for (unsigned int age = 1; next.time > time; age++)
+      {
+        if (!getSample(age, prev))
+          return next.value;
+        if (prev.time <= time)
+          {
+            if (next.time == prev.time)
+              return next.value;
+            return prev.value
+                + (next.value - prev.value) * (float) (time - prev.time)
+                    / (float) (next.time - prev.time);
+          }
+        next = prev;
+      }
+
+    return next.value;
+  }
+
+  u64
+  AsyncPowerMeter::getSampleCount()
+  {
+    return _count;
+  }
+
+  PowerMeter*
+  AsyncPowerMeter::getMeter()
+  {
+    return _meter;
+  }
+
+  const char*
+  AsyncPowerMeter::getClassName()
+  {
+    return ClassName;
+  }
+
+}
@@ -8,66 +8,120 @@
 //============================================================================
 
 #include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <libec/sensor/SensorPowerG5k.h>
 #include <libec/tools/Tools.h>
 #include <libec/tools/DebugLog.h>
 
 namespace cea
 {
-  IpOut::IpOut(std::string ip, unsigned int outlet)
+  G5kApi::G5kApi()
   {
-    Ip = ip;
-    Outlet = outlet;
+    Client = NULL;
+    Seq = 0;
   }
 
   // Static variables
   const char* G5kPowerMeter::ClassName = "G5kPowerMeter";
   bool G5kPowerMeter::_isMapBuilt = false;
-  std::map<std::string, IpOut> G5kPowerMeter::_hostPduMap;
+  std::map<std::string, float> G5kPowerMeter::_hostMap;
+  std::map<std::string, G5kApi> G5kPowerMeter::_apiMap;
+  std::string G5kPowerMeter::_apiHost;
+  int G5kPowerMeter::_apiPort = G5K_API_PORT;
+  std::string G5kPowerMeter::_apiPath = G5K_API_PATH;
+  pthread_mutex_t G5kPowerMeter::_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+  // Splits a G5K hostname (node.site.grid5000.fr) into node and site
+  static void
+  splitHostname(const std::string &hostname, std::string &node,
+      std::string &site)
+  {
+    size_t dot = hostname.find('.');
+    node = hostname.substr(0, dot);
+    site = "";
+    if (dot != std::string::npos)
+      site = hostname.substr(dot + 1, hostname.find('.', dot + 1) - dot - 1);
+  }
 
   // Public methods
   G5kPowerMeter::G5kPowerMeter()
   {
-    char hostname[30];
-    gethostname(hostname, 30);
+    char hostname[256];
+    std::string node, site;
+
+    gethostname(hostname, sizeof(hostname));
+    hostname[sizeof(hostname) - 1] = '\0';
+    splitHostname(hostname, node, site);
+
     _name = hostname;
     _name = "G5KPDU_" + _name;
     _alias = "G5KPDU";
 
-    _cmd = getCmdLine(hostname);
-    _type = Float;
-    _cValue.Float = _pValue.Float = 0.0;
+    init(node, site);
+  }
 
-    if (!_isMapBuilt)
-      buildHostPduMap();
+  G5kPowerMeter::G5kPowerMeter(const std::string &node,
+      const std::string &site)
+  {
+    _name = "G5KPDU_" + node + "." + site + ".grid5000.fr";
+    _alias = "G5KPDU";
 
-    _isActive = checkActivity();
+    init(node, site);
   }
 
   G5kPowerMeter::G5kPowerMeter(const std::string &xmlTag) :
       PowerMeter(xmlTag)
   {
-    char hostname[30];
-    gethostname(hostname, 30);
-    _cmd = getCmdLine(hostname);
-    _type = Float;
-    _cValue.Float = _pValue.Float = 0.0;
+    char hostname[256];
+    std::string node, site;
 
-    if (!_isMapBuilt)
-      buildHostPduMap();
+    gethostname(hostname, sizeof(hostname));
+    hostname[sizeof(hostname) - 1] = '\0';
+    splitHostname(hostname, node, site);
 
-    _isActive = checkActivity();
+    init(node, site);
   }
 
   G5kPowerMeter::~G5kPowerMeter()
   {
   }
 
+  void
+  G5kPowerMeter::init(const std::string &node, const std::string &site)
+  {
+    _hostname = node + "." + site + ".grid5000.fr";
+    _site = site;
+    _type = Float;
+    _cValue.Float = _pValue.Float = 0.0;
+
+    pthread_mutex_lock(&_mutex);
+    if (!_isMapBuilt)
+      buildHostMap();
+
+    // a new meter reads the last answer, unless there is none yet
+    unsigned int seq = _apiMap[_site].Seq;
+    _seq = (seq > 0) ? seq - 1 : 0;
+    pthread_mutex_unlock(&_mutex);
+
+    _isActive = checkActivity();
+  }
+
   bool
   G5kPowerMeter::checkActivity()
   {
-    if (_cmd == "")
-      return false;
+    pthread_mutex_lock(&_mutex);
+    bool known = (_hostMap.find(_hostname) != _hostMap.end());
+    pthread_mutex_unlock(&_mutex);
+
+    if (!known)
+      {
+        cea::DebugLog::writeMsg(cea::DebugLog::ERROR, "G5KPowerMeter",
+            "The specified hostname has no wattmeter or is not supported "
+                "by this class.");
+        return false;
+      }
 
     update();
     if (_cValue.Float == -1.0)
@@ -83,371 +137,161 @@ namespace cea
     _pTime = _cTime;
     _cTime = time(NULL);
 
-    std::string out = Tools::exec(_cmd.c_str());
-    if (out == "")
+    pthread_mutex_lock(&_mutex);
+
+    // the first meter of the site updated in a tick requests the power of
+    // all its nodes
+    G5kApi &api = _apiMap[_site];
+    if (_seq == api.Seq)
+      fetch(_site, api);
+    _seq = api.Seq;
+
+    std::map<std::string, float>::iterator it = _hostMap.find(_hostname);
+    if (it == _hostMap.end())
       _cValue.Float = -1.0;
     else
-      {
-        std::stringstream ss;
-        ss.str(out);
-        ss >> _cValue.Float;
-      }
+      _cValue.Float = it->second;
+
+    pthread_mutex_unlock(&_mutex);
   }
 
-  const char*
-  G5kPowerMeter::getClassName()
+  void
+  G5kPowerMeter::setApi(const std::string &host, int port,
+      const std::string &path)
   {
-    return ClassName;
+    pthread_mutex_lock(&_mutex);
+    for (std::map<std::string, G5kApi>::iterator it = _apiMap.begin();
+        it != _apiMap.end(); it++)
+      {
+        delete it->second.Client;
+        it->second.Client = NULL;
+      }
+    _apiHost = host;
+    _apiPort = port;
+    _apiPath = path;
+    pthread_mutex_unlock(&_mutex);
   }
 
-  /* Changing connection method..
-   bool buildConnectionString(std::string hostname)
-   {
-   // G5K Hostnames grid-id.site.grid5000.fr
-   std:string g5k = "grid5000.fr";
-   if (hostname.length() >= g5k.length()) {
-   return (0 == hostname.compare (hostname.length() - g5k.length(), g5k.length(), g5k));
-   } else {
-   return false;
-   }
-   //check if is a G5K host // if string ends with grid5000.fr
+  unsigned int
+  G5kPowerMeter::getRequestCount()
+  {
+    unsigned int count = 0;
 
-   //get site name
+    pthread_mutex_lock(&_mutex);
+    for (std::map<std::string, G5kApi>::iterator it = _apiMap.begin();
+        it != _apiMap.end(); it++)
+      count += it->second.Seq;
+    pthread_mutex_unlock(&_mutex);
 
-   //get nodeID
-   }
-   */
+    return count;
+  }
 
-  // Private methods
-  void
-  G5kPowerMeter::buildHostPduMap()
+  unsigned int
+  G5kPowerMeter::getConnectCount()
   {
-    // Populates the table that maps all the host names of G5K nodes
-    // into their PDU's IP and outlet number
-    _hostPduMap["stremi-1.reims.grid5000.fr"] = IpOut("172.17.160.121", 1);
-    _hostPduMap["stremi-2.reims.grid5000.fr"] = IpOut("172.17.160.121", 2);
-    _hostPduMap["stremi-3.reims.grid5000.fr"] = IpOut("172.17.160.121", 3);
-    _hostPduMap["stremi-4.reims.grid5000.fr"] = IpOut("172.17.160.121", 4);
-    _hostPduMap["stremi-5.reims.grid5000.fr"] = IpOut("172.17.160.121", 5);
-    _hostPduMap["stremi-6.reims.grid5000.fr"] = IpOut("172.17.160.121", 6);
-    _hostPduMap["stremi-7.reims.grid5000.fr"] = IpOut("172.17.160.121", 7);
-    _hostPduMap["stremi-8.reims.grid5000.fr"] = IpOut("172.17.160.121", 8);
-    _hostPduMap["stremi-9.reims.grid5000.fr"] = IpOut("172.17.160.121", 9);
-    _hostPduMap["stremi-10.reims.grid5000.fr"] = IpOut("172.17.160.121", 10);
-    _hostPduMap["stremi-11.reims.grid5000.fr"] = IpOut("172.17.160.121", 11);
-    _hostPduMap["stremi-12.reims.grid5000.fr"] = IpOut("172.17.160.121", 12);
-    _hostPduMap["stremi-13.reims.grid5000.fr"] = IpOut("172.17.160.121", 13);
-    _hostPduMap["stremi-14.reims.grid5000.fr"] = IpOut("172.17.160.121", 14);
-    _hostPduMap["stremi-15.reims.grid5000.fr"] = IpOut("172.17.160.121", 15);
-    _hostPduMap["stremi-16.reims.grid5000.fr"] = IpOut("172.17.160.121", 16);
-    _hostPduMap["stremi-17.reims.grid5000.fr"] = IpOut("172.17.160.121", 17);
-    _hostPduMap["stremi-18.reims.grid5000.fr"] = IpOut("172.17.160.120", 1);
-    _hostPduMap["stremi-19.reims.grid5000.fr"] = IpOut("172.17.160.120", 2);
-    _hostPduMap["stremi-20.reims.grid5000.fr"] = IpOut("172.17.160.120", 3);
-    _hostPduMap["stremi-21.reims.grid5000.fr"] = IpOut("172.17.160.120", 4);
-    _hostPduMap["stremi-22.reims.grid5000.fr"] = IpOut("172.17.160.120", 5);
-    _hostPduMap["stremi-23.reims.grid5000.fr"] = IpOut("172.17.160.120", 6);
-    _hostPduMap["stremi-24.reims.grid5000.fr"] = IpOut("172.17.160.120", 7);
-    _hostPduMap["stremi-25.reims.grid5000.fr"] = IpOut("172.17.160.120", 8);
-    _hostPduMap["stremi-26.reims.grid5000.fr"] = IpOut("172.17.160.120", 9);
-    _hostPduMap["stremi-27.reims.grid5000.fr"] = IpOut("172.17.160.120", 10);
-    _hostPduMap["stremi-28.reims.grid5000.fr"] = IpOut("172.17.160.120", 11);
-    _hostPduMap["stremi-29.reims.grid5000.fr"] = IpOut("172.17.160.120", 12);
-    _hostPduMap["stremi-30.reims.grid5000.fr"] = IpOut("172.17.160.120", 13);
-    _hostPduMap["stremi-31.reims.grid5000.fr"] = IpOut("172.17.160.120", 14);
-    _hostPduMap["stremi-32.reims.grid5000.fr"] = IpOut("172.17.160.120", 15);
-    _hostPduMap["stremi-33.reims.grid5000.fr"] = IpOut("172.17.160.120", 16);
-    _hostPduMap["stremi-34.reims.grid5000.fr"] = IpOut("172.17.160.120", 17);
-    _hostPduMap["stremi-35.reims.grid5000.fr"] = IpOut("172.17.160.122", 1);
-    _hostPduMap["stremi-36.reims.grid5000.fr"] = IpOut("172.17.160.122", 2);
-    _hostPduMap["stremi-37.reims.grid5000.fr"] = IpOut("172.17.160.122", 3);
-    _hostPduMap["stremi-38.reims.grid5000.fr"] = IpOut("172.17.160.122", 4);
-    _hostPduMap["stremi-39.reims.grid5000.fr"] = IpOut("172.17.160.122", 5);
-    _hostPduMap["stremi-40.reims.grid5000.fr"] = IpOut("172.17.160.122", 6);
-    _hostPduMap["stremi-41.reims.grid5000.fr"] = IpOut("172.17.160.122", 7);
-    _hostPduMap["stremi-42.reims.grid5000.fr"] = IpOut("172.17.160.122", 8);
-    _hostPduMap["stremi-43.reims.grid5000.fr"] = IpOut("172.17.160.122", 9);
-    _hostPduMap["stremi-44.reims.grid5000.fr"] = IpOut("172.17.160.122", 10);
-    /* Changing connection method...
-     _hostPduMap["stremi-1.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.1";
-     _hostPduMap["stremi-2.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.2";
-     _hostPduMap["stremi-3.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.3";
-     _hostPduMap["stremi-4.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.4";
-     _hostPduMap["stremi-5.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.5";
-     _hostPduMap["stremi-6.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.6";
-     _hostPduMap["stremi-7.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.7";
-     _hostPduMap["stremi-8.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.8";
-     _hostPduMap["stremi-9.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.9";
-     _hostPduMap["stremi-10.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.10";
-     _hostPduMap["stremi-11.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.11";
-     _hostPduMap["stremi-12.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.12";
-     _hostPduMap["stremi-13.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.13";
-     _hostPduMap["stremi-14.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.14";
-     _hostPduMap["stremi-15.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.15";
-     _hostPduMap["stremi-16.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.16";
-     _hostPduMap["stremi-17.reims.grid5000.fr"] =
-     "172.17.160.121 outletActivePower.17";
-     _hostPduMap["stremi-18.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.1";
-     _hostPduMap["stremi-19.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.2";
-     _hostPduMap["stremi-20.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.3";
-     _hostPduMap["stremi-21.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.4";
-     _hostPduMap["stremi-22.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.5";
-     _hostPduMap["stremi-23.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.6";
-     _hostPduMap["stremi-24.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.7";
-     _hostPduMap["stremi-25.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.8";
-     _hostPduMap["stremi-26.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.9";
-     _hostPduMap["stremi-27.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.10";
-     _hostPduMap["stremi-28.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.11";
-     _hostPduMap["stremi-29.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.12";
-     _hostPduMap["stremi-30.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.13";
-     _hostPduMap["stremi-31.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.14";
-     _hostPduMap["stremi-32.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.15";
-     _hostPduMap["stremi-33.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.16";
-     _hostPduMap["stremi-34.reims.grid5000.fr"] =
-     "172.17.160.120 outletActivePower.17";
-     _hostPduMap["stremi-35.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.1";
-     _hostPduMap["stremi-36.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.2";
-     _hostPduMap["stremi-37.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.3";
-     _hostPduMap["stremi-38.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.4";
-     _hostPduMap["stremi-39.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.5";
-     _hostPduMap["stremi-40.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.6";
-     _hostPduMap["stremi-41.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.7";
-     _hostPduMap["stremi-42.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.8";
-     _hostPduMap["stremi-43.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.9";
-     _hostPduMap["stremi-44.reims.grid5000.fr"] =
-     "172.17.160.122 outletActivePower.10";
-     _hostPduMap["graphene-105.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.1";
-     _hostPduMap["graphene-106.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.2";
-     _hostPduMap["graphene-107.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.3";
-     _hostPduMap["graphene-108.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.4";
-     _hostPduMap["graphene-109.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.5";
-     _hostPduMap["graphene-110.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.6";
-     _hostPduMap["graphene-111.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.7";
-     _hostPduMap["graphene-112.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.8";
-     _hostPduMap["graphene-113.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.11";
-     _hostPduMap["graphene-114.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.0.12";
-     //TODO: debug Nancy nodes outlet Id could also be 0.13.
-     _hostPduMap["graphene-115.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.1";
-     _hostPduMap["graphene-116.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.2";
-     _hostPduMap["graphene-117.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.5";
-     _hostPduMap["graphene-118.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.6";
-     _hostPduMap["graphene-119.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.7";
-     _hostPduMap["graphene-120.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.8";
-     _hostPduMap["graphene-121.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.9";
-     _hostPduMap["graphene-122.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.10";
-     _hostPduMap["graphene-123.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.11";
-     _hostPduMap["graphene-124.nancy.grid5000.fr"] =
-     "graphene-pdu7.nancy.grid5000.fr outletWatts.1.12";
-     _hostPduMap["graphene-125.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.1";
-     _hostPduMap["graphene-126.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.2";
-     _hostPduMap["graphene-127.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.3";
-     _hostPduMap["graphene-128.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.4";
-     _hostPduMap["graphene-129.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.5";
-     _hostPduMap["graphene-130.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.6";
-     _hostPduMap["graphene-131.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.7";
-     _hostPduMap["graphene-132.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.8";
-     _hostPduMap["graphene-133.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.11";
-     _hostPduMap["graphene-134.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.0.12";
-     _hostPduMap["graphene-135.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.1";
-     _hostPduMap["graphene-136.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.2";
-     _hostPduMap["graphene-137.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.5";
-     _hostPduMap["graphene-138.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.6";
-     _hostPduMap["graphene-139.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.7";
-     _hostPduMap["graphene-140.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.8";
-     _hostPduMap["graphene-141.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.9";
-     _hostPduMap["graphene-142.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.10";
-     _hostPduMap["graphene-143.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.11";
-     _hostPduMap["graphene-144.nancy.grid5000.fr"] =
-     "graphene-pdu8.nancy.grid5000.fr outletWatts.1.12";
-     // Warning: Rennes nodes has more than one node plugged in the same PDU,
-     // which gives coarse grained power monitoring
-     _hostPduMap["parapluie-1.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-2.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-3.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-4.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-5.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-6.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-7.rennes.grid5000.fr"] =
-     "parapluie-pdu-1.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-8.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-9.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-10.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-11.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-12.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-13.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-14.rennes.grid5000.fr"] =
-     "parapluie-pdu-3.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-15.rennes.grid5000.fr"] =
-     "parapluie-pdu-2.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-16.rennes.grid5000.fr"] =
-     "parapluie-pdu-2.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-17.rennes.grid5000.fr"] =
-     "parapluie-pdu-2.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-18.rennes.grid5000.fr"] =
-     "parapluie-pdu-2.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-19.rennes.grid5000.fr"] =
-     "parapluie-pdu-2.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-20.rennes.grid5000.fr"] =
-     "parapluie-pdu-2.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-21.rennes.grid5000.fr"] =
-     "parapluie-pdu-6.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-22.rennes.grid5000.fr"] =
-     "parapluie-pdu-6.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-23.rennes.grid5000.fr"] =
-     "parapluie-pdu-6.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-24.rennes.grid5000.fr"] =
-     "parapluie-pdu-6.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-25.rennes.grid5000.fr"] =
-     "parapluie-pdu-6.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-26.rennes.grid5000.fr"] =
-     "parapluie-pdu-6.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-27.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-28.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-29.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-30.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-31.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-32.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-33.rennes.grid5000.fr"] =
-     "parapluie-pdu-5.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-34.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-35.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-36.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-37.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-38.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-39.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     _hostPduMap["parapluie-40.rennes.grid5000.fr"] =
-     "parapluie-pdu-4.rennes.grid5000.fr rPDUIdentDevicePowerWatts.0";
-     */
-    _isMapBuilt = true;
+    unsigned int count = 0;
+
+    pthread_mutex_lock(&_mutex);
+    for (std::map<std::string, G5kApi>::iterator it = _apiMap.begin();
+        it != _apiMap.end(); it++)
+      if (it->second.Client != NULL)
+        count += it->second.Client->getConnectCount();
+    pthread_mutex_unlock(&_mutex);
+
+    return count;
   }
 
-  std::string
-  G5kPowerMeter::getCmdLine(std::string hostname)
+  bool
+  G5kPowerMeter::fetch(const std::string &site, G5kApi &api)
   {
-    std::map<std::string, IpOut>::iterator it;
-    std::stringstream out;
+    std::string body;
+    int status = 0;
 
-    it = _hostPduMap.find(hostname);
-    if (it == _hostPduMap.end())
+    if (api.Client == NULL)
       {
-        // Hostname not mapped
-        cea::DebugLog::writeMsg(cea::DebugLog::ERROR, "G5KPowerMeter",
-            "The specified hostname has no wattmeter or is not supported by this class.");
-        return "";
+        if (_apiHost.empty())
+          api.Client = new HttpClient("kwapi." + site + ".grid5000.fr",
+              G5K_API_PORT);
+        else
+          api.Client = new HttpClient(_apiHost, _apiPort);
+      }
+
+    // nodes of the site missing from the answer have no power
+    std::string suffix = "." + site + ".grid5000.fr";
+    for (std::map<std::string, float>::iterator it = _hostMap.begin();
+        it != _hostMap.end(); it++)
+      if ((it->first.size() > suffix.size())
+          && (it->first.compare(it->first.size() - suffix.size(),
+              suffix.size(), suffix) == 0))
+        it->second = -1.0f;
+
+    api.Seq++;
+    if (!api.Client->get(_apiPath, body, &status) || (status != 200))
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "G5kPowerMeter::fetch()",
+            "The metrology API of %s did not answer (status %d)",
+            site.c_str(), status);
+        return false;
+      }
+
+    // {"probes": {"<site>.<node>": {"w": <watts>, ...}, ...}}
+    size_t pos = body.find("\"probes\"");
+    if (pos == std::string::npos)
+      return false;
+    pos = body.find('{', pos);
+
+    while (pos != std::string::npos)
+      {
+        size_t keyStart = body.find('"', pos + 1);
+        if (keyStart == std::string::npos)
+          break;
+        size_t keyEnd = body.find('"', keyStart + 1);
+        size_t objStart = body.find('{', keyEnd);
+        size_t objEnd = body.find('}', objStart);
+        if ((keyEnd == std::string::npos) || (objStart == std::string::npos)
+            || (objEnd == std::string::npos))
+          break;
+
+        std::string key = body.substr(keyStart + 1, keyEnd - keyStart - 1);
+        size_t w = body.find("\"w\"", objStart);
+        size_t dot = key.find('.');
+        if ((w != std::string::npos) && (w < objEnd)
+            && (dot != std::string::npos))
+          {
+            size_t colon = body.find(':', w);
+            std::string host = key.substr(dot + 1) + "." + key.substr(0, dot)
+                + ".grid5000.fr";
+            std::map<std::string, float>::iterator it = _hostMap.find(host);
+            if (it != _hostMap.end())
+              it->second = strtod(body.c_str() + colon + 1, NULL);
+          }
+
+        pos = objEnd;
       }
 
-    /* Changing connection method ...
-     out << "snmpget -v 1 -c public " << it->second.Ip << " outletActivePower."
-     << it->second.Outlet << " | cut -d\" \" -f 4";
-     */
-    out << "snmpget -v 1 -c public " << it->second.Ip << " outletActivePower."
-        << it->second.Outlet << " | cut -d\" \" -f 4";
+    return true;
+  }
 
-    std::string res = out.str();
+  const char*
+  G5kPowerMeter::getClassName()
+  {
+    return ClassName;
+  }
 
-    return res;
+  // Private methods
+  void
+  G5kPowerMeter::buildHostMap()
+  {
+    // Populates the table of the host names of the G5K nodes having a
+    // wattmeter, their power being unknown until the first request
+    char hostname[64];
+
+    for (int node = 1; node <= 44; node++)
+      {
+        snprintf(hostname, sizeof(hostname), "stremi-%d.reims.grid5000.fr",
+            node);
+        _hostMap[hostname] = -1.0f;
+      }
+    _isMapBuilt = true;
   }
 }
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <libec/sensor/SensorPowerRapl.h>
+#include <libec/tools/FileTools.h>
+#include <libec/tools/DebugLog.h>
+
+namespace cea
+{
+  const char* RaplPowerMeter::ClassName = "RaplPowerMeter";
+
+  // Public methods
+  RaplPowerMeter::RaplPowerMeter(const std::string &root)
+  {
+    _name = "RAPL_POWER_METER";
+    _alias = "PM_RAPL";
+
+    _cValue.Float = 0.0;
+    _type = Float;
+    _isActive = init(root);
+  }
+
+  RaplPowerMeter::RaplPowerMeter(const std::string &xmlTag,
+      const std::string &root) :
+      PowerMeter(xmlTag)
+  {
+    _type = Float;
+    _isActive = init(root);
+  }
+
+  RaplPowerMeter::~RaplPowerMeter()
+  {
+    for (unsigned int i = 0; i < _domains.size(); i++)
+      close(_domains[i].fd);
+  }
+
+  bool
+  RaplPowerMeter::readCounter(int fd, u64 &value)
+  {
+    char buf[32];
+
+    ssize_t len = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (len <= 0)
+      return false;
+    buf[len] = '\0';
+
+    value = strtoull(buf, NULL, 10);
+    return true;
+  }
+
+  bool
+  RaplPowerMeter::init(const std::string &root)
+  {
+    DIR* dir;
+    struct dirent* ent;
+    std::vector<std::string> zones;
+
+    _started = false;
+    _cTs.tv_sec = _cTs.tv_nsec = 0;
+
+    dir = opendir(root.c_str());
+    if (dir == NULL)
+      return false;
+
+    // zones are named intel-rapl:<package>[:<subzone>], the intel-rapl
+    // directory itself is the control type
+    while ((ent = readdir(dir)) != NULL)
+      if (std::strncmp(ent->d_name, "intel-rapl:", 11) == 0)
+        zones.push_back(ent->d_name);
+    closedir(dir);
+    std::sort(zones.begin(), zones.end());
+
+    for (unsigned int z = 0; z < zones.size(); z++)
+      {
+        std::string zone = root + "/" + zones[z] + "/";
+        char buf[64];
+        Domain d;
+
+        if (FileTools::sysfsReadFile((zone + "name").c_str(), buf,
+            sizeof(buf)) == 0)
+          continue;
+        d.name = buf;
+        if (!d.name.empty() && (d.name[d.name.size() - 1] == '\n'))
+          d.name.erase(d.name.size() - 1);
+
+        if (d.name.compare(0, 8, "package-") == 0)
+          d.type = Package;
+        else if (d.name == "core")
+          d.type = Core;
+        else if (d.name == "uncore")
+          d.type = Uncore;
+        else if (d.name == "dram")
+          d.type = Dram;
+        else if (d.name == "psys")
+          d.type = Psys;
+        else
+          d.type = Other;
+
+        d.pkg = (d.type == Psys) ? -1 : atoi(zones[z].c_str() + 11);
+
+        d.maxRange = 0;
+        if (FileTools::sysfsReadFile((zone + "max_energy_range_uj").c_str(),
+            buf, sizeof(buf)) != 0)
+          d.maxRange = strtoull(buf, NULL, 10);
+
+        d.fd = open((zone + "energy_uj").c_str(), O_RDONLY);
+        if ((d.fd < 0) || !readCounter(d.fd, d.raw))
+          {
+            DebugLog::writeMsg(DebugLog::WARNING, "RaplPowerMeter::init()",
+                "The energy counter of '%s' could not be read (%s)",
+                d.name.c_str(), zone.c_str());
+            if (d.fd >= 0)
+              close(d.fd);
+            continue;
+          }
+
+        d.energy = 0;
+        d.power = 0.0f;
+        _domains.push_back(d);
+      }
+
+    return !_domains.empty();
+  }
+
+  void
+  RaplPowerMeter::update()
+  {
+    struct timespec ts;
+    double elapsed;
+    bool hasPkg = false, dropped = false;
+    float value = 0.0f, psys = 0.0f;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    elapsed = (ts.tv_sec - _cTs.tv_sec) + (ts.tv_nsec - _cTs.tv_nsec) * 1e-9;
+
+    for (unsigned int i = 0; i < _domains.size(); i++)
+      {
+        Domain &d = _domains[i];
+        u64 raw, delta;
+
+        if (!readCounter(d.fd, raw))
+          continue;
+
+        // the counter restarts from 0 after max_energy_range_uj, the
+        // interval is dropped when the range is unknown
+        if (raw >= d.raw)
+          delta = raw - d.raw;
+        else if (d.maxRange > 0)
+          delta = d.maxRange - d.raw + raw;
+        else
+          {
+            d.raw = raw;
+            dropped = true;
+            continue;
+          }
+        d.raw = raw;
+
+        // the first update only starts the period
+        if (!_started)
+          continue;
+
+        d.energy += delta;
+        d.power = (elapsed > 0) ? (float) (delta * 1e-6 / elapsed) : 0.0f;
+
+        if ((d.type == Package) || (d.type == Dram))
+          value += d.power;
+        hasPkg |= (d.type == Package);
+        if (d.type == Psys)
+          psys += d.power;
+      }
+
+    _cTs = ts;
+    _started = true;
+
+    // no value is published for a dropped interval
+    if (dropped)
+      return;
+
+    _pTime = _cTime;
+    _cTime = time(NULL);
+    _cValue.Float = hasPkg ? value : value + psys;
+  }
+
+  sensor_t
+  RaplPowerMeter::getValue()
+  {
+    return _cValue;
+  }
+
+  double
+  RaplPowerMeter::getEnergy()
+  {
+    u64 energy = 0, psys = 0;
+    bool hasPkg = false;
+
+    for (unsigned int i = 0; i < _domains.size(); i++)
+      {
+        if ((_domains[i].type == Package) || (_domains[i].type == Dram))
+          energy += _domains[i].energy;
+        hasPkg |= (_domains[i].type == Package);
+        if (_domains[i].type == Psys)
+          psys += _domains[i].energy;
+      }
+
+    return (hasPkg ? energy : energy + psys) * 1e-6;
+  }
+
+  unsigned int
+  RaplPowerMeter::getDomainCount()
+  {
+    return _domains.size();
+  }
+
+  std::string
+  RaplPowerMeter::getDomainName(unsigned int domain)
+  {
+    return (domain < _domains.size()) ? _domains[domain].name : "";
+  }
+
+  RaplPowerMeter::DomainType
+  RaplPowerMeter::getDomainType(unsigned int domain)
+  {
+    return (domain < _domains.size()) ? _domains[domain].type : Other;
+  }
+
+  int
+  RaplPowerMeter::getDomainPackage(unsigned int domain)
+  {
+    return (domain < _domains.size()) ? _domains[domain].pkg : -1;
+  }
+
+  float
+  RaplPowerMeter::getDomainPower(unsigned int domain)
+  {
+    return (domain < _domains.size()) ? _domains[domain].power : 0.0f;
+  }
+
+  double
+  RaplPowerMeter::getDomainEnergy(unsigned int domain)
+  {
+    return (domain < _domains.size()) ? _domains[domain].energy * 1e-6 : 0.0;
+  }
+
+  const char*
+  RaplPowerMeter::getClassName()
+  {
+    return ClassName;
+  }
+
+}
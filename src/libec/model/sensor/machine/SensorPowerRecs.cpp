@@ -1,14 +1,6 @@
 #include <iostream>
 #include <fstream>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <unistd.h>
-#include <string.h>
-#include <sys/types.h>
-#include <netinet/in.h>
-
-#include <sys/socket.h>
-#include <netdb.h>
+#include <sstream>
 #include <string.h>
 
 #include <libec/sensor/SensorPowerRecs.h>
@@ -16,6 +8,7 @@
 #include <libec/tools/XMLReader.h>
 #include <libec/tools/DebugLog.h>
 
+#define LG_MAX_IP 15
 #define NB_MAX_NODES 18
 
 namespace cea
@@ -23,15 +16,12 @@ namespace cea
   const char* RecsPowerMeter::ClassName = "RecsPowerMeter";
   static const char *COM_ASK = "4x";
 
-  // Public methods
-  RecsPowerMeter::RecsPowerMeter(const char* servIp, int servPort, int nodeId)
-  {
-    _name = "RECS_POWER_METER";
-    _alias = "PM_RECS" + Tools::CStr(nodeId);
-    _nodeId = nodeId;
-    strcpy(_servIp, servIp);
-    _servPort = servPort;
+  std::map<std::string, RecsSession*> RecsSession::_sessions;
 
+  // RecsSession
+  RecsSession::RecsSession(const std::string &ip, int port) :
+      _tcp(ip, port, 100), _users(0), _seq(0), _nrBaseboards(0), _voltage(0)
+  {
     for (int i = 0; i < NB_MAX_NODES; i++)
       {
         _nodes[i].has_board = false;
@@ -39,144 +29,226 @@ namespace cea
         _nodes[i].status = false;
         _nodes[i].temp = 0;
       }
-
-    _cValue.Float = 0.0;
-    _pValue.Float = 0.0;
-    _type = Float;
-    _isActive = openConnection();
-    closeConnection();
   }
 
-  RecsPowerMeter::RecsPowerMeter(const std::string &xmlTag) :
-      PowerMeter(xmlTag)
+  RecsSession*
+  RecsSession::acquire(const std::string &ip, int port)
   {
-    setParamsXml(xmlTag.c_str());
+    std::string key = ip + ":" + Tools::CStr(port);
+    std::map<std::string, RecsSession*>::iterator it = _sessions.find(key);
+    RecsSession* session;
 
-    _cValue.Float = 0.0;
-    _pValue.Float = 0.0;
-    _type = Float;
-    _isActive = openConnection();
-    closeConnection();
+    if (it == _sessions.end())
+      {
+        session = new RecsSession(ip, port);
+        _sessions[key] = session;
+      }
+    else
+      session = it->second;
+
+    session->_users++;
+    return session;
   }
 
-  RecsPowerMeter::~RecsPowerMeter()
+  void
+  RecsSession::release(RecsSession* session)
   {
-    close(_sockFd);
+    if ((session == NULL) || (--session->_users > 0))
+      return;
+
+    std::map<std::string, RecsSession*>::iterator it;
+    for (it = _sessions.begin(); it != _sessions.end(); it++)
+      if (it->second == session)
+        {
+          _sessions.erase(it);
+          break;
+        }
+    delete session;
   }
 
-  void
-  RecsPowerMeter::update()
+  bool
+  RecsSession::poll()
   {
     char buffer[1024];
-    int n;
+    size_t end;
+    ssize_t n;
+
+    _seq++;
+
+    // the end of the previous answer may have come late
+    end = _in.find_first_not_of('x');
+    _in.erase(0, (end == std::string::npos) ? _in.size() : end);
 
-    if (openConnection())
+    if (_tcp.open() && _tcp.send(COM_ASK, strlen(COM_ASK)))
       {
-        n = write(_sockFd, COM_ASK, strlen(COM_ASK));
-        if (n < 0)
+        while ((end = _in.find("xxx")) == std::string::npos)
           {
-            _isActive = false; // error: writing to socket
-            closeConnection();
-            return;
+            n = _tcp.recv(buffer, sizeof(buffer));
+            if (n <= 0)
+              break;
+            _in.append(buffer, n);
           }
+      }
 
-        char* dest = buffer;
-        while (true)
+    if (end == std::string::npos)
+      {
+        // error: the connection is closed, the next poll opens a new one,
+        // and the powers of the last answer are not read as current ones
+        _tcp.close();
+        _in.clear();
+        _nrBaseboards = 0;
+        for (int i = 0; i < NB_MAX_NODES; i++)
           {
-            n = read(_sockFd, dest, 1024);
-            if (n < 0)
-              {
-                // error: reading from socket
-                closeConnection();
-                return;
-              }
-            dest[n] = '\0';
-            if (strstr(buffer, "xxx"))
-              break;
-            dest = dest + n;
+            _nodes[i].status = false;
+            _nodes[i].power = -1;
           }
-        closeConnection();
+        return false;
+      }
 
-        std::istringstream in(buffer);
+    end = _in.find_first_not_of('x', end);
+    if (end == std::string::npos)
+      end = _in.size();
+    std::string answer = _in.substr(0, end);
+    _in.erase(0, end);
 
-        char C;
-        in >> nr_baseboards >> C;
+    return parse(answer);
+  }
+
+  bool
+  RecsSession::parse(const std::string &answer)
+  {
+    std::istringstream in(answer);
+
+    char C;
+    _nrBaseboards = 0;
+    in >> _nrBaseboards >> C;
+    if (_nrBaseboards < 0)
+      _nrBaseboards = 0;
+    else if (_nrBaseboards > NB_MAX_NODES)
+      _nrBaseboards = NB_MAX_NODES;
 #if DEBUG
-        DebugLog::cout << "Number of baseboards: " << nr_baseboards << "\n";
+    DebugLog::cout << "Number of baseboards: " << _nrBaseboards << "\n";
 #endif
 
-        for (int i = 0; i < nr_baseboards; i++)
-          {
-            in >> _nodes[i].has_board >> C >> _nodes[i].status >> C
-                >> _nodes[i].temp >> C >> _nodes[i].power >> C;
+    for (int i = 0; i < _nrBaseboards; i++)
+      {
+        in >> _nodes[i].has_board >> C >> _nodes[i].status >> C
+            >> _nodes[i].temp >> C >> _nodes[i].power >> C;
 
 #if DEBUG
-            DebugLog::cout << "Baseboard " << i + 1 << DebugLog::endl;
-            DebugLog::cout << "  Baseboard present: "
-                << ((_nodes[i].has_board) ? "yes" : "no") << DebugLog::endl;
-            DebugLog::cout << "  Status: "
-                << ((_nodes[i].status) ? "on" : "off") << DebugLog::endl;
-            DebugLog::cout << "  Temperature: " << _nodes[i].temp
-                << DebugLog::endl;
-            DebugLog::cout << "  Power: " << _nodes[i].power << DebugLog::endl;
+        DebugLog::cout << "Baseboard " << i + 1 << DebugLog::endl;
+        DebugLog::cout << "  Baseboard present: "
+            << ((_nodes[i].has_board) ? "yes" : "no") << DebugLog::endl;
+        DebugLog::cout << "  Status: "
+            << ((_nodes[i].status) ? "on" : "off") << DebugLog::endl;
+        DebugLog::cout << "  Temperature: " << _nodes[i].temp
+            << DebugLog::endl;
+        DebugLog::cout << "  Power: " << _nodes[i].power << DebugLog::endl;
 #endif
-          }
+      }
 
-        // Total RECS2(r) voltage
-        char Reste[128];
-        in >> global_voltage >> Reste;
-        if (!strcmp(Reste, "xxxx"))
-          return;
+    // Total RECS2(r) voltage
+    std::string reste;
+    in >> _voltage >> reste;
+    if (reste != "xxxx")
+      _voltage = _voltage / 16.45; // Correcting the voltage-factor
 
-        //sscanf(buffer, "%fxxx", &global_voltage);
-        global_voltage = global_voltage / 16.45; // Correcting the voltage-factor
-        //global_voltage = round(global_voltage, 2);
-        //printf("Global voltage: %f\n", global_voltage);
+    return (_nrBaseboards > 0);
+  }
 
-        //printf("\n%s\n", buffer);
-      }
+  unsigned int
+  RecsSession::getSeq() const
+  {
+    return _seq;
   }
 
-  bool
-  RecsPowerMeter::openConnection()
+  const RecsSession::node&
+  RecsSession::getNode(int nodeId) const
+  {
+    if ((nodeId < 0) || (nodeId >= NB_MAX_NODES))
+      nodeId = 0;
+    return _nodes[nodeId];
+  }
+
+  short
+  RecsSession::getBaseboardCount() const
+  {
+    return _nrBaseboards;
+  }
+
+  float
+  RecsSession::getVoltage() const
+  {
+    return _voltage;
+  }
+
+  unsigned int
+  RecsSession::getConnectCount() const
+  {
+    return _tcp.getConnectCount();
+  }
+
+  unsigned int
+  RecsSession::getSessionCount()
+  {
+    return _sessions.size();
+  }
+
+  // Public methods
+  RecsPowerMeter::RecsPowerMeter(const char* servIp, int servPort, int nodeId)
   {
-    _sockFd = socket(AF_INET, SOCK_STREAM, 0);
-    if (_sockFd < 0) // error: opening socket
-      return false;
+    _name = "RECS_POWER_METER";
+    _alias = "PM_RECS" + Tools::CStr(nodeId);
+    _nodeId = nodeId;
+    strncpy(_servIp, servIp, LG_MAX_IP);
+    _servIp[LG_MAX_IP] = '\0';
+    _servPort = servPort;
 
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 100000;
-    if (setsockopt(_sockFd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0)
-      return false; // error: could not set timeout value
+    init();
+  }
 
-    _server = gethostbyname(_servIp);
-    if (_server == NULL) // error: no such host
-      return false;
+  RecsPowerMeter::RecsPowerMeter(const std::string &xmlTag) :
+      PowerMeter(xmlTag)
+  {
+    setParamsXml(xmlTag.c_str());
+
+    init();
+  }
 
-    bzero((char *) &_servAddr, sizeof(_servAddr));
-    _servAddr.sin_family = AF_INET;
-    bcopy((char *) _server->h_addr, (char *)&_servAddr.sin_addr.s_addr, _server->h_length);
-    _servAddr.sin_port = htons(_servPort);
+  RecsPowerMeter::~RecsPowerMeter()
+  {
+    RecsSession::release(_session);
+  }
 
-    if (connect(_sockFd, (struct sockaddr *) &_servAddr, sizeof(_servAddr)) < 0)
-      return false; // error: connecting
+  void
+  RecsPowerMeter::init()
+  {
+    _cValue.Float = 0.0;
+    _pValue.Float = 0.0;
+    _type = Float;
 
-    return true;
+    _session = RecsSession::acquire(_servIp, _servPort);
+    // a new meter reads the last answer, unless there is none yet
+    _seq = (_session->getSeq() > 0) ? _session->getSeq() - 1 : 0;
+    update();
+    _isActive = (_session->getBaseboardCount() > 0);
   }
 
-  bool
-  RecsPowerMeter::closeConnection()
+  void
+  RecsPowerMeter::update()
   {
-    close(_sockFd);
+    // the first meter updated in a tick polls the controller for all nodes
+    if (_seq == _session->getSeq())
+      _session->poll();
+    _seq = _session->getSeq();
 
-    return true;
+    _pValue = _cValue;
+    _cValue.Float = _session->getNode(_nodeId).power;
   }
 
   sensor_t
   RecsPowerMeter::getValue()
   {
-    _cValue.Float = _nodes[_nodeId].power;
     return _cValue;
   }
 
@@ -184,9 +256,9 @@ namespace cea
   RecsPowerMeter::getValue(int nodeId, int typeId)
   {
     if (typeId == 0)
-      return _nodes[nodeId].power;
+      return _session->getNode(nodeId).power;
     else
-      return _nodes[nodeId].temp;
+      return _session->getNode(nodeId).temp;
   }
 
   inline const char*
@@ -216,4 +288,5 @@ namespace cea
 
 }
 
+#undef LG_MAX_IP
 #undef NB_MAX_NODES
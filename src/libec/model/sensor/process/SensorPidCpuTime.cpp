@@ -9,11 +9,12 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <fstream>
 
 #include <libec/sensor/SensorPid.h>
 #include <libec/sensor/SensorPidCpuTime.h>
 #include <libec/tools/DebugLog.h>
+#include <libec/device/ProcStat.h>
+#include <libec/process/linux/ProcessSampleCache.h>
 
 #if DEBUG
 #include <libec/tools/Debug.h>
@@ -61,26 +62,7 @@ namespace cea
   char
   CpuTime::checkCpus()
   {
-    std::ifstream ifs("/proc/stat");
-    std::string s;
-    char cpus = -1;
-    unsigned found = 0;
-
-    if (ifs.good())
-      {
-        std::getline(ifs, s);
-
-        do
-          {
-            cpus++;
-            std::getline(ifs, s);
-            found = s.find("cpu");
-          }
-        while (found == 0);
-      }
-    ifs.close();
-
-    return cpus;
+    return ProcStat::getCpuCount();
   }
 
   const char*
@@ -114,18 +96,15 @@ namespace cea
   void
   CpuTime::update()
   {
-    unsigned long int tuser, tsys, tnice, tidle;
-    std::ifstream ifs("/proc/stat");
+    ProcStat::Jiffies jiffies;
 
-    if (ifs.good())
+    // /proc/stat is shared by all the sensors of the tick
+    if (ProcStat::getCpu(_cpuId, jiffies))
       {
-        ifs.ignore(8, ' '); //"cpu"
-        ifs >> tuser >> tnice >> tsys >> tidle;
-
-        _cValue.U64 = tuser + tsys;
-        _cIdleTime = tidle;
+        _cValue.U64 = jiffies.field[ProcStat::USER]
+            + jiffies.field[ProcStat::SYSTEM];
+        _cIdleTime = jiffies.field[ProcStat::IDLE];
       }
-    ifs.close();
   }
 
   sensor_t
@@ -149,29 +128,15 @@ namespace cea
 
     if (pid > 0)
       {
-        static char path[32];
-        sprintf(path, "/proc/%d/stat", pid);
-        std::ifstream ifs(path);
-        if (ifs.good())
+        // proc/[pid]/stat is shared by all the sensors of the tick
+        const ProcessStat::Snapshot* stat = ProcessSampleCache::getStat(pid);
+        if (stat != NULL)
           {
-            ifs.ignore(64, ' '); //pid
-            ifs.ignore(256, ' '); //comm
-            ifs.ignore(64, ' '); //state
-            ifs.ignore(64, ' '); //ppid
-            ifs.ignore(64, ' '); //pgrp
-            ifs.ignore(64, ' '); //session
-            ifs.ignore(64, ' '); //tty_nr
-            ifs.ignore(64, ' '); //tpgid
-            ifs.ignore(64, ' '); //flags
-            ifs.ignore(64, ' '); //minflt
-            ifs.ignore(64, ' '); //cminflt
-            ifs.ignore(64, ' '); //majflt
-            ifs.ignore(64, ' '); //cmajflt
-            ifs >> tuser >> tsys;
+            ProcessStat::get(*stat, ProcessStat::UTIME, tuser);
+            ProcessStat::get(*stat, ProcessStat::STIME, tsys);
 //            _cvPIDMap[pid].U64 = tuser + tsys;
             _cpValue = tuser + tsys;
           }
-        ifs.close();
       }
     else
       {
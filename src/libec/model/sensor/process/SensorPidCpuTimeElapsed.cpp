@@ -32,6 +32,8 @@ namespace cea
 
     _isActive = _ct.getStatus();
 
+    registerState(sizeof(PidState));
+
     gettimeofday(&_cTimeval, NULL);
 
     update();
@@ -91,9 +93,10 @@ namespace cea
 
     if (pid > 0)
       {
-        _pvPIDMap[pid].U64 = _cvPIDMap[pid].U64;
+        PidState* st = getState<PidState>(pid);
+        st->prev.U64 = st->cur.U64;
         _ct.updatePid(pid);
-        _cvPIDMap[pid].U64 = _ct.getValuePid(pid).U64;
+        st->cur.U64 = _ct.getValuePid(pid).U64;
       }
     else
       {
@@ -179,12 +182,10 @@ namespace cea
   void
   CpuElapsedTime::add(pid_t pid)
   {
-    sensor_t cval, pval;
-    _cvPIDMap.insert(std::pair<pid_t, sensor_t>(pid, cval));
-    _pvPIDMap.insert(std::pair<pid_t, sensor_t>(pid, pval));
-
     updatePid(pid);
-    _pvPIDMap[pid].U64 = _cvPIDMap[pid].U64;
+
+    PidState* st = getState<PidState>(pid);
+    st->prev.U64 = st->cur.U64;
   }
 
   sensor_t
@@ -192,7 +193,8 @@ namespace cea
   {
     sensor_t val;
 
-    val.U64 = _cvPIDMap[pid].U64 - _pvPIDMap[pid].U64;
+    PidState* st = getState<PidState>(pid);
+    val.U64 = st->cur.U64 - st->prev.U64;
 
     return val;
   }
@@ -39,18 +39,6 @@ namespace cea
     _cValue.Float = ((float) _cet.getValue().U64 / _cet.getTotalElapsedTime());
   }
 
-  void
-  CpuTimeUsage::add(pid_t pid)
-  {
-    sensor_t cval, pval;
-    _cvPIDMap.insert(std::pair<pid_t, sensor_t>(pid, cval));
-    _pvPIDMap.insert(std::pair<pid_t, sensor_t>(pid, pval));
-
-    struct timeval ctime, ptime;
-    _ctimePIDMap.insert(std::pair<pid_t, struct timeval>(pid, ctime));
-    _ptimePIDMap.insert(std::pair<pid_t, struct timeval>(pid, ptime));
-  }
-
   long long c, p;
 
   sensor_t
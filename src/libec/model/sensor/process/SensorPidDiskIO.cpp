@@ -3,15 +3,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include <fstream>
 
 #include <libec/sensor/SensorPid.h>
 #include <libec/sensor/SensorPidDiskIO.h>
 #include <libec/tools/DebugLog.h>
-
-#define IO_READ    "read_bytes:"
-#define IO_WRITE   "write_bytes:"
-#define IO_CWRITE  "cancelled_write_bytes:"
+#include <libec/process/linux/ProcessSampleCache.h>
 
 namespace cea
 {
@@ -35,8 +31,9 @@ namespace cea
       DebugLog::writeMsg(DebugLog::WARNING, "DiskIO::DiskIO()",
           "The sensor is not active. Check /proc/[pid]/io file permissions.");
 
-    sprintf(_macPath, "/sys/block/%s/stat", dev);
-    _isActive &= (access(_macPath, R_OK) == 0);
+    _isActive &= _macStat.open(std::string("/sys/block/") + dev + "/stat");
+
+    registerState(sizeof(iodata));
   }
 
   DiskIO::~DiskIO()
@@ -46,30 +43,30 @@ namespace cea
   void
   DiskIO::add(pid_t pid)
   {
-    iodata data =
-      { 0, 0 };
-    _pidValue.insert(std::pair<pid_t, iodata>(pid, data));
+    getState<iodata>(pid);
   }
 
   void
   DiskIO::remove(pid_t pid)
   {
-    _pidValue.erase(pid);
+    PIDSensor::remove(pid);
   }
 
   void
   DiskIO::update()
   {
-    std::ifstream ifs(_macPath);
-    if (ifs.good())
+    u64 field[5];
+
+    // Field 1: # of reads completed
+    // Field 2: # of reads merged
+    // Field 3: # of sectors read
+    // Field 4: # of milliseconds spent reading
+    // Field 5: # of writes completed
+    if (_macStat.readU64s(field, 5) == 5)
       {
-        ifs >> _macValue.read; // Field  1: # of reads completed
-        ifs.ignore(' ', 254); // Filed 2: # of reads merged
-        ifs.ignore(' ', 254); // Filed 3: # of sectors read
-        ifs.ignore(' ', 254); // Field 4: # of milliseconds spent reading
-        ifs >> _macValue.write; //Field 5: # of writes completed
+        _macValue.read = field[0];
+        _macValue.write = field[4];
       }
-    ifs.close();
   }
 
   void
@@ -77,31 +74,14 @@ namespace cea
   {
     if (pid > 0)
       {
-        char buff[2048];
-        sprintf(buff, "/proc/%d/io", pid);
-        std::ifstream ifs(buff);
-        if (ifs.good())
+        // proc/[pid]/io is shared by all the sensors of the tick
+        const ProcessSampleCache::Io* io = ProcessSampleCache::getIo(pid);
+        if (io != NULL)
           {
-            while (ifs.good())
-              {
-                ifs.getline(buff, sizeof buff);
-                if (memcmp(buff, IO_READ, sizeof IO_READ - 1) == 0)
-                  {
-                    sscanf(buff, "%*s %llu", &_pidValue[pid].read);
-                    continue;
-                  }
-                if (memcmp(buff, IO_WRITE, sizeof IO_READ - 1) == 0)
-                  {
-                    sscanf(buff, "%*s %llu", &_pidValue[pid].write);
-                    continue;
-                  }
-//            if (memcmp(buff, IO_CWRITE, sizeof IO_READ - 1) == 0)
-//              {
-//                sscanf(buff, "%*s %llu", &_pidValue[pid].cwrite);
-//                continue;
-//              }
-              }
-            ifs.close();
+            iodata* data = getState<iodata>(pid);
+            data->read = io->readBytes;
+            data->write = io->writeBytes;
+//            data->cwrite = io->cancelledWriteBytes;
           }
         else
           {
@@ -135,7 +115,7 @@ namespace cea
   u64
   DiskIO::getReadBytes(pid_t pid)
   {
-    return _pidValue[pid].read;
+    return getState<iodata>(pid)->read;
   }
 
   u64
@@ -147,7 +127,7 @@ namespace cea
   u64
   DiskIO::getWriteBytes(pid_t pid)
   {
-    return _pidValue[pid].write;
+    return getState<iodata>(pid)->write;
   }
 
 //  u64
@@ -2,12 +2,12 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <fstream>
 
 #include <libec/sensor/SensorPid.h>
 #include <libec/sensor/SensorPidMemRss.h>
 #include <libec/tools/DebugLog.h>
 #include <libec/tools/Tools.h>
+#include <libec/process/linux/ProcessSampleCache.h>
 
 #if DEBUG
 #include <libec/tools/Debug.h>
@@ -27,7 +27,11 @@ namespace cea
 
     getPageSize();
 
+    // resident set size (in pages) of each process
+    registerState(sizeof(u64));
+
     _isActive = (access("/proc/stat", R_OK) == 0);
+    _isActive &= _meminfo.open("/proc/meminfo");
   }
 
   MemRss::~MemRss()
@@ -49,16 +53,12 @@ namespace cea
   void
   MemRss::update()
   {
-    u64 _memTotal, _memUsed, _memFree, _memShared, _memBuffers, _memCached;
-
-    std::stringstream ss;
-    ss << cea::Tools::exec("free -k");
-    ss.ignore(256, '\n');
-    ss.ignore(256, ' '); // ignore until space
-    ss >> _memTotal >> _memUsed >> _memFree >> _memShared >> _memBuffers
-        >> _memCached;
+    static const char* keys[] =
+      { "MemTotal", "MemFree", "Buffers", "Cached" };
+    u64 kb[4];
 
-    _cValue.U64 = (_memUsed - _memBuffers - _memCached);
+    if (_meminfo.readKeys(keys, kb, 4) == 4)
+      _cValue.U64 = kb[0] - kb[1] - kb[2] - kb[3];
   }
 
   sensor_t
@@ -66,7 +66,7 @@ namespace cea
   {
     sensor_t val;
 
-    val.U64 = _memPid[pid];
+    val.U64 = *getState<u64>(pid);
 
     return val;
   }
@@ -78,15 +78,10 @@ namespace cea
     Debug::StartClock();
 #endif
 
-    char buff[32];
-
-    sprintf(buff, "/proc/%d/statm", pid);
-    std::ifstream ifs(buff);
-    if (ifs.good())
-      {
-        ifs.ignore(256, ' '); // ignore until space
-        ifs >> _memPid[pid];
-      }
+    // proc/[pid]/statm is shared by all the sensors of the tick
+    const ProcessSampleCache::Statm* statm = ProcessSampleCache::getStatm(pid);
+    if (statm != NULL)
+      *getState<u64>(pid) = statm->resident;
 
 #if DEBUG
     DebugLog::cout << _name << "  update time (us): "
@@ -2,7 +2,6 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <fstream>
 
 #include <libec/sensor/SensorPidMemUsage.h>
 #include <libec/tools/DebugLog.h>
@@ -27,7 +26,7 @@ namespace cea
     _memTotal = getAvailableMemory();
 
     _isActive = _rss.getStatus();
-    _isActive &= (access("/proc/meminfo", R_OK) == 0);
+    _isActive &= (_memTotal > 0);
   }
 
   MemUsage::~MemUsage()
@@ -82,15 +81,10 @@ namespace cea
   u64
   MemUsage::getAvailableMemory()
   {
-    u64 val;
-
-    std::ifstream ifs("/proc/meminfo");
-    if (ifs.good())
-      {
-        ifs.ignore(256, ' '); // ignore until space
-        ifs >> val;
-      }
-    ifs.close();
+    u64 val = 0;
+
+    KernelAttr meminfo("/proc/meminfo");
+    meminfo.readKey("MemTotal", val);
 
     return val;
   }
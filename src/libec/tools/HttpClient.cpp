@@ -0,0 +1,167 @@
+#include <libec/tools/HttpClient.h>
+#include <libec/tools/DebugLog.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace cea
+{
+  HttpClient::HttpClient(const std::string &host, int port,
+      unsigned int timeout) :
+      _tcp(host, port, timeout)
+  {
+  }
+
+  bool
+  HttpClient::get(const std::string &path, std::string &body, int* status)
+  {
+    std::string req = "GET " + path + " HTTP/1.1\r\nHost: " + _tcp.getHost()
+        + "\r\nConnection: keep-alive\r\n\r\n";
+    bool reused = _tcp.isOpen();
+
+    if (request(req, body, status))
+      return true;
+
+    // the server may have closed the idle connection, try a new one
+    if (reused)
+      return request(req, body, status);
+
+    return false;
+  }
+
+  unsigned int
+  HttpClient::getConnectCount() const
+  {
+    return _tcp.getConnectCount();
+  }
+
+  bool
+  HttpClient::request(const std::string &req, std::string &body, int* status)
+  {
+    std::string line;
+    long length = -1;
+    bool chunked = false, keepAlive = true;
+
+    _in.clear();
+    body.clear();
+
+    if (!_tcp.open() || !_tcp.send(req.data(), req.size()))
+      return false;
+
+    // status line: HTTP/1.1 200 OK
+    if (!readLine(line) || (line.compare(0, 5, "HTTP/") != 0))
+      {
+        _tcp.close();
+        return false;
+      }
+    if (status != NULL)
+      {
+        size_t sp = line.find(' ');
+        *status = (sp != std::string::npos) ? atoi(line.c_str() + sp + 1) : 0;
+      }
+    keepAlive = (line.compare(0, 8, "HTTP/1.0") != 0);
+
+    // headers
+    while (readLine(line) && !line.empty())
+      {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+          continue;
+
+        std::string name = line.substr(0, colon);
+        const char* value = line.c_str() + colon + 1;
+        while (*value == ' ')
+          value++;
+
+        if (strcasecmp(name.c_str(), "Content-Length") == 0)
+          length = atol(value);
+        else if ((strcasecmp(name.c_str(), "Transfer-Encoding") == 0)
+            && (strcasecmp(value, "chunked") == 0))
+          chunked = true;
+        else if (strcasecmp(name.c_str(), "Connection") == 0)
+          keepAlive = (strcasecmp(value, "close") != 0);
+      }
+
+    // body
+    bool ok = true;
+    if (chunked)
+      {
+        for (;;)
+          {
+            if (!readLine(line))
+              {
+                ok = false;
+                break;
+              }
+            long size = strtol(line.c_str(), NULL, 16);
+            if (size <= 0)
+              {
+                // trailer
+                while (readLine(line) && !line.empty())
+                  ;
+                break;
+              }
+            if (!readBytes(size, body) || !readLine(line))
+              {
+                ok = false;
+                break;
+              }
+          }
+      }
+    else if (length >= 0)
+      ok = readBytes(length, body);
+    else
+      {
+        // the body ends with the connection
+        while (fill())
+          ;
+        body.swap(_in);
+        keepAlive = false;
+      }
+
+    if (!ok || !keepAlive)
+      _tcp.close();
+
+    return ok;
+  }
+
+  bool
+  HttpClient::fill()
+  {
+    char buf[4096];
+
+    ssize_t n = _tcp.recv(buf, sizeof(buf));
+    if (n <= 0)
+      return false;
+
+    _in.append(buf, n);
+    return true;
+  }
+
+  bool
+  HttpClient::readLine(std::string &line)
+  {
+    size_t eol;
+
+    while ((eol = _in.find("\r\n")) == std::string::npos)
+      if (!fill())
+        return false;
+
+    line = _in.substr(0, eol);
+    _in.erase(0, eol + 2);
+    return true;
+  }
+
+  bool
+  HttpClient::readBytes(size_t len, std::string &out)
+  {
+    while (_in.size() < len)
+      if (!fill())
+        return false;
+
+    out.append(_in, 0, len);
+    _in.erase(0, len);
+    return true;
+  }
+}
@@ -0,0 +1,132 @@
+#include <libec/tools/SamplingClock.h>
+
+#include <ctime>
+#include <cerrno>
+
+namespace cea
+{
+  SamplingClock::SamplingClock(u64 period) :
+      _period((period > 0) ? period : 1), _deadline(0), _ticks(0), _missed(0)
+  {
+  }
+
+  void
+  SamplingClock::setPeriod(u64 period)
+  {
+    _period = (period > 0) ? period : 1;
+
+    // a shorter period does not wait for the deadline of the longer one
+    if (_deadline != 0)
+      {
+        u64 deadline = now() + _period;
+        if (deadline < _deadline)
+          _deadline = deadline;
+      }
+  }
+
+  u64
+  SamplingClock::getPeriod() const
+  {
+    return _period;
+  }
+
+  void
+  SamplingClock::start()
+  {
+    startAt(now() + _period);
+  }
+
+  void
+  SamplingClock::startAt(u64 first)
+  {
+    _deadline = first;
+    _ticks = 0;
+    _missed = 0;
+  }
+
+  u64
+  SamplingClock::wait()
+  {
+    struct timespec ts;
+
+    if (_deadline == 0)
+      start();
+
+    ts.tv_sec = _deadline / 1000000000ull;
+    ts.tv_nsec = _deadline % 1000000000ull;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+      ;
+
+    u64 deadline = _deadline;
+    next(now());
+    return deadline;
+  }
+
+  bool
+  SamplingClock::isDue() const
+  {
+    return (_deadline == 0) || (now() >= _deadline);
+  }
+
+  bool
+  SamplingClock::advance()
+  {
+    u64 time = now();
+
+    // the first call starts the ticks
+    if (_deadline == 0)
+      {
+        _deadline = time + _period;
+        _ticks++;
+        return true;
+      }
+
+    if (time < _deadline)
+      return false;
+
+    next(time);
+    return true;
+  }
+
+  void
+  SamplingClock::next(u64 time)
+  {
+    _ticks++;
+    _deadline += _period;
+
+    // a tick late by more than a period skips the deadlines passed
+    if (time >= _deadline)
+      {
+        u64 skipped = (time - _deadline) / _period + 1;
+        _missed += skipped;
+        _deadline += skipped * _period;
+      }
+  }
+
+  u64
+  SamplingClock::getDeadline() const
+  {
+    return _deadline;
+  }
+
+  u64
+  SamplingClock::getTicks() const
+  {
+    return _ticks;
+  }
+
+  u64
+  SamplingClock::getMissed() const
+  {
+    return _missed;
+  }
+
+  u64
+  SamplingClock::now()
+  {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) (ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+  }
+}
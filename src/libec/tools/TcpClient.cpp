@@ -0,0 +1,150 @@
+#include <libec/tools/TcpClient.h>
+#include <libec/tools/DebugLog.h>
+
+#include <cstdio>
+#include <cstring>
+#include <errno.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace cea
+{
+  TcpClient::TcpClient(const std::string &host, int port, unsigned int timeout) :
+      _host(host), _port(port), _timeout(timeout), _fd(-1), _connects(0)
+  {
+  }
+
+  TcpClient::~TcpClient()
+  {
+    close();
+  }
+
+  bool
+  TcpClient::open()
+  {
+    struct addrinfo hints, *res, *ai;
+    char port[16];
+
+    if (_fd >= 0)
+      return true;
+
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port, sizeof(port), "%d", _port);
+
+    if (getaddrinfo(_host.c_str(), port, &hints, &res) != 0)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "TcpClient::open()",
+            "Host '%s' could not be resolved", _host.c_str());
+        return false;
+      }
+
+    struct timeval tv;
+    tv.tv_sec = _timeout / 1000;
+    tv.tv_usec = (_timeout % 1000) * 1000;
+    int one = 1;
+
+    for (ai = res; (ai != NULL) && (_fd < 0); ai = ai->ai_next)
+      {
+        _fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (_fd < 0)
+          continue;
+
+        setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        // requests are small and answered at once
+        setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (connect(_fd, ai->ai_addr, ai->ai_addrlen) < 0)
+          {
+            ::close(_fd);
+            _fd = -1;
+          }
+      }
+    freeaddrinfo(res);
+
+    if (_fd < 0)
+      {
+        DebugLog::writeMsg(DebugLog::WARNING, "TcpClient::open()",
+            "Could not connect to %s:%d", _host.c_str(), _port);
+        return false;
+      }
+
+    _connects++;
+    return true;
+  }
+
+  void
+  TcpClient::close()
+  {
+    if (_fd >= 0)
+      ::close(_fd);
+    _fd = -1;
+  }
+
+  bool
+  TcpClient::isOpen() const
+  {
+    return (_fd >= 0);
+  }
+
+  bool
+  TcpClient::send(const char* buf, size_t len)
+  {
+    while ((len > 0) && (_fd >= 0))
+      {
+        ssize_t n = ::send(_fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0)
+          {
+            if (errno == EINTR)
+              continue;
+            close();
+            return false;
+          }
+        buf += n;
+        len -= n;
+      }
+
+    return (_fd >= 0);
+  }
+
+  ssize_t
+  TcpClient::recv(char* buf, size_t len)
+  {
+    if (_fd < 0)
+      return -1;
+
+    ssize_t n;
+    do
+      n = ::recv(_fd, buf, len, 0);
+    while ((n < 0) && (errno == EINTR));
+
+    if (n <= 0)
+      close();
+
+    return n;
+  }
+
+  const std::string&
+  TcpClient::getHost() const
+  {
+    return _host;
+  }
+
+  int
+  TcpClient::getPort() const
+  {
+    return _port;
+  }
+
+  unsigned int
+  TcpClient::getConnectCount() const
+  {
+    return _connects;
+  }
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include <libec/Globals.h>
 #include <libec/tools/Tools.h>
@@ -285,15 +286,14 @@ namespace cea
   Tools::tick()
   {
 #ifdef __unix__
-    struct timeval tv;
-    if (gettimeofday(&tv, NULL) != 0)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
       {
         return 0;
       }
     else
       {
-//        return (tv.tv_usec + 1000000 * tv.tv_sec) / 1000;
-        return (tv.tv_usec / 1000 + 1000 * tv.tv_sec);
+        return ((cea_time_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
       }
 #endif
 #ifdef _WIN32
@@ -0,0 +1,143 @@
+#include <libec/tools/containers/SampleRing.h>
+#include <libec/tools/SamplingClock.h>
+
+#include <ctime>
+
+namespace cea
+{
+
+  SampleRing::SampleRing(unsigned int width, unsigned int capacity) :
+      _width(width), _mask(0), _head(0), _tail(0), _pushed(0), _dropped(0),
+          _waits(0), _highWater(0)
+  {
+    // a power of 2, so that the free running indexes can be masked
+    unsigned int size = 1;
+    while (size < capacity)
+      size <<= 1;
+    _mask = size - 1;
+
+    _times.resize(size, 0.0);
+    _tags.resize(size, 0);
+    _values.resize(size * ((width > 0) ? width : 1));
+  }
+
+  bool
+  SampleRing::push(double time, const sensor_t* values, unsigned int tag,
+      u64 wait)
+  {
+    unsigned int head = _head;
+    unsigned int tail = _tail;
+
+    // back-pressure: wait for the consumer before dropping the record
+    if (head - tail > _mask)
+      {
+        if (wait > 0)
+          {
+            struct timespec ts;
+            ts.tv_sec = 0;
+            ts.tv_nsec = 100000;
+
+            _waits++;
+            u64 end = SamplingClock::now() + wait;
+            while ((head - tail > _mask) && (SamplingClock::now() < end))
+              {
+                nanosleep(&ts, NULL);
+                tail = _tail;
+              }
+          }
+
+        if (head - tail > _mask)
+          {
+            _dropped++;
+            return false;
+          }
+      }
+
+    // the consumer is done with the record before it is written again
+    __sync_synchronize();
+
+    unsigned int i = head & _mask;
+    _times[i] = time;
+    _tags[i] = tag;
+    for (unsigned int v = 0; v < _width; v++)
+      _values[i * _width + v] = values[v];
+
+    // the record is written before it is published
+    __sync_synchronize();
+    _head = head + 1;
+
+    _pushed++;
+    if (head + 1 - tail > _highWater)
+      _highWater = head + 1 - tail;
+
+    return true;
+  }
+
+  bool
+  SampleRing::pop(double &time, sensor_t* values, unsigned int &tag)
+  {
+    unsigned int tail = _tail;
+
+    if (_head == tail)
+      return false;
+
+    // the record is read after its publication
+    __sync_synchronize();
+
+    unsigned int i = tail & _mask;
+    time = _times[i];
+    tag = _tags[i];
+    for (unsigned int v = 0; v < _width; v++)
+      values[v] = _values[i * _width + v];
+
+    // the record is read before its room is given back
+    __sync_synchronize();
+    _tail = tail + 1;
+
+    return true;
+  }
+
+  unsigned int
+  SampleRing::size() const
+  {
+    unsigned int tail = _tail;
+    return _head - tail;
+  }
+
+  unsigned int
+  SampleRing::getCapacity() const
+  {
+    return _mask + 1;
+  }
+
+  unsigned int
+  SampleRing::getWidth() const
+  {
+    return _width;
+  }
+
+  u64
+  SampleRing::getPushed() const
+  {
+    return _pushed;
+  }
+
+  u64
+  SampleRing::getDropped() const
+  {
+    return _dropped;
+  }
+
+  u64
+  SampleRing::getWaits() const
+  {
+    return _waits;
+  }
+
+  unsigned int
+  SampleRing::getHighWater() const
+  {
+    return _highWater;
+  }
+
+}
@@ -0,0 +1,102 @@
+#include <libec/tools/containers/TimeSeriesRing.h>
+
+namespace cea
+{
+
+  TimeSeriesRing::TimeSeriesRing(unsigned int width, unsigned int capacity) :
+      _width(width), _capacity((capacity > 0) ? capacity : 1), _first(0),
+          _size(0), _times(_capacity, 0), _values(_capacity * width, 0.0)
+  {
+  }
+
+  void
+  TimeSeriesRing::push(u64 time, const double* values)
+  {
+    unsigned int i;
+
+    if (_size < _capacity)
+      i = index(_size++);
+    else
+      {
+        i = _first;
+        _first = (_first + 1) % _capacity;
+      }
+
+    _times[i] = time;
+    for (unsigned int v = 0; v < _width; v++)
+      _values[i * _width + v] = values[v];
+  }
+
+  bool
+  TimeSeriesRing::interpolate(u64 time, double* values) const
+  {
+    if ((_size == 0) || (time < getOldestTime()) || (time > getLatestTime()))
+      return false;
+
+    // binary search of the first row not before the time
+    unsigned int lo = 0, hi = _size - 1;
+    while (lo < hi)
+      {
+        unsigned int mid = (lo + hi) / 2;
+        if (_times[index(mid)] < time)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+
+    unsigned int next = index(lo);
+    if ((_times[next] == time) || (lo == 0))
+      {
+        for (unsigned int v = 0; v < _width; v++)
+          values[v] = _values[next * _width + v];
+        return true;
+      }
+
+    unsigned int prev = index(lo - 1);
+    double w = (double) (time - _times[prev])
+        / (double) (_times[next] - _times[prev]);
+    for (unsigned int v = 0; v < _width; v++)
+      values[v] = _values[prev * _width + v]
+          + w * (_values[next * _width + v] - _values[prev * _width + v]);
+
+    return true;
+  }
+
+  void
+  TimeSeriesRing::clear()
+  {
+    _first = 0;
+    _size = 0;
+  }
+
+  unsigned int
+  TimeSeriesRing::size() const
+  {
+    return _size;
+  }
+
+  unsigned int
+  TimeSeriesRing::getWidth() const
+  {
+    return _width;
+  }
+
+  u64
+  TimeSeriesRing::getOldestTime() const
+  {
+    return (_size > 0) ? _times[_first] : 0;
+  }
+
+  u64
+  TimeSeriesRing::getLatestTime() const
+  {
+    return (_size > 0) ? _times[index(_size - 1)] : 0;
+  }
+
+  unsigned int
+  TimeSeriesRing::index(unsigned int row) const
+  {
+    return (_first + row) % _capacity;
+  }
+
+}
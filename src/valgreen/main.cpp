@@ -165,14 +165,16 @@ main(int argc, char *argv[])
             "ok");
         int status;
         pid_t tpid;
-        double power;
         double energy;
         unsigned int period = 200; //milliseconds
 
-        energy = 0;
+        // integrated on the time really elapsed between the samples
+        cea::EnergyAccumulator acc;
 
-        time_t start;
-        start = time(NULL);
+        // the first update only sets the counters the next one is compared
+        // to: its value has no meaning
+        pe.updatePid(pid);
+        cea::u64 start = cea::PowerMeter::now();
         do
           {
             usleep(period * 1000);
@@ -180,18 +182,24 @@ main(int argc, char *argv[])
             tpid = waitpid(pid, &status, WNOHANG);
 
             pe.updatePid(pid);
-            power = pe.getValuePid(pid).Float;
+            double power = pe.getValuePid(pid).Float;
 
-            energy += power * period / 1000; //from milliseconds to seconds
+            // the power of the first period is also the one of its start
+            if (start > 0)
+              acc.addSamplePid(pid, start, power);
+            start = 0;
+            acc.addSamplePid(pid, cea::PowerMeter::now(), power);
           }
         while (tpid != pid);
 
+        energy = acc.getEnergyPid(pid);
+
         if (energy > 1000)
           std::cout << " energy (kJ): " << energy / 1000 << std::endl;
         else
           std::cout << " energy (J): " << energy << std::endl;
 
-        std::cout << " time (s):   " << time(NULL) - start << std::endl;
+        std::cout << " time (s):   " << acc.getElapsedPid(pid) << std::endl;
         break;
       }
     else
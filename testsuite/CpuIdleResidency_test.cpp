@@ -0,0 +1,143 @@
+/*
+ * CpuIdleResidency_test.cpp
+ *
+ * Builds a fake cpuidle tree (cpuN/cpuidle/stateM/{name,time}), moves the
+ * time of its states forward and checks the residency matrix and the shares
+ * of the columns. Then checks that the time files are opened once and that
+ * the columns of a tick share a single pass.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorCpuIdleResidency.h>
+
+using namespace cea;
+
+#define ROOT            "/tmp/cpuidle_test"
+#define CPUS            4
+#define STATES          3
+
+static const char* names[STATES] =
+  { "POLL", "C1", "C6" };
+
+/* Writes the time of a state in the fake tree */
+void
+setTime(unsigned int cpu, unsigned int state, u64 time)
+{
+  char file[256];
+
+  snprintf(file, sizeof(file), ROOT "/cpu%u/cpuidle/state%u/time", cpu,
+      state);
+  std::ofstream ofs(file);
+  ofs << time << std::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  char cmd[256];
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: CpuIdleResidency" << std::endl;
+
+  for (unsigned int c = 0; c < CPUS; c++)
+    for (unsigned int s = 0; s < STATES; s++)
+      {
+        snprintf(cmd, sizeof(cmd), "mkdir -p " ROOT "/cpu%u/cpuidle/state%u",
+            c, s);
+        system(cmd);
+        snprintf(cmd, sizeof(cmd), ROOT "/cpu%u/cpuidle/state%u/name", c, s);
+        std::ofstream ofs(cmd);
+        ofs << names[s] << std::endl;
+        setTime(c, s, 1000);
+      }
+
+  /* Tree found, every time file opened */
+  CpuIdleResidency residency(ROOT);
+  ok = residency.getStatus() && (residency.getCpuCount() == CPUS)
+      && (residency.getStateCount() == STATES)
+      && (residency.getStateName(2) == "C6")
+      && (residency.getOpenCount() == CPUS * STATES);
+  std::cout << "Tree: " << residency.getCpuCount() << " CPUs, "
+      << residency.getStateCount() << " states  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Residency matrix: CPU c spends c * 1000 us in C1 and 2000 us in C6 */
+  std::vector<CpuIdleShare*> columns;
+  for (unsigned int c = 0; c < CPUS; c++)
+    for (int s = -1; s < STATES; s++)
+      columns.push_back(new CpuIdleShare(c, s, &residency));
+
+  usleep(20000);
+  for (unsigned int c = 0; c < CPUS; c++)
+    {
+      setTime(c, 1, 1000 + c * 1000);
+      setTime(c, 2, 1000 + 2000);
+    }
+
+  u64 passes = residency.getPassCount();
+  for (unsigned int i = 0; i < columns.size(); i++)
+    columns[i]->update();
+  const u64* matrix = residency.getResidencyMatrix();
+  ok = (residency.getPassCount() - passes == 1);
+  for (unsigned int c = 0; c < CPUS; c++)
+    ok &= (matrix[c * STATES + 0] == 0)
+        && (matrix[c * STATES + 1] == c * 1000)
+        && (matrix[c * STATES + 2] == 2000);
+  std::cout << "Matrix in " << residency.getPassCount() - passes
+      << " pass  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Shares of the elapsed time, C0 taking the rest */
+  float elapsed = residency.getElapsed();
+  ok = (elapsed >= 20000);
+  for (unsigned int c = 0; c < CPUS; c++)
+    {
+      float c1 = columns[c * (STATES + 1) + 2]->getValue().Float;
+      float c6 = columns[c * (STATES + 1) + 3]->getValue().Float;
+      float c0 = columns[c * (STATES + 1)]->getValue().Float;
+      ok &= (c1 > c * 1000 / elapsed - 0.001)
+          && (c1 < c * 1000 / elapsed + 0.001);
+      ok &= (c6 > 2000 / elapsed - 0.001) && (c6 < 2000 / elapsed + 0.001);
+      ok &= (c0 + c1 + c6 > 0.999) && (c0 + c1 + c6 < 1.001);
+    }
+  std::cout << "Shares over " << elapsed << " us  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Passes without opening the files again */
+  passes = residency.getPassCount();
+  for (unsigned int t = 0; t < 100; t++)
+    for (unsigned int i = 0; i < columns.size(); i++)
+      columns[i]->update();
+  ok = (residency.getPassCount() - passes == 100)
+      && (residency.getOpenCount() == CPUS * STATES);
+  std::cout << "100 ticks: " << residency.getPassCount() - passes
+      << " passes, " << residency.getOpenCount() << " files opened  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* A missing tree gives inactive columns */
+  CpuIdleResidency missing(ROOT "/none");
+  CpuIdleShare column(0, 1, &missing);
+  ok = !missing.getStatus() && !column.getStatus();
+  std::cout << "Missing tree  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  for (unsigned int i = 0; i < columns.size(); i++)
+    delete columns[i];
+  system("rm -rf " ROOT);
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
@@ -0,0 +1,159 @@
+/*
+ * DPEAlignment_test.cpp
+ *
+ * Trains a linear regression on a power meter whose samples lag 300 ms
+ * behind the activity: the model is right only if each power sample is
+ * joined to the inputs at its time minus the delay of the meter.
+ */
+
+#include <iostream>
+#include <cmath>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/containers/TimeSeriesRing.h>
+#include <libec/estimator/DPELinearRegression.h>
+
+using namespace cea;
+
+static u64 start;
+
+/* Activity: a ramp of 1 per second */
+static double
+activity(u64 time)
+{
+  return (double) (time - start) / 1e9;
+}
+
+class RampSensor : public Sensor
+{
+public:
+  RampSensor()
+  {
+    _name = "RAMP";
+    _alias = "RAMP";
+    _type = Float;
+    _isActive = true;
+  }
+
+  void
+  update()
+  {
+    _cValue.Float = activity(PowerMeter::now());
+  }
+};
+
+/* Power meter publishing 10 * activity + 5 every 100 ms, 300 ms late */
+class LatePowerMeter : public PowerMeter
+{
+public:
+  LatePowerMeter() :
+      running(true)
+  {
+    _name = "LATE_POWER_METER";
+    _alias = "PM_LATE";
+    _type = Float;
+    _isActive = true;
+    _publishes = true;
+    value = 0;
+    pthread_create(&thread, NULL, run, this);
+  }
+
+  ~LatePowerMeter()
+  {
+    running = false;
+    pthread_join(thread, NULL);
+  }
+
+  void
+  update()
+  {
+    _cValue.Float = value;
+  }
+
+  static void*
+  run(void* arg)
+  {
+    LatePowerMeter* pm = (LatePowerMeter*) arg;
+
+    while (pm->running)
+      {
+        usleep(100000);
+        u64 t = now();
+        pm->value = 10 * activity(t - 300000000ull) + 5;
+        pm->publishSample(t);
+      }
+    return NULL;
+  }
+
+  volatile bool running;
+  volatile float value;
+  pthread_t thread;
+};
+
+/* Estimator sampling its inputs every 20 ms */
+class FastDPE : public DPELinearRegression
+{
+public:
+  FastDPE(PowerMeter* pm, Sensor* input) :
+      DPELinearRegression(1, NULL, pm)
+  {
+    _latency = 20;
+    _sensors.push_back(input);
+  }
+
+  double
+  getWeight(int i)
+  {
+    return _weights[i];
+  }
+};
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: TimeSeriesRing" << std::endl;
+
+  /* Interpolation and drop of the oldest rows */
+  TimeSeriesRing ring(2, 4);
+  double row[2], out[2];
+  for (int i = 0; i < 6; i++)
+    {
+      row[0] = i;
+      row[1] = 10 * i;
+      ring.push(100 * i, row);
+    }
+  ok = (ring.size() == 4) && (ring.getOldestTime() == 200)
+      && (ring.getLatestTime() == 500);
+  ok &= ring.interpolate(250, out) && (out[0] == 2.5) && (out[1] == 25);
+  ok &= ring.interpolate(500, out) && (out[0] == 5);
+  ok &= !ring.interpolate(150, out) && !ring.interpolate(501, out);
+  std::cout << "Interpolation: " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << "Testing class: DPELinearRegression (alignment)" << std::endl;
+
+  start = PowerMeter::now();
+  RampSensor* ramp = new RampSensor();
+  LatePowerMeter pm;
+  FastDPE dpe(&pm, ramp);
+
+  dpe.setMeterDelay(300);
+  dpe.collectData(2);
+  dpe.calibrate();
+
+  double w0 = dpe.getWeight(0), w1 = dpe.getWeight(1);
+  ok = (std::fabs(w0 - 5) < 0.5) && (std::fabs(w1 - 10) < 0.5);
+  std::cout << "power = " << w0 << " + " << w1 << " * activity  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
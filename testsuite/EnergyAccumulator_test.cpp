@@ -0,0 +1,82 @@
+/*
+ * EnergyAccumulator_test.cpp
+ *
+ * Integrates synthetic power samples taken at irregular times and checks
+ * the energy since the start and over the window, for the machine and per
+ * process.
+ */
+
+#include <iostream>
+#include <cmath>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/estimator/EnergyAccumulator.h>
+
+using namespace cea;
+
+static bool
+near(double a, double b)
+{
+  return std::fabs(a - b) < 1e-6;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  const u64 s = 1000000000ull;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: EnergyAccumulator" << std::endl;
+
+  EnergyAccumulator acc(2000); // 2 s window
+
+  /* Machine: a ramp of 10 W/s from 100 W, sampled at irregular times; the
+   * trapezoidal rule is exact on a ramp */
+  u64 start = 5 * s;
+  double times[] =
+    { 0, 0.1, 0.35, 0.4, 1.2, 1.25, 2.0, 2.9, 3.3, 4.0 };
+  for (unsigned int i = 0; i < sizeof(times) / sizeof(times[0]); i++)
+    acc.addSample(start + (u64) (times[i] * s), 100 + 10 * times[i]);
+
+  // 100 * 4 + 10 * 4^2 / 2
+  ok = near(acc.getEnergy(), 480) && near(acc.getElapsed(), 4);
+  std::cout << "Energy since start: " << acc.getEnergy() << " J in "
+      << acc.getElapsed() << " s  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  // from 2 s to 4 s: 100 * 2 + 10 * (4^2 - 2^2) / 2
+  ok = near(acc.getWindowEnergy(), 260);
+  std::cout << "Energy of the window: " << acc.getWindowEnergy() << " J  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  // the start of the window falls inside an interval (3.3 s to 4.0 s)
+  acc.addSample(start + (u64) (5.0 * s), 150);
+  ok = near(acc.getWindowEnergy(), 100 * 2 + 10 * (25 - 9) / 2.0);
+  ok &= !near(acc.getEnergy(), acc.getWindowEnergy());
+  std::cout << "Moving window: " << acc.getWindowEnergy() << " J  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Processes: constant power, one sample out of order */
+  acc.addSamplePid(10, start, 20);
+  acc.addSamplePid(10, start + s / 2, 20);
+  acc.addSamplePid(10, start + s / 4, 500);
+  acc.addSamplePid(10, start + s, 20);
+  acc.addSamplePid(11, start, 5);
+  acc.addSamplePid(11, start + 3 * s, 5);
+
+  ok = near(acc.getEnergyPid(10), 20) && near(acc.getEnergyPid(11), 15);
+  ok &= near(acc.getWindowEnergyPid(11), 10) && (acc.getEnergyPid(12) == 0);
+  acc.removePid(10);
+  ok &= (acc.getEnergyPid(10) == 0);
+  std::cout << "Per process: " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
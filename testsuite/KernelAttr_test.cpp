@@ -0,0 +1,147 @@
+/*
+ * KernelAttr_test.cpp
+ *
+ * Reads numbers and "key: value" lines from fake attribute files, checks
+ * that a file is opened once whatever the number of reads and that a file
+ * replaced or appearing later is opened again transparently. Then measures
+ * the cost of a read opening the file with an std::ifstream, as the sensors
+ * used to, and through a KernelAttr, on a fake file and on real procfs and
+ * sysfs attributes.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/device/KernelAttr.h>
+
+using namespace cea;
+
+#define READS           10000
+
+/* Writes a fake attribute file */
+void
+write(const char* file, const char* content)
+{
+  std::ofstream ofs(file);
+  ofs << content;
+}
+
+/* Cost of a read of the first number of a file (ns) */
+void
+benchmark(const char* file)
+{
+  u64 value;
+
+  if (access(file, R_OK) != 0)
+    return;
+
+  u64 time = SamplingClock::now();
+  for (unsigned int i = 0; i < READS; i++)
+    {
+      std::ifstream ifs(file);
+      if (ifs.good())
+        ifs >> value;
+      ifs.close();
+    }
+  u64 stream = (SamplingClock::now() - time) / READS;
+
+  KernelAttr attr(file);
+  time = SamplingClock::now();
+  for (unsigned int i = 0; i < READS; i++)
+    attr.readU64(value);
+  u64 open = (SamplingClock::now() - time) / READS;
+
+  std::cout << "  " << file << ": " << stream << " ns/read with ifstream, "
+      << open << " ns/read kept open" << std::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  u64 value, values[5];
+  long long temp;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: KernelAttr" << std::endl;
+
+  /* Numbers */
+  write("/tmp/kattr_u64", "1200000\n");
+  write("/tmp/kattr_s64", "-4500\n");
+  write("/tmp/kattr_stat", "   12  0  340   8   77   0\n");
+  KernelAttr u("/tmp/kattr_u64"), s("/tmp/kattr_s64"), stat("/tmp/kattr_stat");
+  ok = u.readU64(value) && (value == 1200000);
+  ok &= s.readS64(temp) && (temp == -4500) && !s.readU64(value);
+  ok &= (stat.readU64s(values, 5) == 5) && (values[0] == 12)
+      && (values[2] == 340) && (values[4] == 77);
+  std::cout << "Numbers  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Keys: "Cached" is not "SwapCached", missing keys are 0 */
+  write("/tmp/kattr_meminfo", "MemTotal:        8000000 kB\n"
+      "MemFree:         1000000 kB\n"
+      "Buffers:          200000 kB\n"
+      "SwapCached:          100 kB\n"
+      "Cached:          3000000 kB\n");
+  static const char* keys[] =
+    { "MemTotal", "Cached", "Buffers", "Missing" };
+  KernelAttr meminfo("/tmp/kattr_meminfo");
+  ok = (meminfo.readKeys(keys, values, 4) == 3) && (values[0] == 8000000)
+      && (values[1] == 3000000) && (values[2] == 200000) && (values[3] == 0);
+  ok &= meminfo.readKey("MemFree", value) && (value == 1000000);
+  std::cout << "Keys  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Opened once, the copy reading through its own descriptor */
+  u64 opened = KernelAttr::getOpenCount();
+  ok = true;
+  for (unsigned int i = 0; i < 100; i++)
+    {
+      write("/tmp/kattr_u64", (i % 2) ? "1800000\n" : "2400000\n");
+      ok &= u.readU64(value) && (value == ((i % 2) ? 1800000u : 2400000u));
+    }
+  KernelAttr copy(u);
+  ok &= copy.readU64(value) && (value == 1800000);
+  ok &= (KernelAttr::getOpenCount() == opened);
+  std::cout << "Files opened: " << KernelAttr::getOpenCount() - opened
+      << " for 101 reads  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* A file replaced is opened again: the old one is emptied, as a removed
+   * attribute fails */
+  write("/tmp/kattr_new", "1000\n");
+  write("/tmp/kattr_u64", "");
+  rename("/tmp/kattr_new", "/tmp/kattr_u64");
+  ok = u.readU64(value) && (value == 1000);
+
+  /* A missing file is opened by the first read after it appears */
+  unlink("/tmp/kattr_late");
+  KernelAttr late("/tmp/kattr_late");
+  ok &= !late.isOpen() && !late.readU64(value);
+  write("/tmp/kattr_late", "42\n");
+  ok &= late.readU64(value) && (value == 42) && late.isOpen();
+  std::cout << "Reopen  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Micro-benchmark */
+  std::cout << "Reading a number:" << std::endl;
+  benchmark("/tmp/kattr_late");
+  benchmark("/proc/sys/kernel/pid_max");
+  benchmark("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
+  benchmark("/sys/class/thermal/thermal_zone0/temp");
+
+  unlink("/tmp/kattr_u64");
+  unlink("/tmp/kattr_s64");
+  unlink("/tmp/kattr_stat");
+  unlink("/tmp/kattr_meminfo");
+  unlink("/tmp/kattr_late");
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
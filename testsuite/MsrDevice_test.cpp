@@ -0,0 +1,147 @@
+/*
+ * MsrDevice_test.cpp
+ *
+ * Reads the registers of fake MSR devices (regular files holding values at
+ * the address of the registers) and checks that each device is opened once
+ * whatever the number of reads. Then measures the cost per CPU per tick of
+ * reading APERF, MPERF and the TSC, opening the device for each register
+ * as the MSR sensors used to, and on the devices kept open. The real
+ * devices are measured when readable (root, msr module).
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/device/MsrDevice.h>
+
+using namespace cea;
+
+#define MSR_APERF       0xE8
+#define MSR_MPERF       0xE7
+#define MSR_TSC         0x10
+
+#define CPUS            8
+#define TICKS           1000
+
+static const unsigned int regs[] =
+  { MSR_APERF, MSR_MPERF, MSR_TSC };
+
+/* Addresses far enough apart not to overlap in a fake device */
+static const unsigned int fakeRegs[] =
+  { 0x10, 0x100, 0x200 };
+
+/* Reads a register opening the device, as the sensors used to */
+bool
+readOnce(const char* path, unsigned int cpu, unsigned int reg, u64 &value)
+{
+  char name[256];
+
+  snprintf(name, sizeof(name), path, cpu);
+  int fd = open(name, O_RDONLY);
+  if (fd < 0)
+    return false;
+  bool ok = (pread(fd, &value, sizeof(value), reg) == sizeof(value));
+  close(fd);
+  return ok;
+}
+
+/* Cost per CPU per tick of reading the counters of all the CPUs (ns) */
+void
+benchmark(const char* path, unsigned int cpus)
+{
+  u64 values[3];
+
+  u64 time = SamplingClock::now();
+  for (unsigned int t = 0; t < TICKS; t++)
+    for (unsigned int cpu = 0; cpu < cpus; cpu++)
+      for (unsigned int r = 0; r < 3; r++)
+        readOnce(path, cpu, regs[r], values[r]);
+  u64 once = (SamplingClock::now() - time) / (TICKS * cpus);
+
+  MsrDevice::setPath(path);
+  time = SamplingClock::now();
+  for (unsigned int t = 0; t < TICKS; t++)
+    for (unsigned int cpu = 0; cpu < cpus; cpu++)
+      MsrDevice::read(cpu, regs, values, 3);
+  u64 open = (SamplingClock::now() - time) / (TICKS * cpus);
+
+  std::cout << "  " << path << ": " << once << " ns/cpu/tick opening, " << open
+      << " ns/cpu/tick kept open" << std::endl;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  char name[256];
+  u64 value, values[3];
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: MsrDevice" << std::endl;
+
+  /* Fake devices: the value of a register is at its address (a byte
+   * offset in the file, so the registers must be 8 bytes apart) */
+  for (unsigned int cpu = 0; cpu < CPUS; cpu++)
+    {
+      snprintf(name, sizeof(name), "/tmp/msr_test_%u", cpu);
+      int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      for (unsigned int r = 0; r < 3; r++)
+        {
+          value = (u64) (cpu + 1) * 1000 + fakeRegs[r];
+          pwrite(fd, &value, sizeof(value), fakeRegs[r]);
+        }
+      close(fd);
+    }
+
+  MsrDevice::setPath("/tmp/msr_test_%u");
+  u64 opened = MsrDevice::getOpenCount();
+
+  /* Values read in one pass, each device opened once */
+  ok = true;
+  for (unsigned int t = 0; t < 100; t++)
+    for (unsigned int cpu = 0; cpu < CPUS; cpu++)
+      {
+        ok &= MsrDevice::read(cpu, fakeRegs, values, 3);
+        for (unsigned int r = 0; r < 3; r++)
+          ok &= (values[r] == (u64) (cpu + 1) * 1000 + fakeRegs[r]);
+      }
+  ok &= MsrDevice::read(3, 0x200, value) && (value == 4000 + 0x200);
+  ok &= (MsrDevice::getOpenCount() - opened == CPUS);
+  std::cout << "Devices opened: " << MsrDevice::getOpenCount() - opened
+      << " for " << 100 * CPUS << " passes  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* A missing device is not opened again */
+  opened = MsrDevice::getOpenCount();
+  ok = !MsrDevice::read(CPUS, MSR_TSC, value)
+      && !MsrDevice::read(CPUS, MSR_TSC, value)
+      && !MsrDevice::isAvailable(CPUS);
+  ok &= (MsrDevice::getOpenCount() - opened == 1);
+  std::cout << "Missing device  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Micro-benchmark */
+  std::cout << "Reading APERF, MPERF and TSC:" << std::endl;
+  benchmark("/tmp/msr_test_%u", CPUS);
+
+  MsrDevice::setPath("/dev/cpu/%u/msr");
+  if (MsrDevice::isAvailable(0))
+    benchmark("/dev/cpu/%u/msr", sysconf(_SC_NPROCESSORS_ONLN));
+  MsrDevice::close();
+
+  for (unsigned int cpu = 0; cpu < CPUS; cpu++)
+    {
+      snprintf(name, sizeof(name), "/tmp/msr_test_%u", cpu);
+      unlink(name);
+    }
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
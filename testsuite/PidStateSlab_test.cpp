@@ -0,0 +1,187 @@
+/*
+ * PidStateSlab_test.cpp
+ *
+ * Checks the per-pid state shared by the PIDSensors (zero filled blocks,
+ * rows kept across block registration, owners notified on release) and
+ * times a per-pid update against the former per-sensor maps.
+ */
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPid.h>
+#include <libec/process/PidStateSlab.h>
+
+using namespace cea;
+
+/* Current and previous values, as kept by most PIDSensors */
+struct CounterState
+{
+  u64 cur;
+  u64 prev;
+};
+
+/* Sensor counting its updates per pid */
+class FakePidSensor : public PIDSensor
+{
+public:
+  FakePidSensor() :
+      removed(0)
+  {
+    registerState(sizeof(CounterState));
+  }
+
+  void
+  update()
+  {
+  }
+
+  void
+  updatePid(pid_t pid)
+  {
+    CounterState* st = getState<CounterState>(pid);
+    st->prev = st->cur;
+    st->cur++;
+  }
+
+  sensor_t
+  getValuePid(pid_t pid)
+  {
+    sensor_t val;
+    CounterState* st = getState<CounterState>(pid);
+    val.U64 = st->cur - st->prev;
+    return val;
+  }
+
+  u64
+  getCount(pid_t pid)
+  {
+    CounterState* st = findState<CounterState>(pid);
+    return (st != NULL) ? st->cur : 0;
+  }
+
+  void
+  remove(pid_t pid)
+  {
+    removed++;
+    PIDSensor::remove(pid);
+  }
+
+  unsigned int removed;
+};
+
+static double
+elapsedUsec(const struct timeval& start, const struct timeval& end)
+{
+  return (end.tv_sec - start.tv_sec) * 1000000.0
+      + (end.tv_usec - start.tv_usec);
+}
+
+int
+main(int argc, char *argv[])
+{
+  const pid_t pidCount = 1000;
+  bool passed = true, ok;
+  struct timeval start, end;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: PidStateSlab" << std::endl;
+
+  FakePidSensor* s1 = new FakePidSensor();
+
+  /* State is created on demand and zero filled */
+  for (pid_t pid = 1; pid <= pidCount; pid++)
+    {
+      passed &= (s1->getValuePid(pid).U64 == 0);
+      for (int i = 0; i < pid % 5; i++)
+        s1->updatePid(pid);
+    }
+  ok = (PidStateSlab::getRowCount() == (unsigned int) (pidCount));
+  for (pid_t pid = 1; pid <= pidCount; pid++)
+    ok &= (s1->getCount(pid) == (u64) (pid % 5));
+  std::cout << "Per-pid state:        " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* A new sensor widens the rows, previous state is kept */
+  FakePidSensor* s2 = new FakePidSensor();
+  ok = (PidStateSlab::getRowSize() == 2 * sizeof(CounterState));
+  for (pid_t pid = 1; pid <= pidCount; pid++)
+    {
+      ok &= (s1->getCount(pid) == (u64) (pid % 5));
+      ok &= (s2->getCount(pid) == 0);
+      s2->updatePid(pid);
+    }
+  std::cout << "Block registration:   " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* Releasing a pid notifies the owners and recycles the row */
+  for (pid_t pid = 1; pid <= pidCount; pid += 2)
+    PidStateSlab::release(pid);
+  ok = (s1->removed == (unsigned int) (pidCount / 2));
+  ok &= (s2->removed == (unsigned int) (pidCount / 2));
+  ok &= (PidStateSlab::getRowCount() == (unsigned int) (pidCount / 2));
+  ok &= (PidStateSlab::find(1) == NULL);
+  s1->updatePid(pidCount + 1);
+  ok &= (s1->getCount(pidCount + 1) == 1);
+  ok &= (s2->getCount(pidCount + 1) == 0);
+  ok &= (s1->getCount(2) == 2);
+  std::cout << "Release:              " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* The block of a deleted sensor is reused, zero filled */
+  delete s2;
+  FakePidSensor* s3 = new FakePidSensor();
+  ok = (PidStateSlab::getRowSize() == 2 * sizeof(CounterState));
+  for (pid_t pid = 2; pid <= pidCount; pid += 2)
+    ok &= (s3->getCount(pid) == 0);
+  std::cout << "Block reuse:          " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* Per-pid update: 4 maps per sensor (as PidStat) vs one slab row */
+  const int rounds = 200;
+  std::map<pid_t, u64> cv, pv, ct, pt;
+  u64 sum = 0;
+
+  gettimeofday(&start, NULL);
+  for (int r = 0; r < rounds; r++)
+    for (pid_t pid = 1; pid <= pidCount; pid++)
+      {
+        pt[pid] = ct[pid];
+        ct[pid] = r;
+        pv[pid] = cv[pid];
+        cv[pid]++;
+        sum += cv[pid] - pv[pid];
+      }
+  gettimeofday(&end, NULL);
+  std::cout << "maps update: " << elapsedUsec(start, end) / rounds
+      << " us per tick" << std::endl;
+
+  gettimeofday(&start, NULL);
+  for (int r = 0; r < rounds; r++)
+    for (pid_t pid = 1; pid <= pidCount; pid++)
+      {
+        s3->updatePid(pid);
+        sum -= s3->getValuePid(pid).U64;
+      }
+  gettimeofday(&end, NULL);
+  std::cout << "slab update: " << elapsedUsec(start, end) / rounds
+      << " us per tick" << std::endl;
+
+  passed &= (sum == 0);
+
+  delete s1;
+  delete s3;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
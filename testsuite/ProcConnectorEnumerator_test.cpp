@@ -0,0 +1,69 @@
+/*
+ * ProcConnectorEnumerator_test.cpp
+ *
+ * Forks and kills a child and checks that the proc connector enumerator
+ * follows it without rescanning /proc.
+ */
+
+#include <iostream>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/process.h>
+
+using namespace cea;
+
+int
+main(int argc, char *argv[])
+{
+  ProcConnectorEnumerator pe;
+  bool passed = true, ok;
+  pid_t child;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: ProcConnectorEnumerator" << std::endl;
+  std::cout << "Connected: " << (pe.isConnected() ? "yes" : "no (rescan mode)")
+      << std::endl;
+
+  pe.setFrequency(0);
+  pe.setRescanPeriod(0);
+  pe.update();
+  std::cout << "Processes: " << pe.getProcessCount() << std::endl;
+
+  /* Process creation */
+  child = fork();
+  if (child == 0)
+    {
+      execlp("sleep", "sleep", "30", (char*) NULL);
+      _exit(1);
+    }
+  usleep(100000);
+  pe.update();
+  Process* p = pe.getProcessByPID(child);
+  std::cout << "Child " << child << " found: "
+      << ((p != 0) ? p->getName() : "no") << std::endl;
+  passed &= (p != 0) && (p->getName() == "sleep");
+
+  /* Process exit */
+  kill(child, SIGKILL);
+  waitpid(child, NULL, 0);
+  usleep(100000);
+  pe.update();
+  std::cout << "Child removed: "
+      << ((pe.getProcessByPID(child) == 0) ? "yes" : "no") << std::endl;
+  passed &= (pe.getProcessByPID(child) == 0);
+
+  /* Connected, the events follow the child: only the first update rescans */
+  ok = !pe.isConnected() || (pe.getRescanCount() == 1);
+  std::cout << "Full /proc rescans: " << pe.getRescanCount() << "  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+  return (passed ? 0 : 1);
+}
@@ -0,0 +1,89 @@
+/*
+ * ProcStat_test.cpp
+ *
+ * Scans a /proc/stat content by hand and checks the jiffies of the
+ * aggregate and of each CPU, then checks that the CPU time sensors updated
+ * in the same tick share a single read of the file.
+ */
+
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/device/ProcStat.h>
+#include <libec/sensor/SensorPidCpuTime.h>
+
+using namespace cea;
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  ProcStat::Jiffies total, cpus[4], j;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: ProcStat" << std::endl;
+
+  /* Scanner: CPU lines with 10 or 4 columns, followed by other lines */
+  const char* content = "cpu  400 10 200 9000 5 1 2 3 0 0\n"
+      "cpu0 100 5 50 4500 2 1 1 1 0 0\n"
+      "cpu1 300 5 150 4500 3\n"
+      "intr 123456 0 0 0\n"
+      "ctxt 987654\n";
+  int n = ProcStat::parse(content, total, cpus, 4);
+  ok = (n == 2) && (total.field[ProcStat::USER] == 400)
+      && (total.field[ProcStat::STEAL] == 3);
+  ok &= (total.getBusy() == 400 + 10 + 200 + 1 + 2 + 3);
+  ok &= (total.getTotal() == total.getBusy() + 9000 + 5);
+  ok &= (cpus[0].field[ProcStat::SYSTEM] == 50)
+      && (cpus[1].field[ProcStat::IOWAIT] == 3)
+      && (cpus[1].field[ProcStat::IRQ] == 0);
+  ok &= (ProcStat::parse("intr 1 2 3\n", total, cpus, 4) == -1);
+  std::cout << "Scanner: " << n << " CPUs  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* The sensors of a tick share one read */
+  int count = ProcStat::getCpuCount();
+  std::vector<CpuTime*> sensors;
+  sensors.push_back(new CpuTime());
+  for (int i = 0; i < count; i++)
+    sensors.push_back(new CpuTime(i));
+
+  // the snapshot read by the constructors is outdated
+  usleep(20000);
+  u64 reads = ProcStat::getReadCount();
+  for (unsigned int i = 0; i < sensors.size(); i++)
+    sensors[i]->update();
+  ok = (count > 0) && (ProcStat::getReadCount() - reads == 1);
+
+  // the aggregate is the sum of the CPUs
+  u64 sum = 0;
+  for (unsigned int i = 1; i < sensors.size(); i++)
+    sum += sensors[i]->getValue().U64;
+  ok &= (sum <= sensors[0]->getValue().U64 + count)
+      && (sum + count >= sensors[0]->getValue().U64);
+  std::cout << "Reads for " << sensors.size() << " sensors: "
+      << ProcStat::getReadCount() - reads << "  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Without sharing, every request reads the file */
+  ProcStat::setMaxAge(0);
+  reads = ProcStat::getReadCount();
+  ok = true;
+  for (int i = 0; i < 10; i++)
+    ok &= ProcStat::getCpu(-1, j);
+  ok &= (ProcStat::getReadCount() - reads == 10) && !ProcStat::getCpu(count, j);
+  std::cout << "No sharing  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  for (unsigned int i = 0; i < sensors.size(); i++)
+    delete sensors[i];
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
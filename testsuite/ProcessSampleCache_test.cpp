@@ -0,0 +1,81 @@
+/*
+ * ProcessSampleCache_test.cpp
+ *
+ * Counts the proc/[pid] files read per tick when several PIDSensors sample
+ * every running process, with and without the shared sample cache, and
+ * checks that the cache reads fewer files.
+ */
+
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensors.h>
+#include <libec/process.h>
+
+using namespace cea;
+
+/* Update every sensor for every enumerated process, as MonitorEctop does */
+static void
+updateAll(ProcessEnumerator& pe, std::vector<PIDSensor*>& sensors)
+{
+  for (unsigned int i = 0; i < pe.getProcessCount(); i++)
+    {
+      pid_t pid = pe.getProcess(i)->getPid();
+      for (unsigned int j = 0; j < sensors.size(); j++)
+        {
+          sensors[j]->add(pid);
+          sensors[j]->updatePid(pid);
+        }
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+  ProcessEnumerator pe;
+  std::vector<PIDSensor*> sensors;
+  u64 reads, cached, uncached;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: ProcessSampleCache" << std::endl;
+
+  sensors.push_back(new PidStat(PidStat::CPU_USAGE));
+  sensors.push_back(new PidStat(PidStat::RESIDENT_SET_SIZE));
+  sensors.push_back(new CpuTime());
+  sensors.push_back(new MemRss());
+  sensors.push_back(new MemUsage());
+
+  pe.setFrequency(0);
+  pe.update();
+  std::cout << "Processes: " << pe.getProcessCount() << "  sensors: "
+      << sensors.size() << std::endl;
+
+  /* PidStat samples at most once per second */
+  sleep(1);
+
+  /* Ticked by the enumerator: one read per file and process */
+  reads = ProcessSampleCache::getReadCount();
+  pe.update();
+  updateAll(pe, sensors);
+  cached = ProcessSampleCache::getReadCount() - reads;
+  std::cout << "with cache:    " << cached << " files read" << std::endl;
+
+  /* Cache disabled: every sensor reads its own file */
+  ProcessSampleCache::clear();
+  sleep(1);
+  reads = ProcessSampleCache::getReadCount();
+  updateAll(pe, sensors);
+  uncached = ProcessSampleCache::getReadCount() - reads;
+  std::cout << "without cache: " << uncached << " files read" << std::endl;
+
+  for (unsigned int j = 0; j < sensors.size(); j++)
+    delete sensors[j];
+
+  bool passed = (cached > 0) && (cached < uncached);
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
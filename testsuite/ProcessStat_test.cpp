@@ -0,0 +1,142 @@
+/*
+ * ProcessStat_test.cpp
+ *
+ * Checks the proc/[pid]/stat snapshot parser and benchmarks the per-field
+ * helpers (one file read per field) against a single Snapshot read.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/process/linux/ProcessStat.h>
+
+using namespace cea;
+
+/* Number of read syscalls done so far by this process */
+static unsigned long long
+readSyscalls()
+{
+  std::ifstream f("/proc/self/io");
+  std::string key;
+  unsigned long long value = 0;
+
+  while (f >> key >> value)
+    if (key == "syscr:")
+      return value;
+  return 0;
+}
+
+static double
+elapsedUsec(const struct timeval& start, const struct timeval& end)
+{
+  return (end.tv_sec - start.tv_sec) * 1000000.0
+      + (end.tv_usec - start.tv_usec);
+}
+
+static bool
+checkParser()
+{
+  const char* line = "4242 (a) b (c)) S 1 4242 4242 0 -1 4194560 120 0 3 0 "
+      "57 13 0 0 20 0 1 0 8812 10420224 512 18446744073709551615 1 1 0 0 0 "
+      "0 0 0 0 0 0 0 17 3 0 0 0 0 0\n";
+  ProcessStat::Snapshot snap;
+  std::string comm;
+  char state;
+  long unsigned int utime, stime;
+  long int rss;
+  int processor;
+
+  if (!snap.parse(line))
+    return false;
+
+  ProcessStat::get(snap, ProcessStat::COMM, comm);
+  ProcessStat::get(snap, ProcessStat::STATE, state);
+  ProcessStat::get(snap, ProcessStat::UTIME, utime);
+  ProcessStat::get(snap, ProcessStat::STIME, stime);
+  ProcessStat::get(snap, ProcessStat::RSS, rss);
+  ProcessStat::get(snap, ProcessStat::PROCESSOR, processor);
+
+  return (snap.pid == 4242) && (comm == "a) b (c)") && (state == 'S')
+      && (utime == 57) && (stime == 13) && (rss == 512) && (processor == 3);
+}
+
+int
+main(int argc, char *argv[])
+{
+  std::vector<pid_t> pids;
+  struct timeval start, end;
+  unsigned long long sc;
+  int rounds = (argc > 1) ? atoi(argv[1]) : 10;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: ProcessStat" << std::endl;
+  bool passed = checkParser();
+  std::cout << "Snapshot parser: " << (passed ? "PASSED" : "FAILED")
+      << std::endl;
+
+  /* Get the current processes */
+  DIR* proc = opendir("/proc");
+  struct dirent* dir;
+  while ((proc != NULL) && ((dir = readdir(proc)) != NULL))
+    if ((dir->d_type == DT_DIR) && Tools::isNumeric(dir->d_name))
+      pids.push_back(atoi(dir->d_name));
+  if (proc != NULL)
+    closedir(proc);
+
+  if (!passed || pids.empty() || (rounds <= 0))
+    return 1;
+
+  unsigned long long n = (unsigned long long) (pids.size()) * rounds;
+  std::cout << "Processes: " << pids.size() << "  rounds: " << rounds
+      << std::endl;
+
+  /* Before: what LinuxProcessEnumerator/LinuxProcess needed per process */
+  char state;
+  std::string comm;
+  long unsigned int utime, stime;
+
+  sc = readSyscalls();
+  gettimeofday(&start, NULL);
+  for (int r = 0; r < rounds; r++)
+    for (unsigned int i = 0; i < pids.size(); i++)
+      {
+        ProcessStat::get(pids[i], ProcessStat::STATE, state);
+        ProcessStat::get(pids[i], ProcessStat::COMM, comm);
+        ProcessStat::get(pids[i], ProcessStat::UTIME, utime);
+        ProcessStat::get(pids[i], ProcessStat::STIME, stime);
+      }
+  gettimeofday(&end, NULL);
+  sc = readSyscalls() - sc;
+  std::cout << "per-field: " << elapsedUsec(start, end) / n
+      << " us/process, " << (double) (sc) / n << " read syscalls/process"
+      << std::endl;
+
+  /* After: one snapshot per process */
+  sc = readSyscalls();
+  gettimeofday(&start, NULL);
+  for (int r = 0; r < rounds; r++)
+    for (unsigned int i = 0; i < pids.size(); i++)
+      {
+        ProcessStat::Snapshot snap;
+        snap.read(pids[i]);
+        ProcessStat::get(snap, ProcessStat::STATE, state);
+        ProcessStat::get(snap, ProcessStat::COMM, comm);
+        ProcessStat::get(snap, ProcessStat::UTIME, utime);
+        ProcessStat::get(snap, ProcessStat::STIME, stime);
+      }
+  gettimeofday(&end, NULL);
+  sc = readSyscalls() - sc;
+  std::cout << "snapshot:  " << elapsedUsec(start, end) / n
+      << " us/process, " << (double) (sc) / n << " read syscalls/process"
+      << std::endl;
+
+  return 0;
+}
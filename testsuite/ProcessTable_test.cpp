@@ -0,0 +1,129 @@
+/*
+ * ProcessTable_test.cpp
+ *
+ * Checks the pid index of ProcessTable against a std::map under random
+ * insertions/removals, and times positional access against the former
+ * linear walk of the process map.
+ */
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/process/ProcessTable.h>
+
+using namespace cea;
+
+/* Minimal process, nothing read from /proc */
+class FakeProcess : public Process
+{
+public:
+  FakeProcess(pid_t pid) :
+      Process(pid)
+  {
+  }
+  void
+  calculCPUUsage(long int totalCPUTimeElapsed)
+  {
+  }
+};
+
+static double
+elapsedUsec(const struct timeval& start, const struct timeval& end)
+{
+  return (end.tv_sec - start.tv_sec) * 1000000.0
+      + (end.tv_usec - start.tv_usec);
+}
+
+static bool
+checkConsistency(const ProcessTable& t, const std::map<pid_t, Process*>& m)
+{
+  if (t.size() != m.size())
+    return false;
+  for (std::map<pid_t, Process*>::const_iterator it = m.begin();
+      it != m.end(); ++it)
+    {
+      if (t.find(it->first) != it->second)
+        return false;
+      if (t.at(t.indexOf(it->first)) != it->second)
+        return false;
+    }
+  return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+  ProcessTable table;
+  std::map<pid_t, Process*> ref;
+  struct timeval start, end;
+  bool passed = true;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: ProcessTable" << std::endl;
+
+  /* Random churn over a small pid range to force collisions */
+  srand(42);
+  for (int i = 0; i < 200000; i++)
+    {
+      pid_t pid = 1 + rand() % 4096;
+      std::map<pid_t, Process*>::iterator it = ref.find(pid);
+      if (it == ref.end())
+        {
+          Process* p = new FakeProcess(pid);
+          table.insert(p);
+          ref[pid] = p;
+        }
+      else
+        {
+          passed &= (table.remove(pid) == it->second);
+          delete it->second;
+          ref.erase(it);
+        }
+      if ((i % 10000) == 0)
+        passed &= checkConsistency(table, ref);
+    }
+  passed &= checkConsistency(table, ref);
+  std::cout << "Index consistency: " << (passed ? "PASSED" : "FAILED")
+      << "  (" << table.size() << " processes)" << std::endl;
+
+  /* for (i) getProcess(i) as done by ecps */
+  unsigned int n = table.size();
+  long sum = 0;
+
+  gettimeofday(&start, NULL);
+  for (unsigned int i = 0; i < n; i++)
+    {
+      unsigned int id = i;
+      for (std::map<pid_t, Process*>::iterator it = ref.begin();
+          it != ref.end(); ++it, id--)
+        if (id == 0)
+          {
+            sum += it->second->getPid();
+            break;
+          }
+    }
+  gettimeofday(&end, NULL);
+  std::cout << "map walk:     " << elapsedUsec(start, end) << " us" << std::endl;
+
+  gettimeofday(&start, NULL);
+  for (unsigned int i = 0; i < n; i++)
+    sum -= table.at(i)->getPid();
+  gettimeofday(&end, NULL);
+  std::cout << "table access: " << elapsedUsec(start, end) << " us"
+      << std::endl;
+
+  passed &= (sum == 0);
+
+  for (std::map<pid_t, Process*>::iterator it = ref.begin(); it != ref.end();
+      ++it)
+    delete it->second;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
@@ -0,0 +1,108 @@
+/*
+ * SampleRing_test.cpp
+ *
+ * Hands records from a producer thread to a consumer thread through the
+ * lock-free ring and checks that none is lost or reordered when the
+ * producer waits for room, and that the records dropped on a full ring are
+ * counted.
+ */
+
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/containers/SampleRing.h>
+
+using namespace cea;
+
+#define RECORDS 20000
+
+static volatile bool producing;
+static unsigned int received;
+static bool ordered;
+
+/* Pops the records, checking they arrive in order */
+void*
+consume(void* data)
+{
+  SampleRing* ring = (SampleRing*) data;
+  sensor_t values[2];
+  unsigned int tag;
+  double time;
+
+  while (true)
+    {
+      bool running = producing;
+      __sync_synchronize();
+
+      while (ring->pop(time, values, tag))
+        {
+          ordered &= (tag == received) && (time == received)
+              && (values[0].U64 == received) && (values[1].Float == tag / 2.0f);
+          received++;
+        }
+      if (!running)
+        break;
+      sched_yield();
+    }
+
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  sensor_t values[2];
+  unsigned int tag;
+  double time;
+  pthread_t thread;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: SampleRing" << std::endl;
+
+  /* A full ring drops the records */
+  SampleRing ring(2, 5);
+  ok = (ring.getCapacity() == 8) && (ring.size() == 0);
+  for (unsigned int i = 0; i < 9; i++)
+    {
+      values[0].U64 = i;
+      values[1].Float = i / 2.0f;
+      ok &= (ring.push(i, values, i) == (i < 8));
+    }
+  ok &= (ring.size() == 8) && (ring.getDropped() == 1)
+      && (ring.getPushed() == 8) && (ring.getHighWater() == 8);
+  for (unsigned int i = 0; i < 8; i++)
+    ok &= ring.pop(time, values, tag) && (tag == i) && (values[0].U64 == i);
+  ok &= !ring.pop(time, values, tag) && (ring.size() == 0);
+  std::cout << "Full ring: " << ring.getDropped() << " dropped  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* The producer waits for the consumer: nothing lost */
+  SampleRing ring2(2, 256);
+  producing = true;
+  received = 0;
+  ordered = true;
+  pthread_create(&thread, NULL, consume, &ring2);
+  for (unsigned int i = 0; i < RECORDS; i++)
+    {
+      values[0].U64 = i;
+      values[1].Float = i / 2.0f;
+      ring2.push(i, values, i, 1000000000ull);
+    }
+  producing = false;
+  pthread_join(thread, NULL);
+
+  ok = ordered && (received == RECORDS) && (ring2.getDropped() == 0)
+      && (ring2.getPushed() == RECORDS);
+  std::cout << "Records handed over: " << received << ", waits "
+      << ring2.getWaits() << "  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
@@ -0,0 +1,91 @@
+/*
+ * SamplingClock_test.cpp
+ *
+ * Checks that the ticks of the sampling clock stay on their absolute
+ * deadlines whatever the work done between them, and that the deadlines
+ * passed by a late tick are counted as missed.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
+
+using namespace cea;
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  const u64 period = 20000000ull; // 20 ms
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: SamplingClock" << std::endl;
+
+  /* Deadlines on the grid, whatever the work between the ticks */
+  SamplingClock clock(period);
+  u64 start = SamplingClock::now() + period;
+  clock.startAt(start);
+
+  u64 late = 0;
+  ok = true;
+  for (int i = 0; i < 25; i++)
+    {
+      u64 deadline = clock.wait();
+      u64 t = SamplingClock::now() - deadline;
+      if (t > late)
+        late = t;
+      ok &= (deadline == start + i * period);
+
+      // work for 0 to 15 ms
+      usleep(rand() % 15000);
+    }
+  ok &= (clock.getMissed() == 0) && (clock.getTicks() == 25);
+  ok &= (clock.getDeadline() == start + 25 * period);
+  std::cout << "No drift, worst wake-up: " << late / 1000 << " us  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* A tick 75 ms long misses two deadlines */
+  u64 deadline = clock.wait();
+  usleep(75000);
+  u64 next = clock.wait();
+  ok = (clock.getMissed() == 2) && (next == deadline + period);
+  ok &= (clock.getDeadline() == deadline + 4 * period);
+  std::cout << "Missed deadlines: " << clock.getMissed() << "  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Non blocking use */
+  SamplingClock poll(period);
+  int updates = 0;
+  u64 end = SamplingClock::now() + 10 * period + period / 2;
+  while (SamplingClock::now() < end)
+    {
+      if (poll.advance())
+        updates++;
+      usleep(1000);
+    }
+  ok = (updates == 11) && (poll.getMissed() == 0) && !poll.isDue();
+  std::cout << "Updates in 10.5 periods: " << updates << "  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Going from 1 s to one period does not wait for the 1 s deadline */
+  SamplingClock slow(1000000000ull);
+  slow.start();
+  slow.setPeriod(period);
+  u64 begin = SamplingClock::now();
+  slow.wait();
+  ok = (SamplingClock::now() - begin < 2 * period);
+  std::cout << "Shorter period: " << (SamplingClock::now() - begin) / 1000
+      << " us  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
@@ -3,66 +3,113 @@
  *
  *  Created on: Oct 23, 2012
  *      Author: Leandro
+ *
+ * Reads a fake cpufreq tree: the current frequency through the descriptor
+ * kept open, then the time spent at each frequency of time_in_state and its
+ * mean over an interval. The real CPU 0 is read when available, from
+ * /proc/cpuinfo without cpufreq.
  */
 
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
 #include <libec/tools/DebugLog.h> // if the debug log comes after the sensors.h we have compilations issues. need to check why.
 #include <libec/sensors.h>
 
+#define ROOT "/tmp/cpufreq_test"
+
+/* Rewrites a file of the fake tree in place */
+void
+write(const char* file, const char* content)
+{
+  std::ofstream ofs((std::string(ROOT "/cpu0/cpufreq/") + file).c_str());
+  ofs << content;
+}
+
 int
 main()
 {
-  cea::CpuFreq* sensor;
-  std::string cpuinfo_str;
-  std::stringstream ss;
-  unsigned long long value;
-  unsigned long long expected;
+  bool passed = true, ok;
 
   cea::DebugLog::create();
   cea::DebugLog::clear();
 
   std::cout << "Sensor test: CPU Frequency" << std::endl;
 
-  unsigned short cpuid = 0;
+  system("mkdir -p " ROOT "/cpu0/cpufreq/stats");
+  write("scaling_cur_freq", "1200000\n");
+  write("stats/time_in_state", "2400000 100\n1800000 50\n1200000 1000\n");
+  cea::CpuFreq::setPath(ROOT);
 
-  sensor = new cea::CpuFreq(cpuid);
+  /* Current frequency, the file rewritten under the open descriptor */
+  cea::CpuFreq current(0);
+  current.update();
+  ok = current.getStatus() && (current.getValue().U64 == 1200000);
+  write("scaling_cur_freq", "2400000\n");
+  current.update();
+  ok &= (current.getValue().U64 == 2400000);
 
-  if (sensor->getStatus())
-    {
-      while (1)
-        {
-          ss.clear();
-          ss.str("");
-
-          //update sensor and get reference value
-          sensor->update();
-          ss << "awk '/cpu MHz/ { ++x; if ( x == " << (cpuid + 1)
-              << " ) print $4 }' /proc/cpuinfo";
+  cea::CpuFreq copy(current);
+  write("scaling_cur_freq", "1800000\n");
+  copy.update();
+  ok &= (copy.getValue().U64 == 1800000);
+  std::cout << "Current frequency: " << copy.getValue().U64 << " KHz  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
 
-          cpuinfo_str = cea::Tools::exec(ss.str().c_str());
-          ss.clear();
-          ss.str("");
-          //convert string into a double
-          ss << cpuinfo_str;
-          double tmp;
-          ss >> tmp;
+  /* Histogram: 30 ticks at 2.4 GHz and 10 at 1.2 GHz in the interval */
+  long hz = sysconf(_SC_CLK_TCK);
+  cea::CpuFreq histogram(0, -1, cea::CpuFreq::TIME_IN_STATE);
+  write("stats/time_in_state", "2400000 130\n1800000 50\n1200000 1010\n");
+  histogram.update();
+  const std::vector<cea::u64> &freqs = histogram.getFrequencies();
+  const std::vector<cea::u64> &residency = histogram.getResidency();
+  ok = histogram.getStatus() && (freqs.size() == 3) && (freqs[1] == 1800000);
+  ok &= (residency.size() == 3)
+      && (residency[0] == 30 * 1000 / (cea::u64) hz) && (residency[1] == 0)
+      && (residency[2] == 10 * 1000 / (cea::u64) hz);
+  ok &= (histogram.getValue().U64 == (30 * 2400000 + 10 * 1200000) / 40);
+  std::cout << "Time in state: mean " << histogram.getValue().U64 << " KHz  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
 
-          expected = tmp * 1000;
+  /* No time elapsed keeps the last mean */
+  histogram.update();
+  ok = (residency[0] == 0) && (histogram.getValue().U64 == 2100000);
+  std::cout << "Empty interval  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
 
-          value = sensor->getValue().U64;
+  system("rm -rf " ROOT);
 
-          if (value == expected)
-            std::cout << "Test PASSED" << std::endl;
-          else
-            {
-              std::cout << "Test FAILED!!" << std::endl;
-              std::cout << "Expected value: " << expected << std::endl;
-              std::cout << "Returned value: " << value << std::endl;
-            }
-        }
+  /* The real CPU 0, if the kernel exposes cpufreq */
+  cea::CpuFreq::setPath("/sys/devices/system/cpu/");
+  cea::CpuFreq real(0);
+  if (real.getStatus())
+    {
+      real.update();
+      std::cout << "CPU 0: " << real.getValue().U64 << " KHz" << std::endl;
     }
 
-  delete sensor;
+  /* Without cpufreq, the "cpu MHz" line of the CPU in /proc/cpuinfo */
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  double mhz = 0;
+  while ((mhz == 0) && std::getline(cpuinfo, line))
+    if (line.compare(0, 7, "cpu MHz") == 0)
+      mhz = atof(line.substr(line.find(':') + 1).c_str());
+  if (mhz > 0)
+    {
+      cea::CpuFreq::setPath(ROOT);
+      cea::CpuFreq fallback(0);
+      fallback.update();
+      ok = fallback.getStatus() && (fallback.getValue().U64 > 0);
+      std::cout << "CPU 0 from /proc/cpuinfo: " << fallback.getValue().U64
+          << " KHz (" << mhz << " MHz)  " << (ok ? "PASSED" : "FAILED")
+          << std::endl;
+      passed &= ok;
+    }
 
-  return 0;
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
 }
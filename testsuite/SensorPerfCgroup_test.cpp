@@ -0,0 +1,143 @@
+/*
+ * SensorPerfCgroup_test.cpp
+ *
+ * Counts the task clock of a set of child processes per cgroup: all the
+ * processes of a cgroup share the same counters (one per CPU), whatever their
+ * number, and get the cgroup total. Then moves a process into a child
+ * cgroup, when it can be created, and checks that the machine value does not
+ * count the child twice.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPerfCgroup.h>
+
+using namespace cea;
+
+/* Some work for the counters to change */
+static double
+burn()
+{
+  double x = 0.5;
+  for (int i = 1; i < 5000000; i++)
+    x += 1.0 / i;
+  return x;
+}
+
+int
+main(int argc, char *argv[])
+{
+  const int children = 50;
+  bool passed = true;
+  double load = 0;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: PerfCgroup" << std::endl;
+
+  std::string path;
+  if (PerfCgroup::getCgroupRoot().empty()
+      || !PerfCgroup::getPidCgroup(getpid(), path))
+    {
+      std::cout << "cgroup v2 not available" << std::endl;
+      return 0;
+    }
+  std::cout << "cgroup v2 root: " << PerfCgroup::getCgroupRoot() << std::endl;
+  std::cout << "cgroup:         " << path << std::endl;
+
+  /* Children stay in the cgroup of the test */
+  std::vector<pid_t> pids;
+  pids.push_back(getpid());
+  for (int i = 0; i < children; i++)
+    {
+      pid_t pid = fork();
+      if (pid == 0)
+        {
+          pause();
+          _exit(0);
+        }
+      pids.push_back(pid);
+    }
+
+  PerfCgroup clk(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+  for (int tick = 0; tick < 2; tick++)
+    {
+      load += burn();
+      for (unsigned int i = 0; i < pids.size(); i++)
+        clk.updatePid(pids[i]);
+    }
+
+  u64 total = clk.getValuePid(getpid()).U64;
+  bool ok = (total > 0);
+  for (unsigned int i = 0; i < pids.size(); i++)
+    ok &= (clk.getValuePid(pids[i]).U64 == total);
+  ok &= (clk.getCgroupCount() == 1);
+
+  std::cout << "cgroup task clock (ns): " << total << std::endl;
+  std::cout << "processes: " << pids.size() << ", cgroups: "
+      << clk.getCgroupCount() << ", fds: " << clk.getFdCount()
+      << " (PerfCount: " << pids.size() << ")" << std::endl;
+
+  /* The counters are closed with the last process of the cgroup */
+  for (unsigned int i = 1; i < pids.size(); i++)
+    {
+      kill(pids[i], SIGKILL);
+      waitpid(pids[i], NULL, 0);
+      PidStateSlab::release(pids[i]);
+    }
+  ok &= (clk.getCgroupCount() == 1);
+  PidStateSlab::release(getpid());
+  ok &= (clk.getCgroupCount() == 0) && (clk.getFdCount() == 0);
+
+  std::cout << "Cgroup counting:   " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* The cgroup of the test also counts its child: the machine value is the
+   * one of the child alone, which only sleeps */
+  std::string child = PerfCgroup::getCgroupRoot() + path
+      + ((path == "/") ? "" : "/") + "ectools_test";
+  if (mkdir(child.c_str(), 0755) == 0)
+    {
+      pid_t pid = fork();
+      if (pid == 0)
+        {
+          pause();
+          _exit(0);
+        }
+      std::ofstream procs((child + "/cgroup.procs").c_str());
+      procs << pid << std::endl;
+      procs.close();
+
+      PerfCgroup clk2(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+      clk2.add(getpid());
+      clk2.add(pid);
+      load += burn();
+      clk2.update();
+
+      ok = (clk2.getCgroupCount() == 2)
+          && (clk2.getValue().U64 == clk2.getValuePid(pid).U64)
+          && (clk2.getValuePid(getpid()).U64 > clk2.getValue().U64);
+      std::cout << "Nested cgroups: machine " << clk2.getValue().U64
+          << ", parent " << clk2.getValuePid(getpid()).U64 << "  "
+          << (ok ? "PASSED" : "FAILED") << std::endl;
+      passed &= ok;
+
+      kill(pid, SIGKILL);
+      waitpid(pid, NULL, 0);
+      PidStateSlab::release(pid);
+      PidStateSlab::release(getpid());
+      for (int i = 0; (i < 100) && (rmdir(child.c_str()) != 0); i++)
+        usleep(10000);
+    }
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return ((passed && (load > 0)) ? 0 : 1);
+}
@@ -4,10 +4,12 @@
 #include <sys/sysinfo.h>
 #include <dirent.h>
 #include <cmath>
+#include <set>
 
 #include <libec/tools.h>
 #include <libec/sensor/SensorPerfCount.h>
 #include <libec/process.h>
+#include <libec/device/SystemInfo.h>
 
 int
 main()
@@ -76,5 +78,39 @@ main()
   else
     std::cerr << "error: sensor could not be opened." << std::endl;
 
+  /* System wide counting: one counter per CPU, per core and package views */
+  cea::PerfCount clk(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK, -1);
+  if (clk.getStatus())
+    {
+      cea::CpuInfo* cpuInfo = cea::SystemInfo::getCpuInfo();
+      bool passed = true;
+
+      clk.update();
+      usleep(100000);
+      clk.update();
+
+      cea::u64 total = clk.getValue().U64, cpus = 0, pkgs = 0;
+      std::set<int> pkgIds;
+      for (int cpu = 0; cpu < cpuInfo->getCpuCount(); cpu++)
+        {
+          cea::Processor* proc = cpuInfo->getProcessor(cpu);
+          std::cout << "cpu" << cpu << " (pkg " << proc->pkg << ", core "
+              << proc->core << "): " << clk.getValueCpu(cpu) << " ns"
+              << std::endl;
+          cpus += clk.getValueCpu(cpu);
+          // every online CPU runs the cpu-clock
+          passed &= (!proc->is_online || (clk.getValueCpu(cpu) > 0));
+          pkgIds.insert(proc->pkg);
+        }
+      for (std::set<int>::iterator it = pkgIds.begin(); it != pkgIds.end();
+          it++)
+        pkgs += clk.getValuePackage(*it);
+
+      passed &= (total == cpus) && (total == pkgs);
+      std::cout << "System wide per CPU: " << (passed ? "PASSED" : "FAILED")
+          << std::endl;
+      return (passed ? 0 : 1);
+    }
+
   return 0;
 }
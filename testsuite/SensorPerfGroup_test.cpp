@@ -0,0 +1,164 @@
+/*
+ * SensorPerfGroup_test.cpp
+ *
+ * Opens a group of software counters on the current process and on the
+ * machine, checks that each member gets its own value and counts the read()
+ * done per tick against one PerfCount per event. Updates the members through
+ * a SensorUpdater, in a single group. Spreads hardware events over rotating
+ * groups and prints their multiplexing ratio.
+ */
+
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPerfCount.h>
+#include <libec/sensor/SensorPerfGroup.h>
+#include <libec/sensor/SensorUpdater.h>
+
+using namespace cea;
+
+/* Some work for the counters to change */
+static double
+burn()
+{
+  double x = 0.5;
+  for (int i = 1; i < 5000000; i++)
+    x += 1.0 / i;
+  return x;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true;
+  pid_t pid = getpid();
+  double load = 0;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: PerfGroup" << std::endl;
+
+  std::vector<PerfGroup::Event> events;
+  events.push_back(PerfGroup::Event(PERF_TYPE_SOFTWARE,
+      PERF_COUNT_SW_TASK_CLOCK));
+  events.push_back(PerfGroup::Event(PERF_TYPE_SOFTWARE,
+      PERF_COUNT_SW_CONTEXT_SWITCHES));
+  events.push_back(PerfGroup::Event(PERF_TYPE_SOFTWARE,
+      PERF_COUNT_SW_PAGE_FAULTS));
+
+  std::vector<PerfGroup*> group;
+  group.push_back(new PerfGroup(events));
+  for (unsigned int m = 1; m < group[0]->getMemberCount(); m++)
+    group.push_back(new PerfGroup(*group[0], m));
+
+  for (unsigned int m = 0; m < group.size(); m++)
+    std::cout << "  " << group[m]->getName() << " [" << group[m]->getAlias()
+        << "]" << std::endl;
+
+  /* Process level: one read() per tick for the whole group */
+  for (unsigned int m = 0; m < group.size(); m++)
+    group[m]->add(pid);
+
+  u64 reads = group[0]->getReadCount();
+  for (int tick = 0; tick < 3; tick++)
+    {
+      load += burn();
+      usleep(10000);
+      for (unsigned int m = 0; m < group.size(); m++)
+        group[m]->updatePid(pid);
+    }
+  reads = group[0]->getReadCount() - reads;
+
+  u64 taskClock = group[0]->getValuePid(pid).U64;
+  u64 switches = group[1]->getValuePid(pid).U64;
+  std::cout << "task clock (ns):   " << taskClock << std::endl;
+  std::cout << "context switches:  " << switches << std::endl;
+  std::cout << "page faults:       " << group[2]->getValuePid(pid).U64
+      << std::endl;
+  std::cout << "read() per tick:   " << reads / 3.0 << " (PerfCount: "
+      << group.size() << ")" << std::endl;
+
+  bool ok = (taskClock > 0) && (switches > 0) && (reads == 3);
+  std::cout << "Process group:     " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Machine level: needs the rights to count on all the CPUs */
+  if (group[0]->getStatus())
+    {
+      for (unsigned int m = 0; m < group.size(); m++)
+        group[m]->update();
+      load += burn();
+      for (unsigned int m = 0; m < group.size(); m++)
+        group[m]->update();
+      ok = (group[0]->getValue().U64 > 0);
+      std::cout << "Machine group:     " << (ok ? "PASSED" : "FAILED")
+          << "  (task clock " << group[0]->getValue().U64 << " ns)"
+          << std::endl;
+      passed &= ok;
+
+      /* The members share the read of the group: added in one group of the
+       * updater, a tick costs one read() */
+      SensorUpdater updater(4, 100);
+      for (unsigned int m = 0; m < group.size(); m++)
+        updater.addShared(group[m]);
+
+      ok = group[2]->isSameGroup(*group[0]);
+      u64 reads = group[0]->getReadCount();
+      for (int tick = 0; tick < 5; tick++)
+        {
+          load += burn();
+          ok &= (updater.update() == 0);
+        }
+      reads = group[0]->getReadCount() - reads;
+      ok &= (reads == 5) && (updater.getValue(0).U64 > 0);
+      std::cout << "Updater group:     " << (ok ? "PASSED" : "FAILED")
+          << "  (" << reads << " read() in 5 ticks)" << std::endl;
+      passed &= ok;
+    }
+  else
+    std::cout << "Machine group:     not opened (permissions)" << std::endl;
+
+  /* Rotation: more hardware events than counters, values are scaled */
+  std::vector<PerfGroup::Event> hw;
+  for (u64 config = 0; config < PERF_COUNT_HW_MAX; config++)
+    hw.push_back(PerfGroup::Event(PERF_TYPE_HARDWARE, config));
+
+  std::vector<PerfGroup*> rotation;
+  PerfGroup::createRotation(hw, 2, rotation);
+  ok = (rotation.size() == hw.size());
+  for (unsigned int e = 0; e < rotation.size(); e++)
+    {
+      ok &= (rotation[e]->getMemberCount() <= 2);
+      rotation[e]->add(pid);
+    }
+  for (int tick = 0; tick < 2; tick++)
+    {
+      load += burn();
+      for (unsigned int e = 0; e < rotation.size(); e++)
+        rotation[e]->updatePid(pid);
+    }
+  for (unsigned int e = 0; e < rotation.size(); e++)
+    {
+      float ratio = rotation[e]->getMultiplexRatioPid(pid);
+      ok &= (ratio >= 0) && (ratio <= 1.0001f);
+      std::cout << "  " << rotation[e]->getName() << ": "
+          << rotation[e]->getValuePid(pid).U64 << " (running " << ratio * 100
+          << "%)" << std::endl;
+    }
+  for (unsigned int e = 0; e < rotation.size(); e++)
+    delete rotation[e];
+  std::cout << "Rotation:          " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Members can be deleted in any order */
+  delete group[0];
+  group[1]->updatePid(pid);
+  delete group[2];
+  delete group[1];
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return ((passed && (load > 0)) ? 0 : 1);
+}
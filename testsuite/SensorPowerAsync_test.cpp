@@ -0,0 +1,114 @@
+/*
+ * SensorPowerAsync_test.cpp
+ *
+ * Polls a slow fake power meter (100 ms per update) on its own thread and
+ * checks that reading it never blocks, that the samples follow the meter,
+ * that values are interpolated between samples and that waiting callers
+ * wake up when a sample arrives.
+ */
+
+#include <iostream>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPowerAsync.h>
+
+using namespace cea;
+
+/* Power meter taking 100 ms per update, its value is the update number */
+class SlowPowerMeter : public PowerMeter
+{
+public:
+  SlowPowerMeter() :
+      updates(0)
+  {
+    _name = "SLOW_POWER_METER";
+    _alias = "PM_SLOW";
+    _type = Float;
+    _isActive = true;
+  }
+
+  void
+  update()
+  {
+    usleep(100000);
+    updates++;
+  }
+
+  sensor_t
+  getValue()
+  {
+    sensor_t v;
+    v.Float = updates;
+    return v;
+  }
+
+  int updates;
+};
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: AsyncPowerMeter" << std::endl;
+
+  AsyncPowerMeter* pm = new AsyncPowerMeter(new SlowPowerMeter(), 10);
+
+  /* Reading never waits for the meter */
+  u64 start = AsyncPowerMeter::now(), worst = 0;
+  for (int i = 0; i < 50; i++)
+    {
+      u64 t = AsyncPowerMeter::now();
+      pm->update();
+      pm->getValue();
+      t = AsyncPowerMeter::now() - t;
+      if (t > worst)
+        worst = t;
+      usleep(10000);
+    }
+  u64 elapsed = AsyncPowerMeter::now() - start;
+
+  ok = (worst < 1000000) && (pm->getSampleCount() >= 2);
+  ok &= (pm->getValue().Float > 0);
+  std::cout << "update() worst time: " << worst / 1000.0 << " us, samples: "
+      << pm->getSampleCount() << " in " << elapsed / 1000000 << " ms  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Interpolation between the two latest samples */
+  AsyncPowerMeter::Sample last, prev;
+  ok = pm->getSample(0, last) && pm->getSample(1, prev);
+  ok &= (last.value == prev.value + 1) && (last.time > prev.time);
+  float mid = pm->getValueAt(prev.time + (last.time - prev.time) / 2);
+  ok &= (mid > prev.value) && (mid < last.value);
+  ok &= (pm->getValueAt(last.time + 1000000000ull) == last.value);
+  std::cout << "Interpolation: " << prev.value << " < " << mid << " < "
+      << last.value << "  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* Waiting callers wake up as soon as a sample is published */
+  u64 late = 0;
+  for (int i = 0; i < 5; i++)
+    {
+      pm->waitUpdate();
+      u64 t = AsyncPowerMeter::now() - pm->getSampleTime();
+      if (t > late)
+        late = t;
+    }
+  unsigned latency = pm->getLatency();
+  ok = pm->getSample(0, last) && (pm->getValue().Float >= last.value - 1);
+  ok &= (late < 5000000) && (latency >= 90) && (latency < 200);
+  std::cout << "waitUpdate() worst wake-up: " << late / 1000.0
+      << " us, latency: " << latency << " ms  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  delete pm;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
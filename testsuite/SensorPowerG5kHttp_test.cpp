@@ -0,0 +1,133 @@
+/*
+ * SensorPowerG5kHttp_test.cpp
+ *
+ * Runs the G5K power meters against a local stand-in of the metrology API:
+ * several meters share one keep-alive connection and one request per tick.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPowerG5k.h>
+
+using namespace cea;
+
+static int listenFd;
+static volatile int connections = 0, requests = 0;
+
+/* Answers the requests of a connection until it is closed */
+static void
+serve(int fd)
+{
+  std::string in;
+  char buf[1024];
+  ssize_t n;
+
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+    {
+      in.append(buf, n);
+
+      size_t end;
+      while ((end = in.find("\r\n\r\n")) != std::string::npos)
+        {
+          in.erase(0, end + 4);
+          requests++;
+
+          std::stringstream body;
+          body << "{\"probes\": {";
+          for (int node = 1; node <= 3; node++)
+            body << (node > 1 ? ", " : "") << "\"reims.stremi-" << node
+                << "\": {\"timestamp\": 1378200000, \"w\": "
+                << 100 * node + requests << ".5, \"kwh\": 1.0}";
+          body << "}}";
+
+          std::stringstream out;
+          out << "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+              << "Content-Length: " << body.str().size() << "\r\n\r\n"
+              << body.str();
+          send(fd, out.str().data(), out.str().size(), MSG_NOSIGNAL);
+        }
+    }
+  close(fd);
+}
+
+static void*
+server(void*)
+{
+  int fd;
+
+  while ((fd = accept(listenFd, NULL, NULL)) >= 0)
+    {
+      connections++;
+      serve(fd);
+    }
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  pthread_t thread;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: G5kPowerMeter (HTTP)" << std::endl;
+
+  /* Stand-in of the metrology API on a free local port */
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  bind(listenFd, (struct sockaddr*) &addr, sizeof(addr));
+  listen(listenFd, 4);
+  getsockname(listenFd, (struct sockaddr*) &addr, &len);
+  pthread_create(&thread, NULL, server, NULL);
+
+  G5kPowerMeter::setApi("127.0.0.1", ntohs(addr.sin_port));
+
+  G5kPowerMeter pm1("stremi-1", "reims");
+  G5kPowerMeter pm2("stremi-2", "reims");
+  G5kPowerMeter pm4("stremi-4", "reims");
+
+  ok = pm1.getStatus() && pm2.getStatus() && !pm4.getStatus();
+  std::cout << "Activity:    " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  unsigned int reqs = G5kPowerMeter::getRequestCount();
+  for (int tick = 0; tick < 5; tick++)
+    {
+      pm1.update();
+      pm2.update();
+    }
+  reqs = G5kPowerMeter::getRequestCount() - reqs;
+
+  float p1 = pm1.getValue().Float, p2 = pm2.getValue().Float;
+  ok = (reqs == 5) && (G5kPowerMeter::getConnectCount() == 1)
+      && (connections == 1);
+  // both read the same answer (.5 W and 100 W apart)
+  ok &= (p2 - p1 == 100.0f) && (p1 - (int) (p1) == 0.5f);
+  std::cout << "stremi-1: " << p1 << " W, stremi-2: " << p2 << " W"
+      << std::endl;
+  std::cout << "requests for 5 ticks: " << reqs << ", connections: "
+      << connections << std::endl;
+  std::cout << "Keep-alive:  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  shutdown(listenFd, SHUT_RDWR);
+  close(listenFd);
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
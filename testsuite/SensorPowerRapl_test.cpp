@@ -0,0 +1,146 @@
+/*
+ * SensorPowerRapl_test.cpp
+ *
+ * Runs the RAPL power meter on a fake powercap tree (two packages with a
+ * core subzone, a dram domain and a counter wrapping around), on one whose
+ * range is unknown, then on the real one when present.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPowerRapl.h>
+
+using namespace cea;
+
+static void
+writeFile(const std::string &path, const std::string &value)
+{
+  std::ofstream ofs(path.c_str());
+  ofs << value << std::endl;
+}
+
+static void
+makeZone(const std::string &root, const std::string &zone,
+    const std::string &name, const std::string &energy)
+{
+  std::string dir = root + "/" + zone;
+  mkdir(dir.c_str(), 0755);
+  writeFile(dir + "/name", name);
+  writeFile(dir + "/energy_uj", energy);
+  writeFile(dir + "/max_energy_range_uj", "1000000000");
+}
+
+static bool
+near(double a, double b)
+{
+  return fabs(a - b) < 1e-3;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: RaplPowerMeter" << std::endl;
+
+  char tmpl[] = "/tmp/powercapXXXXXX";
+  std::string root = mkdtemp(tmpl);
+
+  mkdir((root + "/intel-rapl").c_str(), 0755);
+  makeZone(root, "intel-rapl:0", "package-0", "1000000");
+  makeZone(root, "intel-rapl:0:0", "core", "500000");
+  makeZone(root, "intel-rapl:0:1", "dram", "200000");
+  makeZone(root, "intel-rapl:1", "package-1", "999000000");
+
+  RaplPowerMeter pm(root);
+  ok = pm.getStatus() && (pm.getDomainCount() == 4);
+  ok &= (pm.getDomainType(0) == RaplPowerMeter::Package);
+  ok &= (pm.getDomainType(1) == RaplPowerMeter::Core);
+  ok &= (pm.getDomainType(2) == RaplPowerMeter::Dram);
+  ok &= (pm.getDomainPackage(3) == 1);
+  std::cout << "Discovery:    " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* The files are kept open: rewriting them in place changes the values */
+  pm.update();
+  writeFile(root + "/intel-rapl:0/energy_uj", "3000000");
+  writeFile(root + "/intel-rapl:0:0/energy_uj", "1500000");
+  writeFile(root + "/intel-rapl:0:1/energy_uj", "700000");
+  // package-1 wraps around: 1 J before the end, 2 J after
+  writeFile(root + "/intel-rapl:1/energy_uj", "2000000");
+  usleep(100000);
+  pm.update();
+
+  ok = near(pm.getDomainEnergy(0), 2.0) && near(pm.getDomainEnergy(1), 1.0);
+  ok &= near(pm.getDomainEnergy(2), 0.5) && near(pm.getDomainEnergy(3), 3.0);
+  // core is part of package-0, not counted twice
+  ok &= near(pm.getEnergy(), 5.5);
+  ok &= (pm.getValue().Float > 0);
+  std::cout << "Energy:       " << pm.getEnergy() << " J, "
+      << pm.getValue().Float << " W  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  std::string cmd = "rm -rf " + root;
+  if (system(cmd.c_str()) != 0)
+    std::cerr << "could not remove " << root << std::endl;
+
+  /* A wrap without max_energy_range_uj gives no value for the interval */
+  char tmpl2[] = "/tmp/powercapXXXXXX";
+  root = mkdtemp(tmpl2);
+  mkdir((root + "/intel-rapl").c_str(), 0755);
+  mkdir((root + "/intel-rapl:0").c_str(), 0755);
+  writeFile(root + "/intel-rapl:0/name", "package-0");
+  writeFile(root + "/intel-rapl:0/energy_uj", "5000000");
+
+  RaplPowerMeter unknown(root);
+  unknown.update();
+  writeFile(root + "/intel-rapl:0/energy_uj", "6000000");
+  usleep(100000);
+  unknown.update();
+  float last = unknown.getValue().Float;
+  writeFile(root + "/intel-rapl:0/energy_uj", "1000000");
+  usleep(100000);
+  unknown.update();
+  ok = near(unknown.getEnergy(), 1.0) && (last > 0)
+      && (unknown.getValue().Float == last);
+  writeFile(root + "/intel-rapl:0/energy_uj", "2000000");
+  usleep(100000);
+  unknown.update();
+  ok &= near(unknown.getEnergy(), 2.0);
+  std::cout << "Unknown range: " << unknown.getEnergy() << " J  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  cmd = "rm -rf " + root;
+  if (system(cmd.c_str()) != 0)
+    std::cerr << "could not remove " << root << std::endl;
+
+  /* Real counters */
+  RaplPowerMeter real;
+  if (real.getStatus())
+    {
+      real.update();
+      sleep(1);
+      real.update();
+      for (unsigned int d = 0; d < real.getDomainCount(); d++)
+        std::cout << "  " << real.getDomainName(d) << ": "
+            << real.getDomainPower(d) << " W" << std::endl;
+      std::cout << "  total: " << real.getValue().Float << " W" << std::endl;
+    }
+  else
+    std::cout << "No RAPL domain readable on this machine" << std::endl;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
@@ -0,0 +1,150 @@
+/*
+ * SensorPowerRecsSession_test.cpp
+ *
+ * Runs the RECS power meters against a mock microcontroller: the meters of
+ * all the nodes share one persistent connection and one request per tick.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/sensor/SensorPowerRecs.h>
+
+using namespace cea;
+
+static int listenFd;
+static volatile int connections = 0, requests = 0;
+static volatile bool down = false;
+
+/* Answers the requests of a connection until it is closed, the answer is
+ * sent in two parts to check that the meter reads until its end */
+static void
+serve(int fd)
+{
+  std::string in;
+  char buf[256];
+  ssize_t n;
+
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+    {
+      // a controller going down closes the connection without answering
+      if (down)
+        break;
+      in.append(buf, n);
+
+      size_t end;
+      while ((end = in.find("4x")) != std::string::npos)
+        {
+          in.erase(0, end + 2);
+          requests++;
+
+          // 3 slots: two nodes on, an empty slot
+          std::stringstream head, tail;
+          head << "3;1;1;45;" << 60 + requests << ";1;1;40;";
+          tail << 50 + requests << ";0;0;0;0;3290xxxx";
+
+          send(fd, head.str().data(), head.str().size(), MSG_NOSIGNAL);
+          usleep(1000);
+          send(fd, tail.str().data(), tail.str().size(), MSG_NOSIGNAL);
+        }
+    }
+  close(fd);
+}
+
+/* Like the microcontroller, accepts one connection at a time */
+static void*
+server(void*)
+{
+  int fd;
+
+  while ((fd = accept(listenFd, NULL, NULL)) >= 0)
+    {
+      connections++;
+      serve(fd);
+    }
+  return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  pthread_t thread;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: RecsPowerMeter (shared session)" << std::endl;
+
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  bind(listenFd, (struct sockaddr*) &addr, sizeof(addr));
+  listen(listenFd, 4);
+  getsockname(listenFd, (struct sockaddr*) &addr, &len);
+  pthread_create(&thread, NULL, server, NULL);
+
+  int port = ntohs(addr.sin_port);
+  RecsPowerMeter* pm[3];
+  for (int i = 0; i < 3; i++)
+    pm[i] = new RecsPowerMeter("127.0.0.1", port, i);
+
+  ok = pm[0]->getStatus() && (RecsSession::getSessionCount() == 1);
+  std::cout << "Activity:    " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  int reqs = requests;
+  for (int tick = 0; tick < 5; tick++)
+    for (int i = 0; i < 3; i++)
+      pm[i]->update();
+  reqs = requests - reqs;
+
+  float p0 = pm[0]->getValue().Float, p1 = pm[1]->getValue().Float;
+  float p2 = pm[2]->getValue().Float;
+  ok = (reqs == 5) && (connections == 1);
+  // all the nodes read the same answer
+  ok &= (p0 - p1 == 10.0f) && (p2 == 0.0f) && (pm[1]->getValue(1, 1) == 40);
+  std::cout << "node 0: " << p0 << " W, node 1: " << p1 << " W, node 2: "
+      << p2 << " W" << std::endl;
+  std::cout << "requests for 5 ticks: " << reqs << ", connections: "
+      << connections << std::endl;
+  std::cout << "Persistent:  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  // no stale power is read while the controller does not answer
+  down = true;
+  for (int i = 0; i < 3; i++)
+    pm[i]->update();
+  ok = (pm[0]->getValue().Float == -1.0f) && (pm[1]->getValue().Float == -1.0f)
+      && (pm[1]->getValue(0, 0) == -1);
+  down = false;
+  for (int i = 0; i < 3; i++)
+    pm[i]->update();
+  ok &= (pm[0]->getValue().Float > 0.0f) && (connections == 2);
+  std::cout << "Failure:     " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  for (int i = 0; i < 3; i++)
+    delete pm[i];
+
+  ok = (RecsSession::getSessionCount() == 0);
+  std::cout << "Release:     " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  shutdown(listenFd, SHUT_RDWR);
+  close(listenFd);
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
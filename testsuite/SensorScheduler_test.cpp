@@ -0,0 +1,118 @@
+/*
+ * SensorScheduler_test.cpp
+ *
+ * Schedules sensors with different periods and checks that each one is
+ * updated at its own rate, that the merged samples are in time order and
+ * that a slow sensor does not delay the others. Then loads the parameters of
+ * a sensor from XML tags with and without <period>.
+ */
+
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/sensor/SensorScheduler.h>
+
+using namespace cea;
+
+/* Counts its updates, each one taking a given time */
+class CountingSensor : public Sensor
+{
+public:
+  CountingSensor(unsigned int period, unsigned int cost = 0) :
+      cost(cost)
+  {
+    _name = _alias = "COUNTER";
+    _type = U64;
+    _isActive = true;
+    _cValue.U64 = 0;
+    setPeriod(period);
+  }
+
+  void
+  update()
+  {
+    if (cost > 0)
+      usleep(cost);
+    _cValue.U64++;
+  }
+
+  unsigned int cost;
+};
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+  std::vector<SensorScheduler::Sample> samples;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: SensorScheduler" << std::endl;
+
+  CountingSensor fast(10), medium(50), slow(0);
+  SensorScheduler sched(200);
+  sched.add(&fast);
+  sched.add(&medium);
+  sched.add(&slow);
+
+  ok = sched.isMultiRate() && (sched.getPeriod(2) == 200);
+
+  /* One second: 101, 21 and 6 updates (the first ones at the start) */
+  u64 start = SamplingClock::now();
+  sched.startAt(start);
+  while (sched.getDeadline() <= start + 1000000000ull)
+    sched.run(samples);
+
+  // a late wake-up on a loaded machine skips deadlines, one update each
+  u64 updates = fast.getValue().U64 + medium.getValue().U64
+      + slow.getValue().U64;
+  ok &= (fast.getValue().U64 <= 101) && (medium.getValue().U64 <= 21)
+      && (slow.getValue().U64 <= 6);
+  ok &= (samples.size() == updates)
+      && (updates + sched.getMissed() >= 128);
+  for (unsigned int i = 1; i < samples.size(); i++)
+    ok &= (samples[i].time >= samples[i - 1].time);
+  std::cout << "Updates in 1 s: " << fast.getValue().U64 << ", "
+      << medium.getValue().U64 << ", " << slow.getValue().U64 << " ("
+      << sched.getMissed() << " missed)  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* A sensor taking 25 ms every 10 ms misses deadlines */
+  CountingSensor late(10, 25000), other(100);
+  SensorScheduler sched2;
+  sched2.add(&late);
+  sched2.add(&other);
+  start = SamplingClock::now();
+  sched2.startAt(start);
+  samples.clear();
+  while (sched2.getDeadline() <= start + 500000000ull)
+    sched2.run(samples);
+
+  ok = (sched2.getMissed() > 0) && (other.getValue().U64 == 6);
+  std::cout << "Missed deadlines: " << sched2.getMissed() << ", other: "
+      << other.getValue().U64 << "  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* <period> is optional: a tag without it keeps the period of the caller */
+  CountingSensor loaded(0);
+  loaded.setParamsXml("<sensor class=\"Sensor\" name=\"COUNTER\" "
+      "alias=\"Cnt\">\n  <params>\n    <latency value=\"0\"/>\n"
+      "  </params>\n</sensor>");
+  ok = (loaded.getPeriod() == 0) && (loaded.getAlias() == "Cnt");
+  loaded.setParamsXml("<sensor class=\"Sensor\" name=\"COUNTER\" "
+      "alias=\"Cnt\">\n  <params>\n    <latency value=\"0\"/>\n"
+      "    <period value=\"250\"/>\n  </params>\n</sensor>");
+  ok &= (loaded.getPeriod() == 250);
+  std::cout << "Period from XML: " << loaded.getPeriod() << "  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}
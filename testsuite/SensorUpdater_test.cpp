@@ -0,0 +1,135 @@
+/*
+ * SensorUpdater_test.cpp
+ *
+ * Updates slow sensors concurrently and checks that the tick ends within
+ * the budget, that a hung sensor is marked stale without being updated
+ * twice, that the sensors of a group are never updated at once and that a
+ * long group does not hold the tick beyond the budget of a sensor.
+ */
+
+#include <iostream>
+#include <unistd.h>
+
+#include <libec/tools/DebugLog.h>
+#include <libec/tools/SamplingClock.h>
+#include <libec/sensor/SensorUpdater.h>
+
+using namespace cea;
+
+/* Sensors of a group checking none of them is updated at the same time */
+static int inside = 0;
+static bool overlap = false;
+
+/* Counts its updates, each one taking a given time */
+class SlowSensor : public Sensor
+{
+public:
+  SlowSensor(unsigned int cost = 20000) :
+      cost(cost)
+  {
+    _name = _alias = "SLOW";
+    _type = U64;
+    _isActive = true;
+    _cValue.U64 = 0;
+  }
+
+  void
+  update()
+  {
+    if (__sync_add_and_fetch(&inside, 1) > 1)
+      overlap = true;
+    usleep(cost);
+    __sync_sub_and_fetch(&inside, 1);
+    _cValue.U64++;
+  }
+
+  unsigned int cost;
+};
+
+int
+main(int argc, char *argv[])
+{
+  bool passed = true, ok;
+
+  DebugLog::create();
+  DebugLog::clear();
+
+  std::cout << "Testing class: SensorUpdater" << std::endl;
+
+  /* Three sensors of 40 ms updated in less than the 120 ms of a serial
+   * update */
+  SlowSensor a(40000), b(40000), c(40000);
+  SensorUpdater updater(3, 100);
+  updater.add(&a);
+  updater.add(&b);
+  updater.add(&c);
+
+  u64 time = SamplingClock::now();
+  unsigned int stale = updater.update();
+  time = SamplingClock::now() - time;
+  ok = (stale == 0) && (time < 100000000ull) && (updater.getThreads() == 3);
+  for (unsigned int i = 0; i < updater.size(); i++)
+    ok &= (updater.getValue(i).U64 == 1) && !updater.isStale(i);
+  std::cout << "Tick of 3 x 40 ms: " << time / 1000000 << " ms  "
+      << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  /* A sensor of 300 ms over a budget of 50 ms */
+  SlowSensor hung(300000), fast(0);
+  SensorUpdater updater2(2, 50);
+  updater2.add(&hung);
+  updater2.add(&fast);
+
+  time = SamplingClock::now();
+  ok = (updater2.update() == 1);
+  time = SamplingClock::now() - time;
+  ok &= (time < 100000000ull) && updater2.isStale(0) && !updater2.isStale(1);
+  ok &= (updater2.getValue(0).U64 == 0) && (updater2.getValue(1).U64 == 1);
+
+  // still running: not updated again
+  ok &= (updater2.update() == 1) && (updater2.getValue(1).U64 == 2);
+  ok &= (updater2.getStaleTicks(0) == 2);
+
+  usleep(300000);
+  ok &= (updater2.getValue(0).U64 == 1) && (updater2.getOverruns(0) == 1);
+  ok &= (updater2.getLatency(0) >= 300000000ull);
+  std::cout << "Hung sensor: " << time / 1000000 << " ms, stale "
+      << updater2.getStaleTicks(0) << " ticks  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* The sensors of a group are updated in turn */
+  SlowSensor g1(10000), g2(10000), g3(10000);
+  SensorUpdater updater3(3, 100);
+  updater3.add(&g1, 0, 1);
+  updater3.add(&g2, 0, 1);
+  updater3.add(&g3, 0, 1);
+
+  overlap = false;
+  ok = true;
+  for (int i = 0; i < 5; i++)
+    ok &= (updater3.update() == 0);
+  ok &= !overlap && (updater3.getThreads() == 1);
+  ok &= (g1.getValue().U64 == 5) && (g3.getValue().U64 == 5);
+  std::cout << "Group updated in turn  " << (ok ? "PASSED" : "FAILED")
+      << std::endl;
+  passed &= ok;
+
+  /* A group of 10 x 20 ms with budgets of 30 ms: the tick waits 30 ms, not
+   * 300 ms, and the sensors not reached are stale */
+  SlowSensor chain[10];
+  SensorUpdater updater4(2, 30);
+  for (int i = 0; i < 10; i++)
+    updater4.add(&chain[i], 0, 2);
+
+  time = SamplingClock::now();
+  stale = updater4.update();
+  time = SamplingClock::now() - time;
+  ok = (time < 100000000ull) && (stale >= 8) && updater4.isStale(9);
+  std::cout << "Long group: " << time / 1000000 << " ms, " << stale
+      << " stale  " << (ok ? "PASSED" : "FAILED") << std::endl;
+  passed &= ok;
+
+  std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+  return (passed ? 0 : 1);
+}